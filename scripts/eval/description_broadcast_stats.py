@@ -0,0 +1,56 @@
+import sys
+import re
+from os import walk
+from os.path import join
+
+# Usage: python3 description_broadcast_stats.py <log directory of a run with -v=4>
+# Reports for each job the time from the start of its root node until the subprocess
+# of each job node began to solve, i.e., until the job is solved at its full volume.
+# Timestamps of different ranks are compared directly (see harmonize_timestamps.py).
+
+logdir = sys.argv[1]
+
+root_start = dict() # job ID -> time of starting the root node
+begin_times = dict() # job ID -> node index -> time of beginning to solve
+
+for root, dirs, files in walk(logdir):
+    for f in files:
+        if not f.startswith("log."):
+            continue
+        for line in open(join(root, f), "r"):
+            match = re.search(r'^([0-9]+\.[0-9]+) ([0-9]+) .*#([0-9]+):([0-9]+) : (new job node starting|subprocess begins solving)', line)
+            if not match:
+                continue
+            time = float(match.group(1))
+            jobid = int(match.group(3))
+            index = int(match.group(4))
+            if match.group(5) == "new job node starting":
+                if index == 0 and (jobid not in root_start or time < root_start[jobid]):
+                    root_start[jobid] = time
+            else:
+                if jobid not in begin_times:
+                    begin_times[jobid] = dict()
+                # Only the first begin of each job node counts (no restarts)
+                if index not in begin_times[jobid] or time < begin_times[jobid][index]:
+                    begin_times[jobid][index] = time
+
+if not begin_times:
+    print("No job nodes beginning to solve found (verbosity >= 4 and -appmode=fork required)")
+    sys.exit(0)
+
+full_volume_times = []
+for jobid in sorted(begin_times):
+    if jobid not in root_start:
+        continue
+    latencies = sorted([t - root_start[jobid] for t in begin_times[jobid].values()])
+    full_volume_times.append(latencies[-1])
+    print("job", jobid, "nodes", len(latencies), "first_begin", "%.4f" % latencies[0], 
+        "median_begin", "%.4f" % latencies[len(latencies) // 2], "full_volume", "%.4f" % latencies[-1])
+
+num_jobs = len(full_volume_times)
+if num_jobs > 0:
+    full_volume_times.sort()
+    print("jobs", num_jobs)
+    print("full_volume_mean", "%.4f" % (sum(full_volume_times) / num_jobs))
+    print("full_volume_median", "%.4f" % full_volume_times[num_jobs // 2])
+    print("full_volume_max", "%.4f" % full_volume_times[-1])
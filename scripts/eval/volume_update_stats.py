@@ -0,0 +1,62 @@
+
+import sys
+import json
+import re
+from os import walk
+from os.path import join
+
+# Usage: python3 volume_update_stats.py <log directory of a run with -v=4 -dmm>
+# Reports the volume update messages sent per balancing epoch and, for each
+# balancing epoch, the time from the first to the last job node applying the
+# epoch's volumes (i.e., until all job trees reflect the new volumes).
+# Timestamps of different ranks are compared directly (see harmonize_timestamps.py).
+
+MSG_NOTIFY_VOLUME_UPDATE = 8
+
+logdir = sys.argv[1]
+
+update_times = dict() # epoch -> [time of each applied update]
+num_msgs = 0
+num_bytes = 0
+
+for root, dirs, files in walk(logdir):
+    for f in files:
+        path = join(root, f)
+
+        if f.startswith("log."):
+            for line in open(path, "r"):
+                match = re.search(r'^([0-9]+\.[0-9]+) ([0-9]+) .*#[0-9]+:[0-9]+ : update v=([0-9]+) epoch=([0-9]+)', line)
+                if match:
+                    time = float(match.group(1))
+                    epoch = int(match.group(4))
+                    if epoch not in update_times:
+                        update_times[epoch] = []
+                    update_times[epoch].append(time)
+
+        if f.startswith("msgmetrics"):
+            for line in open(path, "r"):
+                metrics = json.loads(line)
+                for tagmetrics in metrics["tags"]:
+                    if tagmetrics["tag"] != MSG_NOTIFY_VOLUME_UPDATE:
+                        continue
+                    num_msgs += sum(tagmetrics["sent"]["msgs"])
+                    num_bytes += sum(tagmetrics["sent"]["bytes"])
+
+if not update_times:
+    print("No volume updates found (verbosity >= 4 required)")
+    sys.exit(0)
+
+latencies = []
+for epoch in sorted(update_times):
+    times = update_times[epoch]
+    latencies.append(max(times) - min(times))
+    print("epoch", epoch, "updates", len(times), "latency", "%.4f" % (max(times) - min(times)))
+
+num_epochs = len(update_times)
+latencies.sort()
+print("epochs", num_epochs)
+print("msgs_per_epoch", "%.2f" % (num_msgs / num_epochs))
+print("bytes_per_epoch", "%.2f" % (num_bytes / num_epochs))
+print("latency_mean", "%.4f" % (sum(latencies) / num_epochs))
+print("latency_median", "%.4f" % latencies[num_epochs // 2])
+print("latency_max", "%.4f" % latencies[-1])
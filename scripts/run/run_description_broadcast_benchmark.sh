@@ -0,0 +1,31 @@
+#!/bin/bash
+
+set -e
+
+# Measures the time until a single large job is solved at its full volume,
+# once with plain and once with pipelined (chunked) job description transfers.
+# 1st parameter: number of MPI processes to start (e.g., 512)
+# 2nd parameter: CNF file of the instance (e.g., a formula of 100 MB or more)
+# 3rd parameter (optional): chunk size in bytes (default: 1 MB)
+
+if [ -z $2 ]; then
+    echo "Usage: $0 <#processes> <instance> [<chunk size in bytes>]"
+    exit 1
+fi
+
+num_procs=$1
+instance=$2
+chunksize=${3:-1048576}
+
+testcount=1
+source $(dirname "$0")/systest_commons.sh
+mkdir -p runs
+
+for dcs in 0 $chunksize; do
+    cleanup
+    options="-mono=$instance -appmode=fork -t=4 -v=4 -T=120 -dcs=$dcs"
+    runid="descbcast_$(hostname)_$(git rev-parse --short HEAD)_np${num_procs}_dcs${dcs}"
+    echo "Running $runid"
+    RDMAV_FORK_SAFE=1 PATH=build/:$PATH mpirun -np $num_procs --oversubscribe build/mallob -log=runs/$runid $options > runs/$runid.out 2>&1 || true
+    python3 $(dirname "$0")/../eval/description_broadcast_stats.py runs/$runid | tail -4
+done
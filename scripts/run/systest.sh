@@ -55,6 +55,21 @@ function test_dry_scheduling() {
     test 32 -c=1 -J=400 $@
 }
 
+function test_volume_updates() {
+    # Benchmark: many concurrent DUMMY jobs with explicit volume updates; 
+    # reports messages per balancing epoch and update latencies
+    t=1
+    for i in {1..200}; do
+        wclimit=8s arrival=$t application=DUMMY introduce_job dummy-$i no/such/instance.txt
+        t=$(echo "$t+0.05"|bc -l)
+    done
+    echo "200 jobs set up."
+    logdir=_systest_volupd
+    rm -rf $logdir
+    test 32 -c=1 -J=200 -evu -dmm -v=4 -log=$logdir $@
+    python3 scripts/eval/volume_update_stats.py $logdir|tail -6
+}
+
 function test_incremental() {
     for test in entertainment08 roverg10 transportg29 ; do
         for slv in l${glucose}ck L${glucose}Ck; do
@@ -106,7 +121,7 @@ if [ -z "$1" ]; then
 fi
 
 if [ "$1" == "-h" ]; then
-    echo "Valid options: all mono sched incsched osc drysched inc manyinc"
+    echo "Valid options: all mono sched incsched osc drysched volupd inc manyinc"
     exit 0
 fi
 
@@ -138,6 +153,9 @@ while [ ! -z "$1" ]; do
         drysched)
             test_dry_scheduling $progopts
             ;;
+        volupd)
+            test_volume_updates $progopts
+            ;;
         inc)
             test_incremental $progopts
             ;;
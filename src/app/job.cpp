@@ -7,6 +7,7 @@
 #include "util/logger.hpp"
 #include "util/sys/timer.hpp"
 #include "util/permutation.hpp"
+#include "comm/host_comm.hpp"
 
 
 Job::Job(const Parameters& params, int commSize, int worldRank, int jobId, JobDescription::Application appl) :
@@ -23,6 +24,8 @@ Job::Job(const Parameters& params, int commSize, int worldRank, int jobId, JobDe
     _continuous_growth = _params.continuousGrowth();
     _max_demand = _params.maxDemand();
     _threads_per_job = _params.numThreadsPerProcess();
+    if (_params.localityPreservingPlacement()) 
+        _job_tree.setHostRanks(HostComm::getWorldRanksOnHost());
 }
 
 LocalScheduler Job::constructScheduler(std::function<void(const JobRequest& req, int tag, bool left, int dest)> emitJobReq) {
@@ -70,8 +73,38 @@ void Job::uncommit() {
 }
 
 void Job::pushRevision(const std::shared_ptr<std::vector<uint8_t>>& data) {
+    _description.deserialize(data);
+    digestRevision();
+}
+
+void Job::pushRevision(const JobDescription::SerializationView& view) {
+    _description.deserialize(view);
+    digestRevision();
+}
+
+void Job::pushIncompleteRevision(const std::shared_ptr<std::vector<uint8_t>>& data) {
+    _has_incomplete_description = true;
+    pushRevision(data);
+}
 
+void Job::completeRevision(const std::shared_ptr<std::vector<uint8_t>>& data) {
     _description.deserialize(data);
+    digestCompleteDescription();
+}
+
+void Job::completeRevision(const JobDescription::SerializationView& view) {
+    _description.deserialize(view);
+    digestCompleteDescription();
+}
+
+void Job::digestCompleteDescription() {
+    assert(_has_incomplete_description);
+    _has_incomplete_description = false;
+    LOG(V4_VVER, "%s : description complete\n", toStr());
+    appl_completeDescription();
+}
+
+void Job::digestRevision() {
     _priority = _description.getPriority();
     if (_description.getMaxDemand() > 0) {
         // Set max. demand to more restrictive number
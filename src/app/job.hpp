@@ -60,6 +60,7 @@ public:
     Begin, or continue, to process the job.
     At the first call of appl_start(), you can safely assume that the job description
     is already present: getDescription() returns a valid JobDescription instance.
+    (Only its payload may be missing, see appl_canStartWithIncompleteDescription().)
     */
     virtual void appl_start() = 0;
     /*
@@ -123,6 +124,19 @@ public:
     */
     virtual int getDemand() const;
 
+    /*
+    Return true iff the job may be started (appl_start()) as soon as the meta data of its
+    first revision have arrived, i.e., while its payload is still being received. 
+    Until appl_completeDescription() is called, the payload of getDescription() must 
+    not be accessed. By default, the job is started only with a complete description.
+    */
+    virtual bool appl_canStartWithIncompleteDescription() const {return false;}
+    /*
+    The payload of the job's first revision, with which the job was started early, is 
+    complete now. Only from now on, the payload of getDescription() can be accessed.
+    */
+    virtual void appl_completeDescription() {}
+
     /*
     Measure for the age of a job -- decreases with time.
     Do not reimplement for now.
@@ -143,6 +157,7 @@ private:
     JobDescription::Application _appl;
 
     std::atomic_bool _has_description = false;
+    std::atomic_bool _has_incomplete_description = false;
     JobDescription _description;
     int _desired_revision = 0;
     int _last_solved_revision = -1;
@@ -178,6 +193,10 @@ private:
     mutable int _age_of_const_cooldown = -1;
     mutable int _last_demand = 0;
 
+    // Update the job's meta data after the description of a revision was pushed.
+    void digestRevision();
+    void digestCompleteDescription();
+
 // Public methods.
 public:
 
@@ -195,6 +214,13 @@ public:
     void uncommit();
     // Add the job description of the next (or the first/only) revision.
     void pushRevision(const std::shared_ptr<std::vector<uint8_t>>& data);
+    void pushRevision(const JobDescription::SerializationView& view);
+    // Add the job description of the first revision of which only the meta data 
+    // have been received yet (see appl_canStartWithIncompleteDescription()).
+    void pushIncompleteRevision(const std::shared_ptr<std::vector<uint8_t>>& data);
+    // Replace the incomplete description of the first revision with the complete one.
+    void completeRevision(const std::shared_ptr<std::vector<uint8_t>>& data);
+    void completeRevision(const JobDescription::SerializationView& view);
     // Starts the execution of a new job.
     void start();
     // Suspend the execution of all internal solvers. They can be resumed at any time.
@@ -226,8 +252,9 @@ public:
     JobDescription::Application getApplication() const {return _appl;}
     bool isIncremental() const {return JobDescription::isApplicationIncremental(_appl);}
     bool hasDescription() const {return _has_description;};
+    bool hasIncompleteDescription() const {return _has_incomplete_description;};
     const JobDescription& getDescription() const {assert(hasDescription()); return _description;};
-    const std::shared_ptr<std::vector<uint8_t>>& getSerializedDescription(int revision) {return _description.getSerialization(revision);};
+    std::shared_ptr<std::vector<uint8_t>> getSerializedDescription(int revision) {return _description.getSerialization(revision);};
     bool hasCommitment() const {return _commitment.has_value();}
     const JobRequest& getCommitment() const {assert(hasCommitment()); return _commitment.value();}
     int getId() const {return _id;};
@@ -4,6 +4,8 @@
 
 #include <set>
 #include <list>
+#include <vector>
+#include <algorithm>
 #include "util/assert.hpp"
 
 #include "util/hashing.hpp"
@@ -58,6 +60,12 @@ private:
     int _wait_epoch = -1;
     int _stop_wait_epoch = -1;
 
+    // Locality-preserving placement: sorted world ranks of the processes on this host,
+    // position of this process among them, #tree levels of a subtree placed on one host
+    std::vector<int> _host_ranks;
+    int _pos_on_host = -1;
+    int _levels_per_host = 0;
+
 public:
     JobTree(int commSize, int rank, int seed, bool useDormantChildren) : 
         _comm_size(commSize), _rank(rank), _job_node_ranks(commSize, seed), 
@@ -71,8 +79,8 @@ public:
     int getRank() const {return _rank;}
     bool isRoot() const {return _index == 0;};
     int getRootNodeRank() const {return _job_node_ranks[0];};
-    int getLeftChildNodeRank() const {return _job_node_ranks[getLeftChildIndex()];};
-    int getRightChildNodeRank() const {return _job_node_ranks[getRightChildIndex()];};
+    int getLeftChildNodeRank() const {return getChildNodeRank(getLeftChildIndex());};
+    int getRightChildNodeRank() const {return getChildNodeRank(getRightChildIndex());};
     bool isLeaf() const {return !_has_left_child && !_has_right_child;}
     bool hasLeftChild() const {return _has_left_child;};
     bool hasRightChild() const {return _has_right_child;};
@@ -264,6 +272,24 @@ public:
         return _wait_epoch > _stop_wait_epoch;
     }
 
+    // Enables locality-preserving placement: the job tree is cut into subtrees of as many
+    // levels as fit onto a host, and each such subtree is placed on the host of its top node
+    // by default. Only the top node of each subtree is placed at a pseudorandom rank.
+    // A default rank is just the first destination of a job request: if the process
+    // is busy, the request is bounced on as usual.
+    void setHostRanks(const std::vector<int>& hostRanks) {
+        _host_ranks = hostRanks;
+        std::sort(_host_ranks.begin(), _host_ranks.end());
+        auto it = std::lower_bound(_host_ranks.begin(), _host_ranks.end(), _rank);
+        if (_host_ranks.size() < 2 || it == _host_ranks.end() || *it != _rank) {
+            _host_ranks.clear();
+            return;
+        }
+        _pos_on_host = it - _host_ranks.begin();
+        _levels_per_host = getDepth(_host_ranks.size()); // 2^levels - 1 <= #processes
+    }
+    bool hasLocalityPreservingPlacement() const {return !_host_ranks.empty();}
+
     int getNumChildren() const {
         int numChildren = 0;
         if (hasLeftChild()) numChildren++;
@@ -293,6 +319,22 @@ private:
         member = -1; // no desire any more
     }
 
+    int getChildNodeRank(int childIndex) const {
+        if (_host_ranks.empty() || _job_node_ranks.isAdjusted(childIndex) 
+                || getDepth(childIndex) % _levels_per_host == 0) {
+            return _job_node_ranks[childIndex];
+        }
+        // Same subtree as this node: offset the child's position on this host
+        // by its distance to this node in the subtree's breadth-first order
+        int offset = getIndexInHostSubtree(childIndex) - getIndexInHostSubtree(_index);
+        return _host_ranks[(_pos_on_host + offset) % _host_ranks.size()];
+    }
+    int getIndexInHostSubtree(int index) const {
+        int relDepth = getDepth(index) % _levels_per_host;
+        return (1 << relDepth) - 1 + ((index+1) & ((1 << relDepth) - 1));
+    }
+
+    static int getDepth(int index) {return 31 - __builtin_clz(index+1);}
     static int getLeftChildIndex(int index) {return 2*(index+1)-1;}
     static int getRightChildIndex(int index) {return 2*(index+1);}
     static int getParentIndex(int index) {return (index-1)/2;}    
@@ -7,6 +7,8 @@ struct SharingStatistics {
 	unsigned long clausesDroppedAtExport = 0;
 	unsigned long clausesProcessFilteredAtExport = 0;
 	unsigned long clausesSolverFilteredAtExport = 0;
+	unsigned long clausesDeferredAtExport = 0;
+	unsigned long clausesDroppedAtBacklog = 0;
 	ClauseHistogram* histProduced;
 	ClauseHistogram* histFailedFilter;
 	ClauseHistogram* histAdmittedToDb;
@@ -23,6 +25,8 @@ struct SharingStatistics {
 			+ " drp:" + std::to_string(clausesDroppedAtExport) 
 					+ "(" + std::to_string((float) (0.01 * (int)(droppedRatio*100))) + ")"
 			+ " pflt:" + std::to_string(clausesProcessFilteredAtExport)
-			+ " sflt:" + std::to_string(clausesSolverFilteredAtExport);
+			+ " sflt:" + std::to_string(clausesSolverFilteredAtExport)
+			+ " dfrd:" + std::to_string(clausesDeferredAtExport)
+			+ " bdrp:" + std::to_string(clausesDroppedAtBacklog);
 	}
 };
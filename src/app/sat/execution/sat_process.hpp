@@ -16,6 +16,7 @@
 #include "util/sys/process.hpp"
 #include "util/sys/proc.hpp"
 #include "data/checksum.hpp"
+#include "data/host_description_store.hpp"
 #include "util/sys/terminator.hpp"
 
 #include "engine.hpp"
@@ -40,6 +41,8 @@ private:
     int _desired_revision;
     Checksum* _checksum;
 
+    uint32_t _doorbell_seq = 0;
+
 public:
     SatProcess(const Parameters& params, const SatProcessConfig& config, Logger& log) 
         : _params(params), _config(config), _log(log), _engine(_params, _config, _log) {
@@ -74,8 +77,9 @@ public:
         // Import first revision
         _desired_revision = _config.firstrev;
         {
-            int* fPtr = (int*) accessMemory(_shmem_id + ".formulae.0", sizeof(int) * _hsm->fSize);
-            int* aPtr = (int*) accessMemory(_shmem_id + ".assumptions.0", sizeof(int) * _hsm->aSize);
+            const int* fPtr;
+            const int* aPtr;
+            accessRevisionPayload(0, _hsm->fSize, _hsm->aSize, fPtr, aPtr);
             _engine.appendRevision(0, _hsm->fSize, fPtr, _hsm->aSize, aPtr, 
                 /*finalRevisionForNow=*/_desired_revision == 0);
             updateChecksum(fPtr, _hsm->fSize);
@@ -149,6 +153,7 @@ public:
                 _hsm->lastNumAdmittedClausesToImport = admitted;
                 _hsm->lastNumClausesToImport = total;
                 assert(_hsm->exportBufferTrueSize <= _hsm->exportBufferAllocatedSize);
+                respond(SatSharedMemory::STAGE_EXPORT);
                 _hsm->didExport = true;
             }
             if (!_hsm->doExport) _hsm->didExport = false;
@@ -157,6 +162,7 @@ public:
             if (_hsm->doFilterImport && !_hsm->didFilterImport) {
                 LOGGER(_log, V5_DEBG, "DO filter clauses\n");
                 _hsm->filterSize = _engine.filterSharing(_import_buffer, _hsm->importBufferSize, _filter_buffer);
+                respond(SatSharedMemory::STAGE_FILTER);
                 _hsm->didFilterImport = true;
             }
             if (!_hsm->doFilterImport) _hsm->didFilterImport = false;
@@ -172,6 +178,7 @@ public:
                 } else {
                     _engine.digestSharingWithoutFilter(_import_buffer, _hsm->importBufferSize);
                 }
+                respond(SatSharedMemory::STAGE_DIGEST);
                 _hsm->didDigestImport = true;
             }
             if (!_hsm->doDigestImportWithFilter && !_hsm->doDigestImportWithoutFilter) 
@@ -181,6 +188,7 @@ public:
             if (_hsm->doReturnClauses && !_hsm->didReturnClauses) {
                 LOGGER(_log, V5_DEBG, "DO return clauses\n");
                 _engine.returnClauses(_returned_buffer, _hsm->returnedBufferSize);
+                respond(SatSharedMemory::STAGE_RETURN);
                 _hsm->didReturnClauses = true;
             }
             if (!_hsm->doReturnClauses) _hsm->didReturnClauses = false;
@@ -247,7 +255,26 @@ private:
         return ptr;
     }
 
-    void updateChecksum(int* ptr, size_t size) {
+    void accessRevisionPayload(int revision, size_t fSize, size_t aSize, const int*& fPtr, const int*& aPtr) {
+        std::string revStr = std::to_string(revision);
+        std::string refId = _shmem_id + ".descref." + revStr;
+        if (SharedMemory::canAccess(refId)) {
+            // Map the host's single copy of this revision read-only
+            auto ref = (HostDescriptionStore::Reference*) accessMemory(refId, sizeof(HostDescriptionStore::Reference));
+            const uint8_t* data = HostDescriptionStore::mapReadOnly(*ref);
+            if (data == nullptr) {
+                LOGGER(_log, V0_CRIT, "[ERROR] Could not access host store segment %s\n", ref->segmentName);
+                Process::doExit(0);
+            }
+            fPtr = (const int*) (data + ref->formulaOffset);
+            aPtr = (const int*) (data + ref->assumptionsOffset);
+            return;
+        }
+        fPtr = (const int*) accessMemory(_shmem_id + ".formulae." + revStr, sizeof(int) * fSize);
+        aPtr = (const int*) accessMemory(_shmem_id + ".assumptions." + revStr, sizeof(int) * aSize);
+    }
+
+    void updateChecksum(const int* ptr, size_t size) {
         if (_checksum == nullptr) return;
         for (size_t i = 0; i < size; i++) _checksum->combine(ptr[i]);
     }
@@ -272,8 +299,9 @@ private:
         size_t* fSizePtr = (size_t*) accessMemory(_shmem_id + ".fsize." + std::to_string(revision), sizeof(size_t));
         size_t* aSizePtr = (size_t*) accessMemory(_shmem_id + ".asize." + std::to_string(revision), sizeof(size_t));
         LOGGER(_log, V4_VVER, "Read rev. %i/%i : %i lits, %i assumptions\n", revision, _desired_revision, *fSizePtr, *aSizePtr);
-        int* fPtr = (int*) accessMemory(_shmem_id + ".formulae." + std::to_string(revision), sizeof(int) * (*fSizePtr));
-        int* aPtr = (int*) accessMemory(_shmem_id + ".assumptions." + std::to_string(revision), sizeof(int) * (*aSizePtr));
+        const int* fPtr;
+        const int* aPtr;
+        accessRevisionPayload(revision, *fSizePtr, *aSizePtr, fPtr, aPtr);
         
         if (checksum != nullptr) {
             // Append accessed data to local checksum
@@ -294,17 +322,15 @@ private:
     }
 
     void doSleep() {
-        // Wait until something happens
-        // (can be interrupted by Fork::wakeUp(hsm->childPid))
-        float time = Timer::elapsedSeconds();
-
-        // busy waiting
-        //while (Timer::elapsedSeconds() - time < 0.001) {}
+        // Wait until the parent rings the doorbell, but at most one millisecond
+        // (to periodically check the solvers' state)
+        _hsm->childDoorbell.wait(_doorbell_seq, 1000 /*1 millisecond*/);
+        // Any instruction issued after this point rings the doorbell anew
+        _doorbell_seq = _hsm->childDoorbell.getSequenceNumber();
+    }
 
-        // sleeping
-        int sleepStatus = usleep(1000 /*1 millisecond*/);
-        time = Timer::elapsedSeconds() - time;
-        if (sleepStatus != 0) LOGGER(_log, V5_DEBG, "Woken up after %i us\n", (int) (1000*1000*time));
+    void respond(SatSharedMemory::Stage stage) {
+        _hsm->stageResponseTime[stage] = Doorbell::getTimestampNanos();
     }
 
     void doTerminate() {
@@ -36,6 +36,7 @@ void AnytimeSatClauseCommunicator::communicate() {
         for (auto& session : _sessions) {
             session._allreduce_clauses.cancel();
             session._allreduce_filter.cancel();
+            session._allreduce_members.cancel();
         }
         return;
     }
@@ -48,13 +49,17 @@ void AnytimeSatClauseCommunicator::communicate() {
     if (_params.appCommPeriod() <= 0) return;
 
     // update role in distributed filter
-    //_filter.update(_job->getJobTree().getIndex(), _job->getVolume());
+    if (_params.distributedDuplicateDetection())
+        _filter.update(_job->getJobTree().getIndex(), std::max(1, _job->getVolume()));
 
-    // clean up old sessions
+    // clean up old sessions (only once concluded or cancelled: with several epochs
+    // in flight, a session may still await its filter without running any aggregation)
     while (_sessions.size() > 1) {
         auto& session = _sessions.front();
-        if (!session.isDestructible()) break;
+        bool disposable = (session.isConcluded() || !session.isValid()) && session.isDestructible();
+        if (!disposable) break;
         // can be deleted
+        returnExcessClauses(session);
         _sessions.pop_front();
     }
 
@@ -62,13 +67,16 @@ void AnytimeSatClauseCommunicator::communicate() {
     if (_job->getJobTree().isRoot()) {
         auto time = Timer::elapsedSeconds();
         bool nextEpochDue = time - _time_of_last_epoch_initiation >= _params.appCommPeriod();
-        bool lastEpochDone = _time_of_last_epoch_conclusion > 0;
-        if (nextEpochDue && !lastEpochDone) {
+        bool canInitiate = canInitiateEpoch();
+        if (nextEpochDue && !canInitiate) {
             LOG(V1_WARN, "[WARN] %s : Next epoch over-due!\n", _job->toStr());
         }
-        if (nextEpochDue && lastEpochDone) {
+        if (nextEpochDue && canInitiate) {
             _current_epoch++;
             JobMessage msg(_job->getId(), _job->getRevision(), _current_epoch, MSG_INITIATE_CLAUSE_SHARING);
+            // Distribute the sharing volume for this epoch
+            if (_params.adaptiveSharingVolume()) 
+                msg.payload.push_back((int) (1000 * _volume_ctrl.getVolumeFactor()));
 
             // Advance initiation time exactly by the specified period 
             // in order to lose no time for the subsequent epoch
@@ -76,6 +84,7 @@ void AnytimeSatClauseCommunicator::communicate() {
             // If an epoch has already been skipped, just set the initiation to the current time
             if (time - _time_of_last_epoch_initiation >= _params.appCommPeriod())
                 _time_of_last_epoch_initiation = time;
+            if (_time_of_first_epoch_initiation < 0) _time_of_first_epoch_initiation = time;
             
             _time_of_last_epoch_conclusion = 0;
             
@@ -86,37 +95,57 @@ void AnytimeSatClauseCommunicator::communicate() {
         }
     }
 
-    if (_sessions.empty()) return;
-    auto& session = currentSession();
-    if (!session.isValid()) return;
+    // Advance all sessions in the order of their epochs. A session may only
+    // contribute its clauses after all earlier sessions did so, and it may only
+    // begin to filter its clauses after all earlier sessions have been concluded
+    // (the local import of clauses proceeds strictly epoch by epoch).
+    bool previousProduced = true;
+    bool previousConcluded = true;
+    for (auto& session : _sessions) {
+        if (!session.isValid()) continue; // cancelled
+        advanceSession(session, previousProduced, previousConcluded);
+        previousProduced &= session._allreduce_clauses.hasProducer();
+        previousConcluded &= session.isConcluded();
+    }
+}
+
+void AnytimeSatClauseCommunicator::advanceSession(Session& session, bool previousProduced, bool previousConcluded) {
+
+    // Hierarchical mode: determine the structure of this session's all-reductions
+    session.advanceMembership();
 
     // Done preparing sharing?
-    if (!session._allreduce_clauses.hasProducer() && _job->hasPreparedSharing()) {
+    if (!session._allreduce_clauses.hasProducer() && previousProduced && _job->hasPreparedSharing()) {
 
         // Produce contribution to all-reduction of clauses
         LOG(V4_VVER, "%s CS produce cls\n", _job->toStr());
         session._allreduce_clauses.produce([&]() {
             Checksum checksum;
             auto clauses = _job->getPreparedClauses(checksum);
+            // (in pipelined mode, each segment is compressed individually)
+            if (session._compress && session._num_segments == 1) clauses = session.compress(clauses);
             clauses.push_back(1); // # aggregated workers
             return clauses;
         });
     
         // Calculate new sharing compensation factor from last sharing statistics
+        // (unless the volume is controlled by the root)
         auto [nbAdmitted, nbBroadcast] = _job->getLastAdmittedClauseShare();
-        float admittedRatio = nbBroadcast == 0 ? 1 : ((float)nbAdmitted) / nbBroadcast;
-        admittedRatio = std::max(0.01f, admittedRatio);
-        float newCompensationFactor = std::max(1.f, std::min(
-            (float)_params.clauseHistoryAggregationFactor(), 1.f/admittedRatio
-        ));
-        _compensation_factor = _compensation_decay * _compensation_factor + (1-_compensation_decay) * newCompensationFactor;
-        _job->setSharingCompensationFactor(_compensation_factor);
-        if (_job->getJobTree().isRoot()) {
-            LOG(V3_VERB, "%s CS last sharing: %i/%i globally passed ~> c=%.3f\n", _job->toStr(), 
-                nbAdmitted, nbBroadcast, _compensation_factor);       
+        if (!_params.adaptiveSharingVolume()) {
+            float admittedRatio = nbBroadcast == 0 ? 1 : ((float)nbAdmitted) / nbBroadcast;
+            admittedRatio = std::max(0.01f, admittedRatio);
+            float newCompensationFactor = std::max(1.f, std::min(
+                (float)_params.clauseHistoryAggregationFactor(), 1.f/admittedRatio
+            ));
+            _compensation_factor = _compensation_decay * _compensation_factor + (1-_compensation_decay) * newCompensationFactor;
+            _job->setSharingCompensationFactor(_compensation_factor);
+            if (_job->getJobTree().isRoot()) {
+                LOG(V3_VERB, "%s CS last sharing: %i/%i globally passed ~> c=%.3f\n", _job->toStr(), 
+                    nbAdmitted, nbBroadcast, _compensation_factor);       
+            }
         }
     
-    } else if (!session._allreduce_clauses.hasProducer()) {
+    } else if (!session._allreduce_clauses.hasProducer() && previousProduced) {
         // No sharing prepared yet: Retry
         _job->prepareSharing(_job->getBufferLimit(1, MyMpi::SELF));
     }
@@ -125,28 +154,33 @@ void AnytimeSatClauseCommunicator::communicate() {
     session._allreduce_clauses.advance();
 
     // All-reduction of clauses finished?
-    if (session._allreduce_clauses.hasResult()) {
+    if (previousConcluded && !session.isFiltering() && session._allreduce_clauses.hasResult()) {
 
         LOG(V4_VVER, "%s CS filter\n", _job->toStr());
 
-        // Some clauses may have been left behind during merge
-        if (session._excess_clauses_from_merge.size() > sizeof(size_t)/sizeof(int)) {
-            // Add them as produced clauses to your local solver
-            // so that they can be re-exported (if they are good enough)
-            _job->returnClauses(session._excess_clauses_from_merge);
-        }
+        // Some clauses may have been left behind during merge:
+        // Add them as produced clauses to your local solver
+        // so that they can be re-exported (if they are good enough)
+        returnExcessClauses(session);
 
         // Fetch initial clause buffer (result of all-reduction of clauses)
         session._broadcast_clause_buffer = session._allreduce_clauses.extractResult();
+        session.recordWireTraffic();
 
         // Initiate production of local filter element for 2nd all-reduction 
         _job->filterSharing(session._broadcast_clause_buffer);
+        session.setFiltering();
     }
 
     // Supply calculated local filter to the 2nd all-reduction
-    if (!session._allreduce_filter.hasProducer() && _job->hasFilteredSharing()) {
+    if (session.isFiltering() && !session._allreduce_filter.hasProducer() && _job->hasFilteredSharing()) {
         LOG(V4_VVER, "%s CS produce filter\n", _job->toStr());
-        session._allreduce_filter.produce([&]() {return _job->getLocalFilter();});
+        session._allreduce_filter.produce([&]() {
+            auto filter = _job->getLocalFilter();
+            if (_params.distributedDuplicateDetection())
+                applyDistributedFilter(session._broadcast_clause_buffer, filter, session._epoch);
+            return filter;
+        });
     }
 
     // Advance all-reduction of filter
@@ -163,11 +197,66 @@ void AnytimeSatClauseCommunicator::communicate() {
         if (_use_cls_history) {
             auto filteredClauses = session.applyGlobalFilter(filter, session._broadcast_clause_buffer);
             addToClauseHistory(filteredClauses, session._epoch);
+        } else if (_job->getJobTree().isRoot()) {
+            session.countAdmittedClauses(filter);
         }
 
         // Conclude this sharing epoch
+        session.setConcluded();
         _time_of_last_epoch_conclusion = Timer::elapsedSeconds();
+        LOG(V4_VVER, "%s CS e=%i %s\n", _job->toStr(), session._epoch, session._wire_stats.getReport().c_str());
+        if (_job->getJobTree().isRoot()) {
+            // Report sharing throughput
+            _num_concluded_epochs++;
+            _num_admitted_clauses_total += session._num_admitted_clauses;
+            float elapsed = std::max(0.000001f, _time_of_last_epoch_conclusion - _time_of_first_epoch_initiation);
+            LOG(V3_VERB, "%s CS e=%i lat=%.4f adm=%i/%i freq=%.3f/s cls/s=%.1f\n", _job->toStr(), session._epoch,
+                _time_of_last_epoch_conclusion - session._initiation_time, 
+                session._num_admitted_clauses, session._num_broadcast_clauses,
+                _num_concluded_epochs / elapsed, _num_admitted_clauses_total / elapsed);
+            if (_params.adaptiveSharingVolume()) {
+                // Adjust the sharing volume of subsequent epochs
+                SharingVolumeController::Observation obs;
+                obs.numBroadcastClauses = session._num_broadcast_clauses;
+                obs.numAdmittedClauses = session._num_admitted_clauses;
+                obs.fillRatio = session._buffer_limit == 0 ? 0 :
+                    (float) session._aggregated_flat_size / session._buffer_limit;
+                obs.leftClausesBehind = session._left_clauses_behind;
+                obs.latency = _time_of_last_epoch_conclusion - session._initiation_time;
+                _volume_ctrl.update(obs);
+                LOG(V4_VVER, "%s CS volume %s\n", _job->toStr(), _volume_ctrl.getReport().c_str());
+            }
+        }
+    }
+}
+
+AnytimeSatClauseCommunicator::Session* AnytimeSatClauseCommunicator::getSession(int epoch) {
+    for (auto& session : _sessions) if (session._epoch == epoch) return &session;
+    return nullptr;
+}
+
+bool AnytimeSatClauseCommunicator::canInitiateEpoch() {
+    // The self message initiating the last epoch has not arrived yet?
+    if (_current_epoch > 0 && (_sessions.empty() || _sessions.back()._epoch != _current_epoch)) 
+        return false;
+    int numInFlight = 0;
+    for (auto& session : _sessions) {
+        if (session.isValid() && !session.isConcluded()) numInFlight++;
+    }
+    if (numInFlight == 0) return true;
+    if (numInFlight >= _params.numSharingEpochsInFlight()) return false;
+    // All nodes must have contributed to the last epoch before
+    // the next epoch's clauses can be exported
+    return _sessions.back().isFiltering();
+}
+
+void AnytimeSatClauseCommunicator::returnExcessClauses(Session& session) {
+    for (auto& excessClauses : session._excess_clauses_from_merge) {
+        if (excessClauses.size() > sizeof(size_t)/sizeof(int)) {
+            _job->returnClauses(excessClauses);
+        }
     }
+    session._excess_clauses_from_merge.clear();
 }
 
 void AnytimeSatClauseCommunicator::handle(int source, int mpiTag, JobMessage& msg) {
@@ -198,13 +287,27 @@ void AnytimeSatClauseCommunicator::handle(int source, int mpiTag, JobMessage& ms
     // Process unsuccessful, returned messages
     if (msg.returnedToSender) {
         msg.returnedToSender = false;
-        if (msg.tag == MSG_INITIATE_CLAUSE_SHARING) {
+        if (msg.tag == MSG_INITIATE_CLAUSE_SHARING && _params.hierarchicalClauseSharing()) {
             // Initiation signal hit an inactive (?) child:
-            // Pretend that it sent an empty set of clauses
-            msg.tag = MSG_ALLREDUCE_CLAUSES;
+            // Pretend that it does not participate
+            msg.tag = MSG_ALLREDUCE_MEMBERS;
             mpiTag = MSG_JOB_TREE_REDUCTION;
-            msg.payload.resize(1);
-            msg.payload[0] = 1; // num aggregated nodes
+            msg.payload.clear();
+        } else if (msg.tag == MSG_INITIATE_CLAUSE_SHARING) {
+            // Initiation signal hit an inactive (?) child:
+            // Pretend that it sent an empty set of clauses
+            Session* session = getSession(msg.epoch);
+            if (session != nullptr && session->_allreduce_clauses.isValid()) {
+                session->_allreduce_clauses.receiveNeutralElement(source);
+                session->_allreduce_clauses.advance();
+            }
+            return;
+        } else if (msg.tag == MSG_ALLREDUCE_MEMBERS && mpiTag == MSG_JOB_TREE_BROADCAST) {
+            // The child left after contributing to the membership: 
+            // notify the nodes which wait for its clauses (or the clauses of its subtree)
+            Session* session = getSession(msg.epoch);
+            if (session != nullptr) session->notifyAbsentMembersBelow(source);
+            return;
         } else if (msg.tag == MSG_ALLREDUCE_CLAUSES && mpiTag == MSG_JOB_TREE_BROADCAST) {
             // Distribution of clauses hit an inactive (?) child:
             // Pretend that it sent an empty filter
@@ -217,6 +320,10 @@ void AnytimeSatClauseCommunicator::handle(int source, int mpiTag, JobMessage& ms
     // Initial signal to initiate a sharing epoch
     if (msg.tag == MSG_INITIATE_CLAUSE_SHARING) {
         _current_epoch = msg.epoch;
+        if (_params.adaptiveSharingVolume() && msg.payload.size() == 1) {
+            // Apply the sharing volume determined by the root
+            _job->setSharingCompensationFactor(0.001f * msg.payload[0]);
+        }
         LOG(V5_DEBG, "%s : INIT COMM e=%i nc=%i\n", _job->toStr(), _current_epoch, 
             _job->getJobTree().getNumChildren());
         _sessions.emplace_back(_params, _job, _cdb, _current_epoch);
@@ -227,15 +334,25 @@ void AnytimeSatClauseCommunicator::handle(int source, int mpiTag, JobMessage& ms
         advanceCollective(_job, msg, MSG_INITIATE_CLAUSE_SHARING);
     }
 
-    // Advance all-reductions
+    // Advance all-reductions of the session the message belongs to
     bool success = false;
-    if (!_sessions.empty() && msg.tag == MSG_ALLREDUCE_CLAUSES && currentSession()._allreduce_clauses.isValid()) {
-        success = currentSession()._allreduce_clauses.receive(source, mpiTag, msg);
-        currentSession()._allreduce_clauses.advance();
+    Session* session = getSession(msg.epoch);
+    if (session != nullptr && msg.tag == MSG_ALLREDUCE_CLAUSES && session->_allreduce_clauses.isValid()) {
+        success = session->_allreduce_clauses.receive(source, mpiTag, msg);
+        session->_allreduce_clauses.advance();
     }
-    if (!_sessions.empty() && msg.tag == MSG_ALLREDUCE_FILTER && currentSession()._allreduce_filter.isValid()) {
-        success = currentSession()._allreduce_filter.receive(source, mpiTag, msg);
-        currentSession()._allreduce_filter.advance();
+    if (session != nullptr && msg.tag == MSG_ALLREDUCE_FILTER && session->_allreduce_filter.isValid()) {
+        success = session->_allreduce_filter.receive(source, mpiTag, msg);
+        session->_allreduce_filter.advance();
+    }
+    if (session != nullptr && msg.tag == MSG_ALLREDUCE_MEMBERS && session->_allreduce_members.isValid()) {
+        success = session->_allreduce_members.receive(source, mpiTag, msg);
+        session->advanceMembership();
+    }
+    if (session != nullptr && msg.tag == MSG_NOTIFY_ABSENT_MEMBERS && session->_allreduce_clauses.isValid()) {
+        for (int absentRank : msg.payload) session->_allreduce_clauses.receiveNeutralElement(absentRank);
+        session->_allreduce_clauses.advance();
+        success = true;
     }
     if (!success) {
         // Special case where clauses are broadcast but message was not processed:
@@ -245,6 +362,12 @@ void AnytimeSatClauseCommunicator::handle(int source, int mpiTag, JobMessage& ms
             msg.tag = MSG_ALLREDUCE_FILTER;
             MyMpi::isend(source, MSG_JOB_TREE_REDUCTION, msg);
         }
+        // Members are broadcast but message was not processed:
+        // Return it to the sender such that it treats this node as absent
+        if (msg.tag == MSG_ALLREDUCE_MEMBERS && mpiTag == MSG_JOB_TREE_BROADCAST) {
+            msg.returnedToSender = true;
+            MyMpi::isend(source, mpiTag, msg);
+        }
     }
 }
 
@@ -252,6 +375,112 @@ void AnytimeSatClauseCommunicator::feedHistoryIntoSolver() {
     if (_use_cls_history) _cls_history.feedHistoryIntoSolver();
 }
 
+std::vector<std::vector<int>> AnytimeSatClauseCommunicator::Session::splitClauses(std::vector<int>&& clauses) {
+
+    // Trailing integer: number of aggregated job tree nodes
+    int numAggregated = clauses.back();
+    clauses.pop_back();
+    std::vector<std::vector<int>> segments(_num_segments);
+    if (!clauses.empty()) segments = _cdb.splitBuffer(clauses.data(), clauses.size(), _num_segments);
+    for (auto& segment : segments) {
+        if (_compress && !segment.empty()) segment = compress(segment);
+        segment.push_back(numAggregated);
+    }
+    return segments;
+}
+
+std::vector<int> AnytimeSatClauseCommunicator::Session::joinClauses(std::vector<std::vector<int>>&& segments) {
+
+    int numAggregated = segments.front().back();
+    float time = Timer::elapsedSeconds();
+    _broadcast_wire_size = 0;
+    // The segments cover disjoint, ordered ranges of buckets: merging them is a concatenation
+    auto merger = _cdb.getBufferMerger(-1);
+    for (auto& segment : segments) {
+        segment.pop_back();
+        _broadcast_wire_size += segment.size();
+        merger.add(_cdb.getBufferReader(segment.data(), segment.size(), false, _compress));
+    }
+    auto clauses = merger.merge();
+    _wire_stats.decodeTime += Timer::elapsedSeconds() - time;
+    clauses.push_back(numAggregated);
+    return clauses;
+}
+
+void AnytimeSatClauseCommunicator::Session::advanceMembership() {
+
+    if (!_hierarchical || _has_plan || !_allreduce_members.isValid()) return;
+    _allreduce_members.advance();
+    if (!_allreduce_members.hasResult()) return;
+
+    // Participants of this session are known: set up the two-level all-reductions
+    _plan = HierarchicalReductionPlan(_allreduce_members.extractResult());
+    _has_plan = true;
+    int myRank = _job->getJobTree().getRank();
+    if (!_plan.contains(myRank)) {
+        LOG(V1_WARN, "[WARN] %s : not part of CS e=%i\n", _job->toStr(), _epoch);
+        _allreduce_clauses.cancel();
+        _allreduce_filter.cancel();
+        return;
+    }
+    if (_job->getJobTree().isRoot()) {
+        LOG(V4_VVER, "%s CS e=%i hierarchy: %i nodes on %i hosts\n", _job->toStr(), 
+            _epoch, _plan.size(), _plan.getNumHosts());
+    }
+    int parentRank = _plan.getParentRank(myRank);
+    _allreduce_clauses.setTopology(parentRank, _plan.getChildRanks(myRank));
+    _allreduce_filter.setTopology(parentRank, _plan.getChildRanks(myRank));
+}
+
+void AnytimeSatClauseCommunicator::Session::notifyAbsentMembersBelow(int childRank) {
+
+    if (!_has_plan || !_plan.contains(childRank)) return;
+
+    // The job tree child and its entire subtree left the job: Each node expecting
+    // a contribution from the subtree receives a neutral element on its behalf
+    robin_hood::unordered_map<int, std::vector<int>> absentRanksByParent;
+    for (auto [absentRank, parentRank] : _plan.getMembersDetachedBelow(_plan.getIndex(childRank))) {
+        absentRanksByParent[parentRank].push_back(absentRank);
+    }
+    for (auto& [parentRank, absentRanks] : absentRanksByParent) {
+        LOG(V4_VVER, "%s CS e=%i : %i absent members below [%i]\n", _job->toStr(), 
+            _epoch, absentRanks.size(), childRank);
+        if (parentRank == _job->getJobTree().getRank()) {
+            for (int absentRank : absentRanks) _allreduce_clauses.receiveNeutralElement(absentRank);
+            _allreduce_clauses.advance();
+        } else {
+            JobMessage msg(_job->getId(), _job->getRevision(), _epoch, MSG_NOTIFY_ABSENT_MEMBERS);
+            msg.payload = std::move(absentRanks);
+            MyMpi::isend(parentRank, MSG_SEND_APPLICATION_MESSAGE, msg);
+        }
+    }
+}
+
+void AnytimeSatClauseCommunicator::Session::recordWireTraffic() {
+
+    // Trailing integer: number of aggregated job tree nodes
+    auto& buffer = _broadcast_clause_buffer;
+    int numAggregated = buffer.back();
+    buffer.pop_back();
+    size_t wireSize = buffer.size();
+    if (_num_segments > 1) {
+        // Segments were already joined into a flat buffer
+        wireSize = _broadcast_wire_size;
+    } else if (_compress) buffer = decompress(buffer);
+    size_t flatSize = buffer.size();
+    buffer.push_back(numAggregated);
+
+    // This node sent the aggregated buffer to its parent (if any) and
+    // forwards the final buffer to each of its children.
+    if (!_allreduce_clauses.isRoot()) {
+        _wire_stats.wireBytes += _aggregated_wire_size * sizeof(int);
+        _wire_stats.flatBytes += _aggregated_flat_size * sizeof(int);
+    }
+    size_t numChildren = _allreduce_clauses.getNumChildren();
+    _wire_stats.wireBytes += numChildren * wireSize * sizeof(int);
+    _wire_stats.flatBytes += numChildren * flatSize * sizeof(int);
+}
+
 std::vector<int> AnytimeSatClauseCommunicator::Session::applyGlobalFilter(const std::vector<int>& filter, std::vector<int>& clauses) {
 
     size_t clsIdx = 0;
@@ -281,6 +510,24 @@ std::vector<int> AnytimeSatClauseCommunicator::Session::applyGlobalFilter(const
     return writer.extractBuffer();
 }
 
+void AnytimeSatClauseCommunicator::Session::countAdmittedClauses(const std::vector<int>& filter) {
+
+    constexpr auto bitsPerElem = 8*sizeof(int);
+    auto reader = _cdb.getBufferReader(_broadcast_clause_buffer.data(), _broadcast_clause_buffer.size());
+    size_t clsIdx = 0;
+    int numAdmitted = 0;
+    auto clause = reader.getNextIncomingClause();
+    while (clause.begin != nullptr) {
+        size_t filterIdx = clsIdx / bitsPerElem;
+        if (filterIdx >= filter.size() || (filter[filterIdx] & (1 << (clsIdx % bitsPerElem))) == 0)
+            numAdmitted++;
+        clsIdx++;
+        clause = reader.getNextIncomingClause();
+    }
+    _num_broadcast_clauses = clsIdx;
+    _num_admitted_clauses = numAdmitted;
+}
+
 void AnytimeSatClauseCommunicator::addToClauseHistory(std::vector<int>& clauses, int epoch) {
     LOG(V4_VVER, "%s : learn s=%i\n", _job->toStr(), clauses.size());
     
@@ -290,3 +537,28 @@ void AnytimeSatClauseCommunicator::addToClauseHistory(std::vector<int>& clauses,
     // Send next batches of historic clauses to subscribers as necessary
     _cls_history.sendNextBatches();
 }
+
+void AnytimeSatClauseCommunicator::applyDistributedFilter(const std::vector<int>& clauses, 
+        std::vector<int>& localFilter, int epoch) {
+
+    // Mark each clause which the distributed filter recognizes as a duplicate
+    constexpr auto bitsPerElem = 8*sizeof(int);
+    auto reader = _cdb.getBufferReader((int*) clauses.data(), clauses.size());
+    size_t clsIdx = 0;
+    auto clause = reader.getNextIncomingClause();
+    while (clause.begin != nullptr) {
+        if (!_filter.passClause(clause, epoch)) {
+            size_t filterIdx = clsIdx / bitsPerElem;
+            if (localFilter.size() <= filterIdx) localFilter.resize(filterIdx+1);
+            localFilter[filterIdx] |= 1 << (clsIdx % bitsPerElem);
+        }
+        clsIdx++;
+        clause = reader.getNextIncomingClause();
+    }
+    LOG(V4_VVER, "%s : DDD %s\n", _job->toStr(), _filter.getReport().c_str());
+}
+
+void AnytimeSatClauseCommunicator::dumpStats() {
+    if (!_params.adaptiveSharingVolume() || !_job->getJobTree().isRoot()) return;
+    LOG(V3_VERB, "%s CS volume %s\n", _job->toStr(), _volume_ctrl.getReport().c_str());
+}
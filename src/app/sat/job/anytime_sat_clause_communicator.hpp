@@ -5,13 +5,17 @@
 
 #include "util/params.hpp"
 #include "util/hashing.hpp"
+#include "util/sys/timer.hpp"
 #include "../sharing/buffer/adaptive_clause_database.hpp"
 #include "data/job_transfer.hpp"
 #include "app/job.hpp"
 #include "base_sat_job.hpp"
 #include "clause_history.hpp"
-//#include "distributed_clause_filter.hpp"
+#include "distributed_clause_filter.hpp"
+#include "sharing_volume_controller.hpp"
+#include "comm/host_comm.hpp"
 #include "comm/job_tree_all_reduction.hpp"
+#include "comm/hierarchical_reduction_plan.hpp"
 
 class AnytimeSatClauseCommunicator {
 
@@ -35,28 +39,69 @@ private:
 
     AdaptiveClauseDatabase _cdb;
     ClauseHistory _cls_history;
-    //DistributedClauseFilter _filter;
+    DistributedClauseFilter _filter;
+    SharingVolumeController _volume_ctrl;
     float _compensation_factor = 1.0f;
     float _compensation_decay = 0.6;
 
+    // Statistics on the clause buffers sent by this node within one epoch
+    struct WireStatistics {
+        unsigned long flatBytes = 0; // size the sent buffers would have in the flat format
+        unsigned long wireBytes = 0; // actual size of the sent buffers
+        float encodeTime = 0;
+        float decodeTime = 0; // inflating the final buffer
+        float mergeTime = 0; // merging (and decoding) the incoming buffers
+        std::string getReport() const {
+            float ratio = flatBytes == 0 ? 1 : (float)wireBytes / flatBytes;
+            return "wire:" + std::to_string(wireBytes) + "/" + std::to_string(flatBytes)
+                + "(" + std::to_string((float) (0.001 * (int)(ratio*1000))) + ")"
+                + " enc:" + std::to_string(encodeTime)
+                + " dec:" + std::to_string(decodeTime)
+                + " mrg:" + std::to_string(mergeTime);
+        }
+    };
+
     struct Session {
 
         const Parameters& _params;
         BaseSatJob* _job;
         AdaptiveClauseDatabase& _cdb;
         int _epoch;
+        const bool _compress;
+        const bool _hierarchical;
+        const int _num_segments;
 
-        std::vector<int> _excess_clauses_from_merge;
+        std::vector<std::vector<int>> _excess_clauses_from_merge;
+        bool _left_clauses_behind = false;
+        size_t _buffer_limit = 0;
+        // Pipelined mode: literals left for the segments yet to be merged
+        // (and for the excess clauses of these segments)
+        int _segment_budget = 0;
+        int _segment_excess_budget = 0;
+        int _num_merged_segments = 0;
+        size_t _broadcast_wire_size = 0;
         std::vector<int> _broadcast_clause_buffer;
-        int _num_broadcast_clauses;
-        int _num_admitted_clauses;
+        int _num_broadcast_clauses = 0;
+        int _num_admitted_clauses = 0;
+        WireStatistics _wire_stats;
+        size_t _aggregated_flat_size = 0;
+        size_t _aggregated_wire_size = 0;
+        float _initiation_time;
 
         JobTreeAllReduction _allreduce_clauses;
         JobTreeAllReduction _allreduce_filter;
+        // Hierarchical mode: all-reduction of the participating job nodes
+        // which determines the structure of the above all-reductions
+        JobTreeAllReduction _allreduce_members;
+        HierarchicalReductionPlan _plan;
+        bool _has_plan = false;
         bool _filtering = false;
+        bool _concluded = false;
 
         Session(const Parameters& params, BaseSatJob* job, AdaptiveClauseDatabase& cdb, int epoch) : 
-            _params(params), _job(job), _cdb(cdb), _epoch(epoch),
+            _params(params), _job(job), _cdb(cdb), _epoch(epoch), _compress(params.compressClauseBuffers()),
+            _hierarchical(params.hierarchicalClauseSharing()), _num_segments(params.numClauseSharingSegments()),
+            _initiation_time(Timer::elapsedSeconds()),
             _allreduce_clauses(
                 job->getJobTree(),
                 // Base message 
@@ -70,13 +115,35 @@ private:
                         numAggregated += elem.back();
                         elem.pop_back();
                     }
-                    auto merger = _cdb.getBufferMerger(_job->getBufferLimit(numAggregated, MyMpi::ALL));
+                    float time = Timer::elapsedSeconds();
+                    // In pipelined mode, the segments are merged one after the other in the
+                    // order of clause priority, and all of them share the buffer limit
+                    if (_num_merged_segments == 0) {
+                        _buffer_limit = _job->getBufferLimit(numAggregated, MyMpi::ALL);
+                        _segment_budget = _buffer_limit;
+                        _segment_excess_budget = _buffer_limit;
+                    }
+                    _num_merged_segments++;
+                    auto merger = _cdb.getBufferMerger(_segment_budget);
+                    merger.setExcessSizeLimit(_segment_excess_budget);
+                    merger.setNumParallelSubmerges(_params.numMergeThreads());
                     for (auto& elem : elems) {
-                        merger.add(_cdb.getBufferReader(elem.data(), elem.size()));
+                        merger.add(_cdb.getBufferReader(elem.data(), elem.size(), false, _compress));
                     }
-                    std::vector<int> merged = merger.merge(&_excess_clauses_from_merge);
+                    std::vector<int> excess;
+                    std::vector<int> merged = merger.merge(&excess);
+                    _left_clauses_behind |= excess.size() > sizeof(size_t)/sizeof(int);
+                    // Once a clause did not fit, all subsequent clauses are excess clauses
+                    _segment_budget = merger.getNumExcessLiterals() > 0 ? 0 
+                        : _segment_budget - merger.getNumMergedLiterals();
+                    _segment_excess_budget -= merger.getNumExcessLiterals();
+                    _excess_clauses_from_merge.push_back(std::move(excess));
+                    _wire_stats.mergeTime += Timer::elapsedSeconds() - time;
                     LOG(V4_VVER, "%s : merged %i contribs ~> len=%i\n", 
                         _job->toStr(), numAggregated, merged.size());
+                    _aggregated_flat_size += merged.size();
+                    if (_compress) merged = compress(merged);
+                    _aggregated_wire_size += merged.size();
                     merged.push_back(numAggregated);
                     return merged;
                 }
@@ -100,22 +167,79 @@ private:
                     }
                     return filter;
                 }
-            ) { }
+            ),
+            _allreduce_members(
+                job->getJobTree(),
+                // Base message
+                JobMessage(_job->getId(), _job->getRevision(), epoch, MSG_ALLREDUCE_MEMBERS),
+                // Neutral element
+                std::vector<int>(),
+                // Aggregator for local + incoming elements
+                [&](std::list<std::vector<int>>& elems) {
+                    std::vector<int> members;
+                    for (auto& elem : elems) members.insert(members.end(), elem.begin(), elem.end());
+                    return members;
+                }
+            ) {
+            
+            if (_num_segments > 1) {
+                _allreduce_clauses.setPipelining(_num_segments, 
+                    [&](std::vector<int>&& elem) {return splitClauses(std::move(elem));}, 
+                    [&](std::vector<std::vector<int>>&& segments) {return joinClauses(std::move(segments));}
+                );
+            }
+            if (_hierarchical) {
+                _allreduce_clauses.awaitTopology();
+                _allreduce_filter.awaitTopology();
+                _allreduce_members.produce([&]() {
+                    auto& tree = _job->getJobTree();
+                    int host = HostComm::getHostId() >= 0 ? HostComm::getHostId() : tree.getRank();
+                    std::vector<int> member;
+                    HierarchicalReductionPlan::appendMember(member, tree.getIndex(), tree.getRank(), host);
+                    return member;
+                });
+            }
+        }
         ~Session() {
             _allreduce_clauses.destroy();
             _allreduce_filter.destroy();
+            _allreduce_members.destroy();
         }
 
+        std::vector<int> compress(const std::vector<int>& buffer) {
+            float time = Timer::elapsedSeconds();
+            auto compressed = _cdb.compressBuffer(buffer.data(), buffer.size());
+            _wire_stats.encodeTime += Timer::elapsedSeconds() - time;
+            return compressed;
+        }
+        std::vector<int> decompress(const std::vector<int>& buffer) {
+            float time = Timer::elapsedSeconds();
+            auto flat = _cdb.decompressBuffer(buffer.data(), buffer.size());
+            _wire_stats.decodeTime += Timer::elapsedSeconds() - time;
+            return flat;
+        }
+
+        std::vector<std::vector<int>> splitClauses(std::vector<int>&& clauses);
+        std::vector<int> joinClauses(std::vector<std::vector<int>>&& segments);
+
+        void advanceMembership();
+        void notifyAbsentMembersBelow(int childRank);
+
         void setFiltering() {_filtering = true;}
         bool isFiltering() const {return _filtering;}
+        void setConcluded() {_concluded = true;}
+        bool isConcluded() const {return _concluded;}
         std::vector<int> applyGlobalFilter(const std::vector<int>& filter, std::vector<int>& clauses);
+        void countAdmittedClauses(const std::vector<int>& filter);
+        void recordWireTraffic();
 
         bool isValid() const {
             return _allreduce_clauses.isValid() || _allreduce_filter.isValid();
         }
 
         bool isDestructible() {
-            return _allreduce_clauses.isDestructible() && _allreduce_filter.isDestructible();
+            return _allreduce_clauses.isDestructible() && _allreduce_filter.isDestructible()
+                && _allreduce_members.isDestructible();
         }
     };
 
@@ -125,6 +249,11 @@ private:
     float _time_of_last_epoch_initiation = 0;
     float _time_of_last_epoch_conclusion = 0.000001f;
 
+    // Sharing throughput as observed at the root
+    float _time_of_first_epoch_initiation = -1;
+    int _num_concluded_epochs = 0;
+    unsigned long _num_admitted_clauses_total = 0;
+
 public:
     AnytimeSatClauseCommunicator(const Parameters& params, BaseSatJob* job) : _params(params), _job(job), 
         _clause_buf_base_size(_params.clauseBufferBaseSize()), 
@@ -138,7 +267,11 @@ public:
             setup.numLiterals = 0;
             return setup;
         }()),
-        _cls_history(_params, _job->getBufferLimit(_job->getJobTree().getCommSize(), MyMpi::ALL), *job, _cdb) {
+        _cls_history(_params, _job->getBufferLimit(_job->getJobTree().getCommSize(), MyMpi::ALL), *job, _cdb),
+        _filter((int) _params.clauseFilterClearInterval(), 1024UL * _params.distributedFilterMemoryKb(),
+            _params.distributedFilterHashFunctions(), _params.distributedFilterGenerations()),
+        _volume_ctrl(0.1f, _params.maxSharingVolumeFactor(), _params.clauseHistoryAggregationFactor(),
+            0.5f * _params.appCommPeriod() * _params.numSharingEpochsInFlight()) {
 
         _time_of_last_epoch_initiation = Timer::elapsedSeconds();
         _time_of_last_epoch_conclusion = Timer::elapsedSeconds();
@@ -151,6 +284,7 @@ public:
     void communicate();
     void handle(int source, int mpiTag, JobMessage& msg);
     void feedHistoryIntoSolver();
+    void dumpStats();
     bool isDestructible() {
         for (auto& session : _sessions) if (!session.isDestructible()) return false;
         return true;
@@ -158,5 +292,10 @@ public:
 
 private:
     inline Session& currentSession() {return _sessions.back();}
+    Session* getSession(int epoch);
+    bool canInitiateEpoch();
+    void advanceSession(Session& session, bool previousProduced, bool previousConcluded);
+    void returnExcessClauses(Session& session);
     void addToClauseHistory(std::vector<int>& clauses, int epoch);
+    void applyDistributedFilter(const std::vector<int>& clauses, std::vector<int>& localFilter, int epoch);
 };
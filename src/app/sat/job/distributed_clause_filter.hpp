@@ -2,15 +2,33 @@
 #pragma once
 
 #include <stdint.h>
+#include <memory>
 
 #include "../data/clause.hpp"
 #include "../sharing/filter/clause_filter.hpp"
+#include "../sharing/filter/aging_bloom_filter.hpp"
 #include "app/job_tree.hpp"
 
+// Each node of a job tree is responsible for a range of clause hashes and remembers
+// the clauses from this range which were shared. Either an exact map of full clauses
+// is used or, if a memory budget is provided, an AgingBloomFilter over clause hashes
+// whose generations advance with the epochs such that the memory is bounded
+// and clauses are forgotten after roughly the same number of epochs.
 class DistributedClauseFilter {
 
+public:
+    struct Statistics {
+        unsigned long numQueries = 0;
+        unsigned long numFiltered = 0;
+        unsigned long numRegistered = 0;
+    };
+
 private:
     robin_hood::unordered_flat_map<Mallob::Clause, int, NonCommutativeClauseHasher, SortedClauseExactEquals> _filter;
+    std::unique_ptr<AgingBloomFilter> _approx_filter;
+    int _epochs_per_generation = 1;
+    int _approx_generation_epoch = 0;
+    Statistics _stats;
 
     int _last_index = -1;
     int _last_volume = -1;
@@ -25,6 +43,17 @@ private:
 public:
     DistributedClauseFilter(int numRememberedEpochs) : 
         _num_remembered_epochs(numRememberedEpochs >= 0 ? numRememberedEpochs : INT32_MAX) {}
+    
+    // Approximate filter with the provided memory budget (or exact filter if the budget is zero).
+    DistributedClauseFilter(int numRememberedEpochs, size_t memoryBytes, int numHashFunctions, int numGenerations) : 
+            DistributedClauseFilter(numRememberedEpochs) {
+        if (memoryBytes == 0) return;
+        if (numRememberedEpochs < 0) numGenerations = 1; // never forget
+        _approx_filter.reset(new AgingBloomFilter(memoryBytes, numHashFunctions, numGenerations));
+        // Remember each clause for at least the specified number of epochs
+        if (numGenerations > 1) 
+            _epochs_per_generation = std::max(1, (int) std::ceil(numRememberedEpochs / (numGenerations-1.0)));
+    }
 
     void update(int index, int volume) {
         if (index == _last_index && volume == _last_volume) return;
@@ -71,6 +100,23 @@ public:
     bool passClause(Mallob::Clause& clause, int epoch) {
 
         size_t hash = ClauseHasher::hash(clause, /*which=*/3);
+        _stats.numQueries++;
+
+        if (_approx_filter) {
+            advanceGenerations(epoch);
+            // The responsibility depends on the commutative hash, so a different
+            // hash is used for the filter to spread the clauses over all blocks
+            size_t filterHash = Mallob::nonCommutativeHash(clause.begin, clause.size, /*which=*/1);
+            if (_approx_filter->contains(filterHash)) {
+                _stats.numFiltered++;
+                return false;
+            }
+            if (isResponsibleFor(hash)) {
+                _approx_filter->insert(filterHash);
+                _stats.numRegistered++;
+            }
+            return true;
+        }
 
         auto it = _filter.find(clause);
         bool contained = it != _filter.end();
@@ -83,7 +129,10 @@ public:
         }
 
         // Already contained: clause does not pass.
-        if (contained) return false;
+        if (contained) {
+            _stats.numFiltered++;
+            return false;
+        }
 
         // Am I responsible for this clause?
         if (isResponsibleFor(hash) && !contained) {
@@ -91,6 +140,7 @@ public:
             copy.begin = (int*) malloc(sizeof(int)*clause.size);
             memcpy(copy.begin, clause.begin, sizeof(int)*clause.size);
             _filter[copy] = epoch; // register
+            _stats.numRegistered++;
         }
 
         return true; // no duplicate was found: success
@@ -121,10 +171,38 @@ public:
     }
 
     size_t size() const {
-        return _filter.size();
+        return _approx_filter ? _approx_filter->getNumInsertions() : _filter.size();
+    }
+
+    size_t getMemoryBytes() const {
+        if (_approx_filter) return _approx_filter->getMemoryBytes();
+        size_t bytes = _filter.size() * (sizeof(Mallob::Clause) + sizeof(int));
+        for (auto& [c, val] : _filter) bytes += c.size * sizeof(int);
+        return bytes;
+    }
+
+    const Statistics& getStatistics() const {
+        return _stats;
+    }
+
+    std::string getReport() const {
+        return "qry:" + std::to_string(_stats.numQueries) 
+            + " flt:" + std::to_string(_stats.numFiltered)
+            + " reg:" + std::to_string(_stats.numRegistered)
+            + " size:" + std::to_string(size())
+            + " mem:" + std::to_string(getMemoryBytes())
+            + (_approx_filter ? " fpr:" + std::to_string(_approx_filter->getEstimatedFalsePositiveRate()) : "");
     }
 
 private:
+    void advanceGenerations(int epoch) {
+        int numAdvances = (epoch - _approx_generation_epoch) / _epochs_per_generation;
+        if (numAdvances <= 0 || _approx_filter->getNumGenerations() == 1) return;
+        numAdvances = std::min(numAdvances, (int) _approx_filter->getNumGenerations());
+        for (int i = 0; i < numAdvances; i++) _approx_filter->advanceGeneration();
+        _approx_generation_epoch = epoch - (epoch - _approx_generation_epoch) % _epochs_per_generation;
+    }
+
     int getSlotIndex(int treeIndex, int volume) {
 
         int powerOfTwoVolume = 1;
@@ -37,15 +37,19 @@ void ForkedSatJob::doStartSolver() {
     const JobDescription& desc = getDescription();
     // do not copy the entire job description if the spawned job is an empty dummy
     bool dummyJob = config.threads == 0; 
+    // the payload may still be arriving: it is handed to the solver once it is complete
+    bool complete = !hasIncompleteDescription();
 
     _solver.reset(new SatProcessAdapter(
         std::move(hParams), std::move(config), this,
         dummyJob ? std::min(1ul, desc.getFormulaPayloadSize(0)) : desc.getFormulaPayloadSize(0), 
-        desc.getFormulaPayload(0), 
+        complete ? desc.getFormulaPayload(0) : nullptr, 
         dummyJob ? std::min(1ul, desc.getAssumptionsSize(0)) : desc.getAssumptionsSize(0),
-        desc.getAssumptionsPayload(0),
+        complete ? desc.getAssumptionsPayload(0) : nullptr,
         (AnytimeSatClauseCommunicator*)_clause_comm
     ));
+    HostDescriptionStore::Reference ref;
+    if (complete && !dummyJob && getHostStoreReference(0, ref)) _solver->setInitialRevisionHostStoreReference(ref);
     loadIncrements();
 
     //log(V5_DEBG, "%s : beginning to solve\n", toStr());
@@ -68,13 +72,17 @@ void ForkedSatJob::loadIncrements() {
         size_t numAssumptions = desc.getAssumptionsSize(_last_imported_revision);
         LOG(V4_VVER, "%s : Forward rev. %i : %i lits, %i assumptions\n", toStr(), 
                 _last_imported_revision, numLits, numAssumptions);
+        HostDescriptionStore::Reference hostStoreRef;
+        bool inHostStore = getHostStoreReference(_last_imported_revision, hostStoreRef);
         revisions.emplace_back(SatProcessAdapter::RevisionData {
             _last_imported_revision,
             _last_imported_revision == lastRev ? desc.getChecksum() : Checksum(),
             numLits, 
             desc.getFormulaPayload(_last_imported_revision),
             numAssumptions,
-            desc.getAssumptionsPayload(_last_imported_revision)
+            desc.getAssumptionsPayload(_last_imported_revision),
+            inHostStore,
+            hostStoreRef
         });
     }
     if (!revisions.empty()) {
@@ -84,6 +92,25 @@ void ForkedSatJob::loadIncrements() {
     }
 }
 
+void ForkedSatJob::appl_completeDescription() {
+    if (!_solver) return;
+    const auto& desc = getDescription();
+    HostDescriptionStore::Reference ref;
+    bool inHostStore = _solver->getStartedNumThreads() > 0 && getHostStoreReference(0, ref);
+    _solver->completeInitialRevision(desc.getFormulaPayload(0), desc.getAssumptionsPayload(0), 
+        inHostStore, ref);
+}
+
+bool ForkedSatJob::getHostStoreReference(int revision, HostDescriptionStore::Reference& ref) {
+    if (!HostDescriptionStore::holds(getId(), revision)) return false;
+    const auto& desc = getDescription();
+    const uint8_t* begin = desc.getSerializationBegin(revision);
+    ref = HostDescriptionStore::getReference(getId(), revision, 
+        (const uint8_t*) desc.getFormulaPayload(revision) - begin,
+        (const uint8_t*) desc.getAssumptionsPayload(revision) - begin);
+    return true;
+}
+
 void ForkedSatJob::appl_suspend() {
     if (!_initialized) return;
     _solver->setSolvingState(SolvingStates::SUSPENDED);
@@ -144,6 +171,7 @@ JobResult&& ForkedSatJob::appl_getResult() {
 void ForkedSatJob::appl_dumpStats() {
     if (!_initialized || getState() != ACTIVE) return;
     _solver->dumpStats();
+    if (checkClauseComm()) ((AnytimeSatClauseCommunicator*) _clause_comm)->dumpStats();
 }
 
 bool ForkedSatJob::appl_isDestructible() {
@@ -53,6 +53,9 @@ public:
     bool appl_isDestructible() override;
     void appl_memoryPanic() override;
 
+    bool appl_canStartWithIncompleteDescription() const override {return true;}
+    void appl_completeDescription() override;
+
     // Methods that are not overridden, but use the default implementation:
     // int getDemand(int prevVolume) const override;
     // bool wantsToCommunicate() const override;
@@ -78,6 +81,7 @@ private:
 
     bool checkClauseComm();
     void loadIncrements();
+    bool getHostStoreReference(int revision, HostDescriptionStore::Reference& ref);
     void startDestructThreadIfNecessary();
 
 };
@@ -26,7 +26,7 @@
 SatProcessAdapter::SatProcessAdapter(Parameters&& params, SatProcessConfig&& config, ForkedSatJob* job,
     size_t fSize, const int* fLits, size_t aSize, const int* aLits, AnytimeSatClauseCommunicator* comm) :    
         _params(std::move(params)), _config(std::move(config)), _job(job), _clause_comm(comm),
-        _f_size(fSize), _f_lits(fLits), _a_size(aSize), _a_lits(aLits) {
+        _f_size(fSize), _f_lits(fLits), _a_size(aSize), _a_lits(aLits), _initial_rev_complete(fLits != nullptr) {
 
     _desired_revision = _config.firstrev;
     _shmem_id = _config.getSharedMemId(Proc::getPid());
@@ -48,8 +48,8 @@ void SatProcessAdapter::doWriteRevisions() {
             auto revStr = std::to_string(revData.revision);
             createSharedMemoryBlock("fsize."       + revStr, sizeof(size_t),              (void*)&revData.fSize);
             createSharedMemoryBlock("asize."       + revStr, sizeof(size_t),              (void*)&revData.aSize);
-            createSharedMemoryBlock("formulae."    + revStr, sizeof(int) * revData.fSize, (void*)revData.fLits);
-            createSharedMemoryBlock("assumptions." + revStr, sizeof(int) * revData.aSize, (void*)revData.aLits);
+            writeRevisionPayload(revData.revision, revData.fSize, revData.fLits, revData.aSize, revData.aLits,
+                revData.inHostStore, revData.hostStoreRef);
             createSharedMemoryBlock("checksum."    + revStr, sizeof(Checksum),            (void*)&(revData.checksum));
             _written_revision = revData.revision;
             LOG(V4_VVER, "DBG Done writing next revision %i\n", revData.revision);
@@ -67,6 +67,20 @@ void SatProcessAdapter::doWriteRevisions() {
     _revisions_mutex.unlock();
 }
 
+void SatProcessAdapter::setInitialRevisionHostStoreReference(const HostDescriptionStore::Reference& ref) {
+    _initial_rev_in_host_store = true;
+    _initial_rev_host_store_ref = ref;
+}
+
+void SatProcessAdapter::completeInitialRevision(const int* fLits, const int* aLits, 
+        bool inHostStore, const HostDescriptionStore::Reference& hostStoreRef) {
+    _f_lits = fLits;
+    _a_lits = aLits;
+    _initial_rev_in_host_store = inHostStore;
+    _initial_rev_host_store_ref = hostStoreRef;
+    _initial_rev_complete.store(true, std::memory_order_release);
+}
+
 void SatProcessAdapter::run() {
     _running = true;
     _bg_initializer = ProcessWideThreadPool::get().addTask(
@@ -127,10 +141,6 @@ void SatProcessAdapter::doInitialize() {
     _returned_buffer = (int*) createSharedMemoryBlock("returnedclauses",
             sizeof(int)*_hsm->importBufferMaxSize, nullptr);
 
-    // Allocate shared memory for formula, assumptions of initial revision
-    createSharedMemoryBlock("formulae.0", sizeof(int) * _f_size, (void*)_f_lits);
-    createSharedMemoryBlock("assumptions.0", sizeof(int) * _a_size, (void*)_a_lits);
-
     if (_terminate) return;
 
     // FORK: Create a child process
@@ -161,13 +171,35 @@ void SatProcessAdapter::doInitialize() {
     //int i = 0;
     //delete[] ((const char**) argv);
 
+    {
+        auto lock = _state_mutex.getLock();
+        _child_pid = res;
+    }
+
+    // The child sets up its solver engine while the initial revision's payload
+    // is still being received, if applicable, and while it is written here
+    while (!_initial_rev_complete.load(std::memory_order_acquire)) {
+        {
+            auto lock = _state_mutex.getLock();
+            if (_terminate || _state == SolvingStates::ABORTING) break;
+        }
+        usleep(1000);
+    }
+    bool complete = _initial_rev_complete.load(std::memory_order_acquire);
+    // Allocate shared memory for formula, assumptions of initial revision
+    if (complete) writeRevisionPayload(0, _f_size, _f_lits, _a_size, _a_lits, 
+        _initial_rev_in_host_store, _initial_rev_host_store_ref);
+
     {
         auto lock = _state_mutex.getLock();
         _initialized = true;
+        // Without a payload, the child can only terminate
+        if (!complete) _hsm->doTerminate = true;
         _hsm->doBegin = true;
-        _child_pid = res;
         applySolvingState();
+        _hsm->childDoorbell.ring();
     }
+    if (complete) LOG(V4_VVER, "%s : subprocess begins solving\n", _job->toStr());
 }
 
 bool SatProcessAdapter::hasClauseComm() {
@@ -202,6 +234,7 @@ void SatProcessAdapter::applySolvingState() {
         _hsm->doTerminate = true; // Kindly ask child process to terminate.
         _hsm->doBegin = true; // Let child process know termination even if it waits for first revision
         Process::resume(_child_pid); // Continue (resume) process.
+        _hsm->childDoorbell.ring();
     }
     if (_state == SolvingStates::SUSPENDED || _state == SolvingStates::STANDBY) {
         Process::suspend(_child_pid); // Stop (suspend) process.
@@ -215,8 +248,9 @@ void SatProcessAdapter::collectClauses(int maxSize) {
     if (!_initialized) return;
     if (_hsm->doExport || _hsm->didExport) return;
     _hsm->exportBufferMaxSize = maxSize;
+    request(SatSharedMemory::STAGE_EXPORT);
     _hsm->doExport = true;
-    if (_hsm->isInitialized) Process::wakeUp(_child_pid);
+    _hsm->childDoorbell.ring();
 }
 bool SatProcessAdapter::hasCollectedClauses() {
     return !_initialized || (_hsm->doExport && _hsm->didExport);
@@ -227,6 +261,7 @@ std::vector<int> SatProcessAdapter::getCollectedClauses() {
     assert(_hsm->exportBufferTrueSize <= _hsm->exportBufferAllocatedSize);
     std::vector<int> clauses(_export_buffer, _export_buffer+_hsm->exportBufferTrueSize);
     _last_admitted_clause_share = std::pair<int, int>(_hsm->lastNumAdmittedClausesToImport, _hsm->lastNumClausesToImport);
+    recordResponse(SatSharedMemory::STAGE_EXPORT);
     _hsm->doExport = false;
     return clauses;
 }
@@ -245,10 +280,12 @@ bool SatProcessAdapter::process(const std::vector<int>& buffer, BufferTask task)
         _hsm->importBufferRevision = _desired_revision;
         assert(_hsm->importBufferSize <= _hsm->importBufferMaxSize);
         memcpy(_import_buffer, buffer.data(), buffer.size()*sizeof(int));
+        request(SatSharedMemory::STAGE_FILTER);
         _hsm->doFilterImport = true;
 
     } else if (task == APPLY_FILTER) {
         memcpy(_filter_buffer, buffer.data(), buffer.size()*sizeof(int));
+        request(SatSharedMemory::STAGE_DIGEST);
         _hsm->doDigestImportWithFilter = true;
 
     } else if (task == DIGEST_WITHOUT_FILTER) {
@@ -256,10 +293,11 @@ bool SatProcessAdapter::process(const std::vector<int>& buffer, BufferTask task)
         _hsm->importBufferRevision = _desired_revision;
         assert(_hsm->importBufferSize <= _hsm->importBufferMaxSize);
         memcpy(_import_buffer, buffer.data(), buffer.size()*sizeof(int));
+        request(SatSharedMemory::STAGE_DIGEST);
         _hsm->doDigestImportWithoutFilter = true;
     }
 
-    if (_hsm->isInitialized) Process::wakeUp(_child_pid);
+    _hsm->childDoorbell.ring();
     return true;
 }
 
@@ -285,6 +323,7 @@ std::vector<int> SatProcessAdapter::getLocalFilter() {
     std::vector<int> filter;
     filter.resize(_hsm->filterSize);
     memcpy(filter.data(), _filter_buffer, _hsm->filterSize*sizeof(int));
+    recordResponse(SatSharedMemory::STAGE_FILTER);
     _hsm->doFilterImport = false;
     return filter;
 }
@@ -303,14 +342,46 @@ void SatProcessAdapter::doReturnClauses(const std::vector<int>& clauses) {
     _hsm->returnedBufferSize = clauses.size();
     memcpy(_returned_buffer, clauses.data(),
         std::min((size_t)_hsm->importBufferMaxSize, clauses.size()) * sizeof(int));
+    request(SatSharedMemory::STAGE_RETURN);
     _hsm->doReturnClauses = true;
-    if (_hsm->isInitialized) Process::wakeUp(_child_pid);
+    _hsm->childDoorbell.ring();
 }
 
 void SatProcessAdapter::dumpStats() {
     if (!_initialized) return;
     _hsm->doDumpStats = true;
     // No hard need to wake up immediately
+
+    LOG(V3_VERB, "%s shmem_rtt_us exp:%s flt:%s dig:%s ret:%s\n", _job->toStr(),
+        _stage_latencies[SatSharedMemory::STAGE_EXPORT].getReport().c_str(),
+        _stage_latencies[SatSharedMemory::STAGE_FILTER].getReport().c_str(),
+        _stage_latencies[SatSharedMemory::STAGE_DIGEST].getReport().c_str(),
+        _stage_latencies[SatSharedMemory::STAGE_RETURN].getReport().c_str());
+}
+
+void SatProcessAdapter::request(SatSharedMemory::Stage stage) {
+    _hsm->stageRequestTime[stage] = Doorbell::getTimestampNanos();
+}
+
+void SatProcessAdapter::recordResponse(SatSharedMemory::Stage stage) {
+    uint64_t now = Doorbell::getTimestampNanos();
+    uint64_t requestTime = _hsm->stageRequestTime[stage];
+    uint64_t responseTime = _hsm->stageResponseTime[stage];
+    if (requestTime == 0 || responseTime < requestTime) return;
+    auto& lat = _stage_latencies[stage];
+    double responseMicros = 0.001 * (responseTime - requestTime);
+    lat.numResponses++;
+    lat.sumResponseMicros += responseMicros;
+    lat.maxResponseMicros = std::max(lat.maxResponseMicros, responseMicros);
+    lat.sumObservedMicros += 0.001 * (now - requestTime);
+}
+
+std::string SatProcessAdapter::StageLatencies::getReport() const {
+    if (numResponses == 0) return "-";
+    char buf[128];
+    snprintf(buf, 128, "%i/%.1f/%.1f/%.1f", numResponses, sumResponseMicros/numResponses, 
+        maxResponseMicros, sumObservedMicros/numResponses);
+    return std::string(buf);
 }
 
 SatProcessAdapter::SubprocessStatus SatProcessAdapter::check() {
@@ -330,10 +401,13 @@ SatProcessAdapter::SubprocessStatus SatProcessAdapter::check() {
 
     doWriteRevisions();
 
+    if (_hsm->didReturnClauses && _hsm->doReturnClauses) recordResponse(SatSharedMemory::STAGE_RETURN);
     if (_hsm->didReturnClauses)     _hsm->doReturnClauses     = false;
     if (_hsm->didStartNextRevision) _hsm->doStartNextRevision = false;
     if (_hsm->didDumpStats)         _hsm->doDumpStats         = false;
     if (_hsm->didDigestImport) {
+        if (_hsm->doDigestImportWithFilter || _hsm->doDigestImportWithoutFilter) 
+            recordResponse(SatSharedMemory::STAGE_DIGEST);
         _hsm->doDigestImportWithFilter = false;
         _hsm->doDigestImportWithoutFilter = false;
     }
@@ -344,6 +418,7 @@ SatProcessAdapter::SubprocessStatus SatProcessAdapter::check() {
         _published_revision++;
         _hsm->desiredRevision = _desired_revision;
         _hsm->doStartNextRevision = true;
+        _hsm->childDoorbell.ring();
     }
 
     if (!_pending_tasks.empty() && process(_pending_tasks.front().first, _pending_tasks.front().second)) {
@@ -428,6 +503,18 @@ void* SatProcessAdapter::createSharedMemoryBlock(std::string shmemSubId, size_t
     return shmem;
 }
 
+void SatProcessAdapter::writeRevisionPayload(int revision, size_t fSize, const int* fLits, size_t aSize, const int* aLits,
+        bool inHostStore, const HostDescriptionStore::Reference& hostStoreRef) {
+    auto revStr = std::to_string(revision);
+    if (inHostStore) {
+        // Only tell the subprocess where to find the host's copy of the revision
+        createSharedMemoryBlock("descref." + revStr, sizeof(HostDescriptionStore::Reference), (void*)&hostStoreRef);
+        return;
+    }
+    createSharedMemoryBlock("formulae."    + revStr, sizeof(int) * fSize, (void*)fLits);
+    createSharedMemoryBlock("assumptions." + revStr, sizeof(int) * aSize, (void*)aLits);
+}
+
 void SatProcessAdapter::crash() {
     _hsm->doCrash = true;
 }
@@ -12,6 +12,7 @@
 #include "data/checksum.hpp"
 #include "util/sys/background_worker.hpp"
 #include "data/job_result.hpp"
+#include "data/host_description_store.hpp"
 
 class ForkedSatJob; // fwd
 class AnytimeSatClauseCommunicator;
@@ -26,6 +27,10 @@ public:
         const int* fLits;
         size_t aSize;
         const int* aLits;
+        // If set, the subprocess maps the revision from the host description store
+        // instead of receiving a copy of it
+        bool inHostStore = false;
+        HostDescriptionStore::Reference hostStoreRef;
     };
 
 private:
@@ -40,6 +45,9 @@ private:
     const int* _f_lits;
     size_t _a_size;
     const int* _a_lits;
+    bool _initial_rev_in_host_store = false;
+    HostDescriptionStore::Reference _initial_rev_host_store_ref;
+    std::atomic_bool _initial_rev_complete;
     
     struct ShmemObject {
         std::string id; 
@@ -90,17 +98,34 @@ private:
     Mutex _revisions_mutex;
     Mutex _state_mutex;
 
+    // Latencies of the request/response stages with the child process
+    struct StageLatencies {
+        int numResponses = 0;
+        double sumResponseMicros = 0; // until the child's response was ready
+        double maxResponseMicros = 0;
+        double sumObservedMicros = 0; // until the response was noticed here
+        std::string getReport() const;
+    };
+    StageLatencies _stage_latencies[SatSharedMemory::NUM_STAGES];
+
     bool _solution_in_preparation = false;
     int _solution_revision_in_preparation = -1;
     JobResult _solution;
     std::future<void> _solution_prepare_future;
 
 public:
+    // If the payload of the initial revision is still being received, fLits and aLits
+    // are nullptr: the subprocess is set up meanwhile and begins to solve only
+    // after completeInitialRevision() has been called.
     SatProcessAdapter(Parameters&& params, SatProcessConfig&& config, ForkedSatJob* job, 
         size_t fSize, const int* fLits, size_t aSize, const int* aLits,
         AnytimeSatClauseCommunicator* comm = nullptr);
     ~SatProcessAdapter();
 
+    // Must be called before run()
+    void setInitialRevisionHostStoreReference(const HostDescriptionStore::Reference& ref);
+    void completeInitialRevision(const int* fLits, const int* aLits, 
+        bool inHostStore, const HostDescriptionStore::Reference& hostStoreRef);
     void run();
     bool isFullyInitialized();
     void appendRevisions(const std::vector<RevisionData>& revisions, int desiredRevision);
@@ -143,8 +168,12 @@ private:
     bool process(const std::vector<int>& clauses, BufferTask task);
     
     void applySolvingState();
+    void request(SatSharedMemory::Stage stage);
+    void recordResponse(SatSharedMemory::Stage stage);
     void doReturnClauses(const std::vector<int>& clauses);
     void initSharedMemory(SatProcessConfig&& config);
     void* createSharedMemoryBlock(std::string shmemSubId, size_t size, void* data);
+    void writeRevisionPayload(int revision, size_t fSize, const int* fLits, size_t aSize, const int* aLits,
+        bool inHostStore, const HostDescriptionStore::Reference& hostStoreRef);
 
 };
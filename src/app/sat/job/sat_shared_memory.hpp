@@ -5,12 +5,23 @@
 
 #include "../solvers/portfolio_solver_interface.hpp"
 #include "data/checksum.hpp"
+#include "util/sys/doorbell.hpp"
 #include "sat_process_config.hpp"
 
 struct SatSharedMemory {
 
     SatProcessConfig config;
 
+    // Rung by the parent whenever it issues an instruction to the child
+    Doorbell childDoorbell;
+
+    // Request/response stages which are instrumented for their latency:
+    // The parent writes a time stamp when issuing a request and the child
+    // writes a time stamp when its response is ready (see Doorbell::getTimestampNanos).
+    enum Stage {STAGE_EXPORT, STAGE_FILTER, STAGE_DIGEST, STAGE_RETURN, NUM_STAGES};
+    uint64_t stageRequestTime[NUM_STAGES];
+    uint64_t stageResponseTime[NUM_STAGES];
+
     // Meta data parent->child
     int fSize;
     int aSize;
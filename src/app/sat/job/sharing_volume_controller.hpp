@@ -0,0 +1,100 @@
+
+#pragma once
+
+#include <algorithm>
+#include <string>
+
+// Feedback controller for the clause sharing volume of a job, evaluated at the
+// job's root after each sharing epoch. The resulting factor scales all clause
+// buffer limits of the next epoch and is distributed along with its initiation.
+// The factor is composed of two parts:
+// - A compensation for clauses which are filtered as duplicates: If only a
+//   share r of the broadcast clauses is admitted, the volume is scaled by 1/r
+//   (within [1, maxCompensation]) so that the admitted volume stays stable.
+// - A capacity factor adjusted in an AIMD fashion: If a sharing epoch takes
+//   longer than the target latency (i.e., the bandwidth of the job tree is
+//   exhausted), the capacity is decreased multiplicatively. If the final buffer
+//   is (nearly) full and clauses were left behind during merging (i.e., the
+//   solvers produce more than is shared), the capacity is increased additively.
+//   If the buffer remains mostly empty, the capacity slowly decays.
+class SharingVolumeController {
+
+public:
+    struct Observation {
+        int numBroadcastClauses;
+        int numAdmittedClauses;
+        float fillRatio; // size of the final buffer relative to its limit
+        bool leftClausesBehind; // merging produced excess clauses
+        float latency; // seconds from initiating to concluding the epoch
+    };
+
+private:
+    const float _min_factor;
+    const float _max_factor;
+    const float _max_compensation;
+    const float _target_latency;
+
+    static constexpr float SMOOTHING = 0.6;
+    static constexpr float CAPACITY_INCREASE = 0.1;
+    static constexpr float CAPACITY_DECREASE = 0.8;
+    static constexpr float CAPACITY_DECAY = 0.98;
+
+    float _capacity {1};
+    float _compensation {1};
+    float _factor {1};
+
+    // Smoothed signals
+    float _admitted_ratio {1};
+    float _fill_ratio {0};
+    float _latency {0};
+    int _num_observations {0};
+
+public:
+    SharingVolumeController(float minFactor, float maxFactor, float maxCompensation, float targetLatency) :
+        _min_factor(minFactor), _max_factor(maxFactor),
+        _max_compensation(std::max(1.f, maxCompensation)), _target_latency(targetLatency) {}
+
+    void update(const Observation& obs) {
+
+        float admittedRatio = obs.numBroadcastClauses == 0 ? 1 :
+            (float) obs.numAdmittedClauses / obs.numBroadcastClauses;
+        admittedRatio = std::max(0.01f, admittedRatio);
+        smooth(_admitted_ratio, admittedRatio);
+        smooth(_fill_ratio, obs.fillRatio);
+        smooth(_latency, obs.latency);
+
+        // Compensation for filtered clauses
+        float compensation = std::max(1.f, std::min(_max_compensation, 1.f/admittedRatio));
+        smooth(_compensation, compensation);
+        _num_observations++;
+
+        // Capacity: react to the current epoch's latency directly (not smoothed)
+        if (_target_latency > 0 && obs.latency > _target_latency) {
+            _capacity *= CAPACITY_DECREASE;
+        } else if (obs.fillRatio >= 0.95 && obs.leftClausesBehind) {
+            _capacity += CAPACITY_INCREASE;
+        } else if (_fill_ratio < 0.5) {
+            _capacity *= CAPACITY_DECAY;
+        }
+        _capacity = std::max(_min_factor, std::min(_max_factor, _capacity));
+
+        _factor = std::max(_min_factor, std::min(_max_factor, _capacity * _compensation));
+    }
+
+    float getVolumeFactor() const {return _factor;}
+
+    std::string getReport() const {
+        return "fac:" + std::to_string(_factor)
+            + " cap:" + std::to_string(_capacity)
+            + " cmp:" + std::to_string(_compensation)
+            + " adm:" + std::to_string(_admitted_ratio)
+            + " fill:" + std::to_string(_fill_ratio)
+            + " lat:" + std::to_string(_latency)
+            + " n:" + std::to_string(_num_observations);
+    }
+
+private:
+    void smooth(float& val, float obs) {
+        val = _num_observations == 0 ? obs : SMOOTHING * val + (1-SMOOTHING) * obs;
+    }
+};
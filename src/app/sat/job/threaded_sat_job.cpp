@@ -120,6 +120,7 @@ void ThreadedSatJob::appl_dumpStats() {
     if (!_initialized || getState() != ACTIVE) return;
 
     getSolver()->dumpStats(/*final=*/false);
+    if (_clause_comm != nullptr) ((AnytimeSatClauseCommunicator*) _clause_comm)->dumpStats();
     if (_time_of_start_solving <= 0) return;
     
     std::vector<long> threadTids = getSolver()->getSolverTids();
@@ -15,6 +15,10 @@ AdaptiveClauseDatabase::AdaptiveClauseDatabase(Setup setup):
     // Choose max. sum such that the largest legal clauses will be admitted iff they have LBD 2. 
     int maxSumOfLengthAndLbd = setup.maxClauseLength+2;
 
+    // Each slot may recycle as many arena chunks as it would need to hold the entire literal budget
+    const size_t chunkCapacity = std::max(ARENA_CHUNK_SIZE, setup.maxClauseLength+2);
+    const size_t maxPooledChunks = 1 + setup.numLiterals / chunkCapacity;
+
     // Iterate over all possible clause length - LBD combinations
     for (int clauseLength = 1; clauseLength <= setup.maxClauseLength; clauseLength++) {
         for (int lbd = std::min(clauseLength, 2); lbd <= clauseLength; lbd++) {
@@ -47,15 +51,21 @@ AdaptiveClauseDatabase::AdaptiveClauseDatabase(Setup setup):
                     slotIdx = -2;
                     _unit_slot.implicitLbdOrZero = 1;
                     _unit_slot.mtx.reset(new Mutex());
+                    _unit_slot.arena = ClauseArena(1, 1, chunkCapacity, maxPooledChunks);
                 } else if (clauseLength == 2) {
                     slotIdx = -1;
                     _binary_slot.implicitLbdOrZero = 2;
                     _binary_slot.mtx.reset(new Mutex());
+                    _binary_slot.arena = ClauseArena(2, 2, chunkCapacity, maxPooledChunks);
                 } else {
                     slotIdx = _large_slots.size();
                     _large_slots.emplace_back();
                     _large_slots.back().implicitLbdOrZero = (opMode == SAME_SIZE_AND_LBD ? lbd : 0);
                     _large_slots.back().mtx.reset(new Mutex());
+                    _large_slots.back().arena = ClauseArena(
+                        opMode == SAME_SUM_OF_SIZE_AND_LBD ? 0 : clauseLength,
+                        _large_slots.back().implicitLbdOrZero, chunkCapacity, maxPooledChunks
+                    );
                 }
                 _size_lbd_to_slot_idx_mode[representantKey] = std::pair<int, ClauseSlotMode>(slotIdx, opMode);
             }
@@ -98,35 +108,17 @@ bool AdaptiveClauseDatabase::addClause(int* cBegin, int cSize, int cLbd, bool so
 
     // Budget has been acquired successfully
     _nb_used_literals.fetch_add(len, std::memory_order_relaxed);
-    
-    if (cSize == 1) {
-        _unit_slot.mtx->lock();
-        _unit_slot.list.push_front(*cBegin);
-        atomics::incrementRelaxed(_unit_slot.nbLiterals);
-        assert_heavy(checkNbLiterals(_unit_slot));
-        _unit_slot.mtx->unlock();
-    } else if (cSize == 2) {
-        _binary_slot.mtx->lock();
-        _binary_slot.list.emplace_front(cBegin[0], cBegin[1]);
-        atomics::addRelaxed(_binary_slot.nbLiterals, 2);
-        assert_heavy(checkNbLiterals(_binary_slot));
-        _binary_slot.mtx->unlock();
-    } else {
-        // Sort clause if necessary
-        if (sortLargeClause) std::sort(cBegin, cBegin+cSize);
-        // Insert clause
-        auto& slot = _large_slots.at(slotIdx);
-        bool explicitLbd = slot.implicitLbdOrZero == 0;
-        std::vector<int> vec(len + (explicitLbd ? 1 : 0));
-        size_t i = 0;
-        if (explicitLbd) vec[i++] = cLbd;
-        for (size_t j = 0; j < len; j++) vec[i++] = cBegin[j];
-        slot.mtx->lock();
-        slot.list.push_front(std::move(vec));
-        atomics::addRelaxed(slot.nbLiterals, cSize);
-        assert_heavy(checkNbLiterals(slot));
-        slot.mtx->unlock();
-    }
+
+    // Sort clause if necessary
+    if (cSize > 2 && sortLargeClause) std::sort(cBegin, cBegin+cSize);
+
+    // Insert clause
+    auto& slot = cSize == 1 ? _unit_slot : (cSize == 2 ? _binary_slot : _large_slots.at(slotIdx));
+    slot.mtx->lock();
+    slot.arena.push(cBegin, cSize, cLbd);
+    atomics::addRelaxed(slot.nbLiterals, cSize);
+    assert_heavy(checkNbLiterals(slot));
+    slot.mtx->unlock();
 
     return true;
 }
@@ -155,7 +147,7 @@ bool AdaptiveClauseDatabase::popFrontWeak(ExportMode mode, Mallob::Clause& out)
 
     if (popMallobClause(_binary_slot, /*giveUpOnLock=*/true, out)) return true;
 
-    for (int slotIdx = 0; slotIdx < _large_slots.size(); slotIdx++) {
+    for (size_t slotIdx = 0; slotIdx < _large_slots.size(); slotIdx++) {
         auto& slot = _large_slots[slotIdx];
         if (popMallobClause(slot, /*giveUpOnLock=*/true, out)) return true;
     }
@@ -163,8 +155,7 @@ bool AdaptiveClauseDatabase::popFrontWeak(ExportMode mode, Mallob::Clause& out)
     return false;
 }
 
-template <typename T>
-bool AdaptiveClauseDatabase::popMallobClause(Slot<T>& slot, bool giveUpOnLock, Mallob::Clause& out) {
+bool AdaptiveClauseDatabase::popMallobClause(Slot& slot, bool giveUpOnLock, Mallob::Clause& out) {
     if (slot.nbLiterals.load(std::memory_order_relaxed) == 0) return false;
     if (giveUpOnLock) {
         if (!slot.mtx->tryLock()) return false;
@@ -175,49 +166,28 @@ bool AdaptiveClauseDatabase::popMallobClause(Slot<T>& slot, bool giveUpOnLock, M
         slot.mtx->unlock();
         return false;
     }
-    assert(!slot.list.empty());
+    assert(!slot.arena.empty());
     int nbLiteralsBefore = slot.nbLiterals.load(std::memory_order_relaxed);
-    T packed = std::move(slot.list.front());
-    slot.list.pop_front();
-    auto mc = getMallobClause(packed, slot.implicitLbdOrZero);
+    out = slot.arena.back().copy(); // copy
+    slot.arena.popBack();
 
-    storeGlobalBudget(mc.size);
-    _nb_used_literals.fetch_sub(mc.size, std::memory_order_relaxed);
-    atomics::subRelaxed(slot.nbLiterals, mc.size);
+    storeGlobalBudget(out.size);
+    _nb_used_literals.fetch_sub(out.size, std::memory_order_relaxed);
+    atomics::subRelaxed(slot.nbLiterals, out.size);
 
-    assert_heavy(checkNbLiterals(slot, "popMallobClause(): " + mc.toStr() + "; " + std::to_string(nbLiteralsBefore) + " lits before"));
+    assert_heavy(checkNbLiterals(slot, "popMallobClause(): " + out.toStr() + "; " + std::to_string(nbLiteralsBefore) + " lits before"));
     slot.mtx->unlock();
-    out = mc.copy(); // copy
     return true;
 }
 
-template <typename T>
-Mallob::Clause AdaptiveClauseDatabase::getMallobClause(T& elem, int implicitLbdOrZero) {
-    if constexpr (std::is_same<int, T>::value) {
-        return Mallob::Clause(&elem, 1, 1);
-    }
-    if constexpr (std::is_same<std::pair<int, int>, T>::value) {
-        return Mallob::Clause(&elem.first, 2, 2);
-    }
-    if constexpr (std::is_same<std::vector<int>, T>::value) {
-        bool lbdInVector = implicitLbdOrZero == 0;
-        int len = elem.size() - (lbdInVector ? 1 : 0);
-        assert(len <= _max_clause_length);
-        return Mallob::Clause(elem.data() + (lbdInVector ? 1 : 0), len, 
-            lbdInVector ? elem[0] : implicitLbdOrZero);
-    }
-    abort();
-}
-
-template <typename T> 
-void AdaptiveClauseDatabase::flushClauses(Slot<T>& slot, bool sortClauses, BufferBuilder& builder) {
+void AdaptiveClauseDatabase::flushClauses(Slot& slot, bool sortClauses, BufferBuilder& builder) {
     
     if (slot.nbLiterals.load(std::memory_order_relaxed) == 0
         && slot.freeLocalBudget.load(std::memory_order_relaxed) == 0) 
         return;
     
-    // Swap current clause information in the slot to another list
-    std::forward_list<T> swappedSlot;
+    // Swap current clause information in the slot to another arena
+    ClauseArena swappedArena = slot.arena.emptyCopy();
     int nbSwappedLits;
     int litsToStore = 0;
     {
@@ -237,45 +207,29 @@ void AdaptiveClauseDatabase::flushClauses(Slot<T>& slot, bool sortClauses, Buffe
         }
         
         // Extract clauses
-        swappedSlot.swap(slot.list);
+        swappedArena.swap(slot.arena);
         nbSwappedLits = slot.nbLiterals.load(std::memory_order_relaxed);
         slot.nbLiterals.store(0, std::memory_order_relaxed);
     }
 
-    // Create clauses one by one
+    // Collect clauses (pointing into the swapped arena) one by one
     std::vector<Mallob::Clause> flushedClauses;
     int remainingLits = builder.getMaxRemainingLits();
     int collectedLits = 0;
-    auto itBefore = swappedSlot.before_begin();
-    auto it = swappedSlot.begin();
-    for (; it != swappedSlot.end(); ++it, ++itBefore) {
-        T& elem = *it;
-        Mallob::Clause clause = getMallobClause(elem, slot.implicitLbdOrZero);
-        if (clause.size > remainingLits) break;
-
-        // insert clause to export buffer
+    swappedArena.forEachFromBack([&](const Mallob::Clause& clause) {
+        if (clause.size > remainingLits) return false;
         remainingLits -= clause.size;
         collectedLits += clause.size;
-        flushedClauses.push_back(std::move(clause));
-    }
+        flushedClauses.push_back(clause);
+        return true;
+    });
+    size_t nbFlushedClauses = flushedClauses.size();
 
     // Return budget of extracted literals
     litsToStore += collectedLits;
     storeGlobalBudget(litsToStore);
     _nb_used_literals.fetch_sub(collectedLits, std::memory_order_relaxed);
 
-    if (it != swappedSlot.end()) {
-        // Re-insert swapped clauses which remained unused
-        auto lock = slot.mtx->getLock();
-        slot.list.splice_after(slot.list.before_begin(), swappedSlot, itBefore, swappedSlot.end());
-        atomics::addRelaxed(slot.nbLiterals, nbSwappedLits - collectedLits);
-        assert_heavy(checkNbLiterals(slot));
-    } else {
-        assert(nbSwappedLits == collectedLits || 
-            log_return_false("[ERROR] slot advertised %i lits, collected %i lits\n", 
-            nbSwappedLits, collectedLits));
-    }
-
     bool differentLbdValues = slot.implicitLbdOrZero == 0;
     if (differentLbdValues || sortClauses) {
         // Sort
@@ -288,6 +242,19 @@ void AdaptiveClauseDatabase::flushClauses(Slot<T>& slot, bool sortClauses, Buffe
         assert(success);
         //log(V2_INFO, "%i : EXPORTED %s\n", producedClause.producers, c.toStr().c_str());
     }
+
+    // Discard the exported clauses from the swapped arena, recycling its chunks
+    for (size_t i = 0; i < nbFlushedClauses; i++) swappedArena.popBack();
+
+    // Re-insert swapped clauses which remained unused as the slot's oldest clauses
+    // and hand the emptied chunks back to the slot for later use
+    assert(!swappedArena.empty() || nbSwappedLits == collectedLits || 
+        log_return_false("[ERROR] slot advertised %i lits, collected %i lits\n", 
+        nbSwappedLits, collectedLits));
+    auto lock = slot.mtx->getLock();
+    slot.arena.prependFrom(swappedArena);
+    atomics::addRelaxed(slot.nbLiterals, nbSwappedLits - collectedLits);
+    assert_heavy(checkNbLiterals(slot));
 }
 
 std::vector<int> AdaptiveClauseDatabase::exportBuffer(int totalLiteralLimit, int& numExportedClauses, 
@@ -315,7 +282,7 @@ std::vector<int> AdaptiveClauseDatabase::exportBuffer(int totalLiteralLimit, int
         flushClauses(_binary_slot, sortClauses, builder);
 
         // All other clauses.
-        for (int slotIdx = 0; slotIdx < _large_slots.size(); slotIdx++) {
+        for (size_t slotIdx = 0; slotIdx < _large_slots.size(); slotIdx++) {
             auto& slot = _large_slots[slotIdx];
             flushClauses(slot, sortClauses, builder);
         }
@@ -365,8 +332,7 @@ int AdaptiveClauseDatabase::tryAcquireBudget(int callingSlot, int numDesired, fl
     return numFreed;
 }
 
-template <typename T>
-int AdaptiveClauseDatabase::stealBudgetFromSlot(Slot<T>& slot, int desiredLiterals, bool dropClauses) {
+int AdaptiveClauseDatabase::stealBudgetFromSlot(Slot& slot, int desiredLiterals, bool dropClauses) {
     
     if (slot.nbLiterals.load(std::memory_order_relaxed) == 0
         && slot.freeLocalBudget.load(std::memory_order_relaxed) == 0) 
@@ -380,34 +346,20 @@ int AdaptiveClauseDatabase::stealBudgetFromSlot(Slot<T>& slot, int desiredLitera
     int nbCollectedLits = 0;
     int nbCollectedClauses = 0;
 
-    auto it = slot.list.begin();
     if (dropClauses) {
-        while (freeBudget + nbCollectedLits < desiredLiterals && it != slot.list.end()) {
-            if constexpr (std::is_same<int, T>::value) {
-                ++nbCollectedLits;
-                _hist_deleted_in_slots.increment(1);
-            }
-            if constexpr (std::is_same<std::pair<int, int>, T>::value) {
-                nbCollectedLits += 2;
-                _hist_deleted_in_slots.increment(2);
-            }
-            if constexpr (std::is_same<std::vector<int>, T>::value) {
-                int clslen = it->size() - (slot.implicitLbdOrZero==0 ? 1 : 0);
-                nbCollectedLits += clslen;
-                _hist_deleted_in_slots.increment(clslen);
-            }
+        // Drop the most recent clauses in place; emptied chunks are recycled
+        while (freeBudget + nbCollectedLits < desiredLiterals && !slot.arena.empty()) {
+            int clslen = slot.arena.back().size;
+            nbCollectedLits += clslen;
+            _hist_deleted_in_slots.increment(clslen);
+            slot.arena.popBack();
             nbCollectedClauses++;
-            ++it;
         }
     }
 
     if (freeBudget+nbCollectedLits == 0) {
         return 0;
     }
-
-    // Extract part of the list
-    std::forward_list<T> swappedList;
-    swappedList.splice_after(swappedList.before_begin(), slot.list, slot.list.before_begin(), it);
     
     atomics::subRelaxed(slot.nbLiterals, nbCollectedLits);
     atomics::subRelaxed(slot.freeLocalBudget, freeBudget);
@@ -418,12 +370,39 @@ int AdaptiveClauseDatabase::stealBudgetFromSlot(Slot<T>& slot, int desiredLitera
         + std::to_string(nbCollectedClauses) + " clauses; " 
         + std::to_string(nbLiteralsBefore) + " lits before"));
     
-    // Elements are cleaned up automatically
     return freeBudget + nbCollectedLits;
 }
 
-BufferReader AdaptiveClauseDatabase::getBufferReader(int* begin, size_t size, bool useChecksums) {
-    return BufferReader(begin, size, _max_clause_length, _slots_for_sum_of_length_and_lbd, useChecksums);
+BufferReader AdaptiveClauseDatabase::getBufferReader(int* begin, size_t size, bool useChecksums, bool compressed) {
+    return BufferReader(begin, size, _max_clause_length, _slots_for_sum_of_length_and_lbd, useChecksums, compressed);
+}
+
+std::vector<int> AdaptiveClauseDatabase::compressBuffer(const int* begin, size_t size) {
+    return CompressedClauseBuffer::compress(begin, size, _max_clause_length, _slots_for_sum_of_length_and_lbd);
+}
+
+std::vector<int> AdaptiveClauseDatabase::decompressBuffer(const int* begin, size_t size) {
+    return CompressedClauseBuffer::decompress(begin, size, _max_clause_length, _slots_for_sum_of_length_and_lbd);
+}
+
+std::vector<std::vector<int>> AdaptiveClauseDatabase::splitBuffer(int* begin, size_t size, int numSegments) {
+
+    std::vector<std::vector<int>> segments(numSegments);
+    std::vector<BufferBuilder> builders;
+    builders.reserve(numSegments);
+    for (auto& segment : segments) builders.emplace_back(-1, _max_clause_length, 
+        _slots_for_sum_of_length_and_lbd, &segment);
+
+    const int maxKey = _slots_for_sum_of_length_and_lbd ? 2*_max_clause_length : _max_clause_length;
+    auto reader = getBufferReader(begin, size);
+    Clause c = reader.getNextIncomingClause();
+    while (c.begin != nullptr) {
+        int key = _slots_for_sum_of_length_and_lbd ? c.size + c.lbd : c.size;
+        int segmentIdx = std::min(numSegments-1, ((key-1) * numSegments) / maxKey);
+        builders[segmentIdx].append(c);
+        c = reader.getNextIncomingClause();
+    }
+    return segments;
 }
 
 BufferMerger AdaptiveClauseDatabase::getBufferMerger(int sizeLimit) {
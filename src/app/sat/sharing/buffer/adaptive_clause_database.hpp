@@ -8,6 +8,7 @@
 
 #include "../../data/produced_clause.hpp"
 #include "bucket_label.hpp"
+#include "clause_arena.hpp"
 #include "buffer_reader.hpp"
 #include "buffer_merger.hpp"
 #include "util/periodic_event.hpp"
@@ -56,28 +57,30 @@ private:
         }
     };
 
+    // Number of integers per chunk of a slot's clause arena
+    static constexpr int ARENA_CHUNK_SIZE = 1024;
+
     int _total_literal_limit;
     std::atomic_int _nb_used_literals {0};
 
-    template <typename T>
     struct Slot {
         int implicitLbdOrZero;
         std::atomic_int nbLiterals {0};
         std::atomic_int freeLocalBudget {0};
         std::shared_ptr<Mutex> mtx;
-        std::forward_list<T> list;
+        ClauseArena arena;
         Slot() = default;
         Slot(Slot&& other) :
             implicitLbdOrZero(other.implicitLbdOrZero),
-            freeLocalBudget(other.freeLocalBudget.load(std::memory_order_relaxed)), 
             nbLiterals(other.nbLiterals.load(std::memory_order_relaxed)), 
+            freeLocalBudget(other.freeLocalBudget.load(std::memory_order_relaxed)), 
             mtx(std::move(other.mtx)),
-            list(other.list) {}
+            arena(std::move(other.arena)) {}
     };
 
-    Slot<int> _unit_slot;
-    Slot<std::pair<int, int>> _binary_slot;
-    std::vector<Slot<std::vector<int>>> _large_slots;
+    Slot _unit_slot;
+    Slot _binary_slot;
+    std::vector<Slot> _large_slots;
     
     enum ClauseSlotMode {SAME_SUM_OF_SIZE_AND_LBD, SAME_SIZE, SAME_SIZE_AND_LBD};
     robin_hood::unordered_flat_map<std::pair<int, int>, std::pair<int, ClauseSlotMode>, IntPairHasher> _size_lbd_to_slot_idx_mode;
@@ -153,33 +156,15 @@ public:
 
         atomics::addRelaxed(_nb_used_literals, nbLiterals);
         float timeInsert = Timer::elapsedSeconds();
-        T& clause = clauses.front();
-
-        if constexpr (std::is_same<T, int>::value) {
-            auto lock = _unit_slot.mtx->getLock();
-            _unit_slot.list.splice_after(_unit_slot.list.before_begin(), clauses);
-            atomics::addRelaxed(_unit_slot.nbLiterals, nbLiterals);
-            assert_heavy(checkNbLiterals(_unit_slot));
-        } else if constexpr (std::is_same<T, std::pair<int, int>>::value) {
-            auto lock = _binary_slot.mtx->getLock();
-            _binary_slot.list.splice_after(_binary_slot.list.before_begin(), clauses);
-            atomics::addRelaxed(_binary_slot.nbLiterals, nbLiterals);
-            assert_heavy(checkNbLiterals(_binary_slot));
-        } else if constexpr (std::is_same<T, std::vector<int>>::value) {
-            auto& slot = _large_slots[slotIdx];
-            if (slot.implicitLbdOrZero == 0) {
-                // Explicit LBD
-                assert(clause.size() == cSize+1);
-                assert(clause[0] == cLbd);
-            } else {
-                // Implicit LBD
-                assert(clause.size() == cSize);
-            }
-            auto lock = slot.mtx->getLock();
-            slot.list.splice_after(slot.list.before_begin(), clauses);
-            atomics::addRelaxed(slot.nbLiterals, nbLiterals);
-            assert_heavy(checkNbLiterals(slot));
-        }
+
+        auto& slot = cSize == 1 ? _unit_slot : (cSize == 2 ? _binary_slot : _large_slots[slotIdx]);
+        auto lock = slot.mtx->getLock();
+        slot.arena.pushAll(clauses, cSize, cLbd);
+        atomics::addRelaxed(slot.nbLiterals, nbLiterals);
+        assert_heavy(checkNbLiterals(slot));
+        lock.unlock();
+        // The provided clauses are consumed by this call
+        clauses.clear();
         timeInsert = Timer::elapsedSeconds() - timeInsert;
 
         LOG(V6_DEBGV, "DG (%i,%i) %.4fs free, %.4fs insert\n", cSize, cLbd, timeFree, timeInsert);
@@ -210,8 +195,23 @@ public:
     as exported by exportBuffer. Must have been created by an AdaptiveClauseDatabase
     or a BufferMerger with the same parametrization as this instance.
     Throughout the life time of the BufferReader, the underlying vector must be valid.
+    If compressed is set, the vector is expected in the format of compressBuffer.
+    */
+    BufferReader getBufferReader(int* begin, size_t size, bool useChecksums = false, bool compressed = false);
+    /*
+    Convert a flat buffer as exported by exportBuffer into the compact wire format
+    of CompressedClauseBuffer and back.
+    */
+    std::vector<int> compressBuffer(const int* begin, size_t size);
+    std::vector<int> decompressBuffer(const int* begin, size_t size);
+    /*
+    Split a flat buffer as exported by exportBuffer into numSegments flat buffers,
+    each of which covers a contiguous range of buckets: A clause is assigned to a
+    segment by its length (or, if slots are grouped by the sum of length and LBD,
+    by this sum), with each segment covering an equally wide range of values.
+    Merging the segments yields the original buffer again.
     */
-    BufferReader getBufferReader(int* begin, size_t size, bool useChecksums = false);
+    std::vector<std::vector<int>> splitBuffer(int* begin, size_t size, int numSegments);
     BufferMerger getBufferMerger(int sizeLimit);
     BufferBuilder getBufferBuilder(std::vector<int>* out = nullptr);
 
@@ -252,39 +252,25 @@ public:
     }
 
 private:
-    template <typename T>
-    bool checkNbLiterals(Slot<T>& slot, std::string additionalInfo = "") {
+    bool checkNbLiterals(Slot& slot, std::string additionalInfo = "") {
 
         int nbAdvertised = slot.nbLiterals.load(std::memory_order_relaxed);
         int nbActual = 0;
-        for (auto elem : slot.list) {
-            if constexpr (std::is_same<int, T>::value) {
-                nbActual++;
-            }
-            if constexpr (std::is_same<std::pair<int, int>, T>::value) {
-                nbActual += 2;
-            }
-            if constexpr (std::is_same<std::vector<int>, T>::value) {
-                nbActual += elem.size() - (slot.implicitLbdOrZero==0 ? 1:0);
-            }
-        }
+        slot.arena.forEachFromBack([&](const Mallob::Clause& c) {
+            nbActual += c.size;
+            return true;
+        });
         if (nbAdvertised != nbActual) 
             LOG(V0_CRIT, "[ERROR] Slot advertised %i literals - found %i literals (%s)\n", 
                 nbAdvertised, nbActual, additionalInfo.c_str());
         return nbAdvertised == nbActual;
     }
 
-    template <typename T>
-    bool popMallobClause(Slot<T>& slot, bool giveUpOnLock, Mallob::Clause& out);
+    bool popMallobClause(Slot& slot, bool giveUpOnLock, Mallob::Clause& out);
 
-    template <typename T>
-    Mallob::Clause getMallobClause(T& elem, int implicitLbdOrZero);
+    int stealBudgetFromSlot(Slot& slot, int desiredLiterals, bool dropClauses);
 
-    template <typename T>
-    int stealBudgetFromSlot(Slot<T>& slot, int desiredLiterals, bool dropClauses);
-
-    template <typename T>
-    void flushClauses(Slot<T>& slot, bool sortClauses, BufferBuilder& builder);
+    void flushClauses(Slot& slot, bool sortClauses, BufferBuilder& builder);
     
     std::pair<int, ClauseSlotMode> getSlotIdxAndMode(int clauseSize, int lbd);
     BucketLabel getBucketIterator();
@@ -1,108 +1,198 @@
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
 
 #include "buffer_merger.hpp"
+#include "util/sys/thread_pool.hpp"
+#include "util/sys/threading.hpp"
 
-BufferMerger::BufferMerger(int sizeLimit, int maxClauseLength, bool slotsForSumOfLengthAndLbd, bool useChecksum) : 
-    _size_limit(sizeLimit), _max_clause_length(maxClauseLength), 
+BufferMerger::BufferMerger(int sizeLimit, int maxClauseLength, bool slotsForSumOfLengthAndLbd, bool useChecksum) :
+    _size_limit(sizeLimit), _excess_size_limit(sizeLimit), _max_clause_length(maxClauseLength),
     _slots_for_sum_of_length_and_lbd(slotsForSumOfLengthAndLbd), _use_checksum(useChecksum) {}
 
 void BufferMerger::add(BufferReader&& reader) {_readers.push_back(std::move(reader));}
 
 std::vector<int> BufferMerger::merge(std::vector<int>* excessClauses) {
-    
-    AbstractClauseThreewayComparator* threewayCompare = _slots_for_sum_of_length_and_lbd ?
-        (AbstractClauseThreewayComparator*) new LengthLbdSumClauseThreewayComparator(_max_clause_length+2) :
-        (AbstractClauseThreewayComparator*) new LexicographicClauseThreewayComparator();
-    ClauseComparator compare(threewayCompare);
-    InputClauseComparator inputCompare(threewayCompare);
 
-    // Setup readers
-    for (size_t i = 0; i < _readers.size(); i++) {
-
-        // Fetch first clause of this reader
-        Clause* c = _readers[i].getCurrentClausePointer();
-        _readers[i].getNextIncomingClause();
-        if (c->begin == nullptr) continue;
-        InputClause inputClause(c, i);
-
-        // Insert clause into merger
-        if (_merger.empty()) _merger.insert_after(_merger.before_begin(), inputClause);
-        else {
-            auto it = _merger.before_begin(); 
-            auto nextIt = it; ++nextIt;
-            while (nextIt != _merger.end() && inputCompare(inputClause, *nextIt)) {
-                ++it;
-                ++nextIt;
-            }
-            _merger.insert_after(it, inputClause);
+    // Only split the merge if each sub-merge has at least two inputs
+    int numSubmerges = std::min(_num_parallel_submerges, (int) _readers.size() / 2);
+    std::vector<std::vector<int>> intermediateBuffers;
+    std::vector<BufferReader> intermediateReaders;
+    std::vector<BufferReader*> readers;
+    if (numSubmerges > 1) {
+        // Merge disjoint subsets of the inputs concurrently, then merge the results
+        intermediateBuffers = mergeSubsetsInParallel(numSubmerges);
+        for (auto& buf : intermediateBuffers) {
+            intermediateReaders.emplace_back(buf.data(), buf.size(),
+                _max_clause_length, _slots_for_sum_of_length_and_lbd, false);
         }
+        for (auto& reader : intermediateReaders) readers.push_back(&reader);
+    } else {
+        for (auto& reader : _readers) readers.push_back(&reader);
     }
 
     // Setup builders for main buffer and excess clauses buffer
     BufferBuilder mainBuilder(_size_limit, _max_clause_length, _slots_for_sum_of_length_and_lbd);
-    BufferBuilder* excessBuilder;
+    std::unique_ptr<BufferBuilder> excessBuilder;
     if (excessClauses != nullptr) {
-        excessBuilder = new BufferBuilder(_size_limit, _max_clause_length, _slots_for_sum_of_length_and_lbd);
+        excessBuilder.reset(new BufferBuilder(_excess_size_limit, _max_clause_length, _slots_for_sum_of_length_and_lbd));
+    }
+
+    mergeReaders(readers, mainBuilder, excessBuilder.get());
+    _num_merged_lits = mainBuilder.getNumAddedLits();
+    _num_excess_lits = excessBuilder ? excessBuilder->getNumAddedLits() : 0;
+
+    // Fill provided excess clauses buffer with result from according builder
+    if (excessClauses != nullptr) *excessClauses = excessBuilder->extractBuffer();
+    return mainBuilder.extractBuffer();
+}
+
+void BufferMerger::mergeReaders(std::vector<BufferReader*>& readers, BufferBuilder& mainBuilder, BufferBuilder* excessBuilder) {
+    // Dispatch to a merge routine with a statically known clause ordering
+    if (_slots_for_sum_of_length_and_lbd) {
+        mergeReaders(readers, LengthLbdSumClauseThreewayComparator(_max_clause_length+2), mainBuilder, excessBuilder);
+    } else {
+        mergeReaders(readers, LexicographicClauseThreewayComparator(), mainBuilder, excessBuilder);
+    }
+}
+
+template <typename Cmp>
+void BufferMerger::mergeReaders(std::vector<BufferReader*>& readers, const Cmp& compare,
+        BufferBuilder& mainBuilder, BufferBuilder* excessBuilder) {
+
+    // Current clause of each leaf (or nullptr if the leaf is exhausted)
+    size_t numLeaves = 1;
+    while (numLeaves < readers.size()) numLeaves *= 2;
+    std::vector<const Clause*> heads(numLeaves, nullptr);
+    for (size_t i = 0; i < readers.size(); i++) {
+        // Fetch first clause of this reader
+        Clause* c = readers[i]->getCurrentClausePointer();
+        readers[i]->getNextIncomingClause();
+        if (c->begin != nullptr) heads[i] = c;
+    }
+
+    // Does leaf i win against leaf j? Exhausted leaves lose against everything,
+    // and ties are broken in favor of the reader added first.
+    auto wins = [&](int i, int j) {
+        if (heads[i] == nullptr) return false;
+        if (heads[j] == nullptr) return true;
+        int res = compare.compare(*heads[i], *heads[j]);
+        if (res != 0) return res < 0;
+        return i < j;
+    };
+
+    // Build loser tree: Each inner node stores the loser of the match
+    // between the winners of its two subtrees; the overall winner is kept separately.
+    std::vector<int> losers(numLeaves);
+    int winner;
+    {
+        std::vector<int> winners(2*numLeaves);
+        for (size_t i = 0; i < numLeaves; i++) winners[numLeaves+i] = i;
+        for (size_t node = numLeaves-1; node >= 1; node--) {
+            int left = winners[2*node];
+            int right = winners[2*node+1];
+            bool leftWins = wins(left, right);
+            winners[node] = leftWins ? left : right;
+            losers[node] = leftWins ? right : left;
+        }
+        winner = winners[1];
     }
+
     BufferBuilder* currentBuilder = &mainBuilder;
 
-    // For checking duplicates
+    // For checking duplicates. A compressed reader decodes each clause into the
+    // same memory, so only its most recently returned clause stays valid:
+    // the last seen clause must be copied before its reader advances.
     Clause lastSeenClause;
+    bool copyLastSeenClause = false;
+    for (auto reader : readers) copyLastSeenClause |= reader->isCompressed();
+    std::vector<int> lastSeenLits(copyLastSeenClause ? _max_clause_length : 0);
 
     // Merge rounds
-    while (!_merger.empty()) {
+    while (heads[winner] != nullptr) {
+
+        const Clause& clause = *heads[winner];
 
-        // Fetch next best clause
-        auto& [clause, readerId] = _merger.front();
-        
         // Duplicate?
-        if (lastSeenClause.begin == nullptr || compare(lastSeenClause, *clause)) {
+        int res = lastSeenClause.begin == nullptr ? -1 : compare.compare(lastSeenClause, clause);
+        if (res < 0) {
             // -- not a duplicate
-            lastSeenClause = *clause;
+            lastSeenClause = clause;
+            if (copyLastSeenClause) {
+                std::copy(clause.begin, clause.begin+clause.size, lastSeenLits.begin());
+                lastSeenClause.begin = lastSeenLits.data();
+            }
 
             // Try to append to current builder
             bool success = currentBuilder->append(lastSeenClause);
-            if (!success && currentBuilder == &mainBuilder) {
+            if (!success && currentBuilder == &mainBuilder && excessBuilder != nullptr) {
                 // Switch from normal output to excess clauses output
                 currentBuilder = excessBuilder;
                 success = currentBuilder->append(lastSeenClause);
             }
         } else {
             // Duplicate!
-            assert(!compare(*clause, lastSeenClause) || 
-                log_return_false("ERROR: Clauses unordered - %s <-> %s\n", 
-                clause->toStr().c_str(), lastSeenClause.toStr().c_str()));
+            assert(res == 0 || log_return_false("ERROR: Clauses unordered - %s <-> %s\n",
+                clause.toStr().c_str(), lastSeenClause.toStr().c_str()));
         }
 
-        // Refill merger
-        _readers[readerId].getNextIncomingClause();
-        if (clause->begin == nullptr) {
-            // No clauses left for this reader
-            _merger.erase_after(_merger.before_begin());
-        } else {
-            // Insert clause at the correct position in the merger
-            auto it = _merger.begin(); 
-            auto nextIt = it; ++nextIt;
-            while (nextIt != _merger.end() && inputCompare(_merger.front(), *nextIt)) {
-                ++it;
-                ++nextIt;
-            }
-            if (it != _merger.begin()) {
-                // Move element
-                auto elem = _merger.front();
-                _merger.erase_after(_merger.before_begin());
-                _merger.insert_after(it, elem);
-            } // Else: element is already at the right place
+        // Refill winning leaf
+        readers[winner]->getNextIncomingClause();
+        if (heads[winner]->begin == nullptr) heads[winner] = nullptr;
+
+        // Replay the matches on the path from the leaf to the root
+        for (size_t node = (numLeaves+winner)/2; node >= 1; node /= 2) {
+            if (wins(losers[node], winner)) std::swap(losers[node], winner);
         }
     }
+}
 
-    // Fill provided excess clauses buffer with result from according builder
-    if (excessClauses != nullptr) {
-        *excessClauses = excessBuilder->extractBuffer();
-        delete excessBuilder;
-    }
+std::vector<std::vector<int>> BufferMerger::mergeSubsetsInParallel(int numSubmerges) {
+
+    // Shared state of all sub-merges. Sub-merges are claimed dynamically
+    // by the calling thread as well as by helper tasks in the thread pool.
+    // Since the caller processes any sub-merges not yet claimed by others,
+    // it never waits for a task which has not been started yet (which would
+    // risk a deadlock if the caller itself runs inside the thread pool).
+    struct Context {
+        std::vector<std::vector<int>> results;
+        std::atomic_int nextSubmerge {0};
+        int numDone {0};
+        Mutex mutex;
+        ConditionVariable condVar;
+    };
+    auto ctx = std::make_shared<Context>();
+    ctx->results.resize(numSubmerges);
+
+    auto work = [this, numSubmerges](Context& ctx) {
+        while (true) {
+            int idx = ctx.nextSubmerge.fetch_add(1, std::memory_order_relaxed);
+            if (idx >= numSubmerges) break;
+
+            // Sub-merge #idx covers a contiguous range of readers, which
+            // preserves the order of tie-breaking among the readers.
+            size_t begin = (idx * _readers.size()) / numSubmerges;
+            size_t end = ((idx+1) * _readers.size()) / numSubmerges;
+            std::vector<BufferReader*> readers;
+            for (size_t i = begin; i < end; i++) readers.push_back(&_readers[i]);
+            BufferBuilder builder(-1, _max_clause_length, _slots_for_sum_of_length_and_lbd);
+            mergeReaders(readers, builder, nullptr);
+            ctx.results[idx] = builder.extractBuffer();
+
+            auto lock = ctx.mutex.getLock();
+            ctx.numDone++;
+            ctx.condVar.notify();
+        }
+    };
 
-    delete threewayCompare;
-    return mainBuilder.extractBuffer();
+    for (int i = 1; i < numSubmerges; i++) {
+        ProcessWideThreadPool::get().addTask([ctx, work]() {work(*ctx);});
+    }
+    work(*ctx);
+    {
+        auto lock = ctx->mutex.getLock();
+        ctx->condVar.waitWithLockedMutex(lock, [&]() {return ctx->numDone == numSubmerges;});
+    }
+    return std::move(ctx->results);
 }
@@ -2,44 +2,58 @@
 #pragma once
 
 #include <vector>
-#include <set>
-#include <forward_list>
 
 #include "buffer_builder.hpp"
 #include "buffer_reader.hpp"
-#include "../filter/clause_filter.hpp" 
-
+#include "../filter/clause_filter.hpp"
+
+/*
+Merges a number of sorted clause buffers into a single sorted buffer
+without duplicates. Internally, the readers are arranged in a loser tree
+(tournament tree) so that each output clause requires only O(log k)
+clause comparisons for k input buffers. The clause ordering is resolved
+at compile time depending on the buffer's slot layout.
+If parallel sub-merges are enabled and there are sufficiently many inputs,
+disjoint groups of readers are first merged concurrently into intermediate
+(unbounded) buffers, which are then merged into the final result.
+The output is exactly the same as for a sequential merge.
+*/
 class BufferMerger {
-    
+
 private:
     int _size_limit;
+    int _excess_size_limit;
     int _max_clause_length;
     int _slots_for_sum_of_length_and_lbd;
 
     bool _use_checksum;
     std::vector<BufferReader> _readers;
 
-    std::vector<Clause> _next_clauses;
-    std::vector<bool> _selected;
-
-    typedef std::pair<Clause*, int> InputClause;
-    struct InputClauseComparator {
-        AbstractClauseThreewayComparator* compare;
-        InputClauseComparator(AbstractClauseThreewayComparator* compare) : compare(compare) {}
-        bool operator()(const InputClause& left, const InputClause& right) const {
-            int res = compare->compare(*left.first, *right.first);
-            if (res != 0) return res > 0;
-            if (left.second != right.second) return left.second < right.second;
-            return false;
-        }
-    };
-    std::forward_list<InputClause> _merger;
+    int _num_parallel_submerges {1};
+
+    int _num_merged_lits {0};
+    int _num_excess_lits {0};
 
 public:
     BufferMerger(int sizeLimit, int maxClauseLength, bool slotsForSumOfLengthAndLbd, bool useChecksum = false);
     void add(BufferReader&& reader);
+
+    // Allow to split the merge into up to this many sub-merges
+    // which are run concurrently via the ProcessWideThreadPool.
+    void setNumParallelSubmerges(int numSubmerges) {_num_parallel_submerges = std::max(1, numSubmerges);}
+
+    // Limit the size of the excess clauses buffer to a value other than the size limit.
+    void setExcessSizeLimit(int excessSizeLimit) {_excess_size_limit = excessSizeLimit;}
+
     std::vector<int> merge(std::vector<int>* excessClauses = nullptr);
-    
+
+    // Number of literals written to the merged buffer / to the excess clauses by merge()
+    int getNumMergedLiterals() const {return _num_merged_lits;}
+    int getNumExcessLiterals() const {return _num_excess_lits;}
+
 private:
-    std::vector<int> fastMerge(int sizeLimit, std::vector<int>* excessClauses = nullptr);
+    void mergeReaders(std::vector<BufferReader*>& readers, BufferBuilder& mainBuilder, BufferBuilder* excessBuilder);
+    template <typename Cmp>
+    void mergeReaders(std::vector<BufferReader*>& readers, const Cmp& compare, BufferBuilder& mainBuilder, BufferBuilder* excessBuilder);
+    std::vector<std::vector<int>> mergeSubsetsInParallel(int numSubmerges);
 };
@@ -2,9 +2,26 @@
 #include "buffer_reader.hpp"
 #include "util/logger.hpp"
 
-BufferReader::BufferReader(int* buffer, int size, int maxClauseLength, bool slotsForSumOfLengthAndLbd, bool useChecksum) : 
-        _buffer(buffer), _size(size), _it(maxClauseLength, slotsForSumOfLengthAndLbd), _use_checksum(useChecksum) {
+BufferReader::BufferReader(int* buffer, int size, int maxClauseLength, bool slotsForSumOfLengthAndLbd, 
+        bool useChecksum, bool compressed) : 
+        _buffer(buffer), _size(size), _it(maxClauseLength, slotsForSumOfLengthAndLbd), _use_checksum(useChecksum),
+        _compressed(compressed) {
     
+    if (_compressed) {
+        _hash = 1;
+        _current_clause.size = _it.clauseLength;
+        _current_clause.lbd = _it.lbd;
+        _decoded_lits.resize(maxClauseLength);
+        if (_size == 0) return;
+        _byte_pos = CompressedClauseBuffer::getBytes(_buffer);
+        _byte_end = _byte_pos + CompressedClauseBuffer::getNumBytes(_buffer, _size);
+        size_t header = CompressedClauseBuffer::readVarint(_byte_pos);
+        if (_use_checksum) _true_hash = header;
+        // The first bucket's counter is read without advancing the iterator
+        _remaining_cls_of_bucket = _byte_pos < _byte_end ? CompressedClauseBuffer::readVarint(_byte_pos) : 0;
+        return;
+    }
+
     int numInts = sizeof(size_t)/sizeof(int);
     if (_use_checksum && _size > 0) {
         // Extract checksum
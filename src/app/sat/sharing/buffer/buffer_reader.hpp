@@ -5,6 +5,7 @@
 
 #include "util/assert.hpp"
 #include "buffer_iterator.hpp"
+#include "compressed_clause_buffer.hpp"
 #include "../../data/clause.hpp"
 #include "util/hashing.hpp"
 #include "util/logger.hpp"
@@ -23,9 +24,20 @@ private:
     size_t _hash;
     size_t _true_hash = 1;
 
+    // Decoding state if the buffer is in the compressed format
+    // (see CompressedClauseBuffer). Each clause is decoded into the same
+    // memory, so only the most recently returned clause is valid: it is
+    // overwritten by the next call to getNextIncomingClause().
+    bool _compressed = false;
+    const uint8_t* _byte_pos = nullptr;
+    const uint8_t* _byte_end = nullptr;
+    std::vector<int> _decoded_lits;
+    int _last_first_lit = 0;
+
 public:
     BufferReader() = default;
-    BufferReader(int* buffer, int size, int maxClauseLength, bool slotsForSumOfLengthAndLbd, bool useChecksum = false);
+    BufferReader(int* buffer, int size, int maxClauseLength, bool slotsForSumOfLengthAndLbd, 
+        bool useChecksum = false, bool compressed = false);
 
     void releaseBuffer() {_buffer = nullptr;}
     
@@ -34,11 +46,14 @@ public:
     size_t getRemainingSize() const {return _size - _current_pos;}
     size_t getNumRemainingClausesInBucket() const {return _remaining_cls_of_bucket;}
     const BufferIterator& getCurrentBufferIterator() const {return _it;} 
+    bool isCompressed() const {return _compressed;}
     
     inline const Mallob::Clause& getNextIncomingClause() {
         // No buffer?
         if (_buffer == nullptr) return _current_clause;
 
+        if (_compressed) return getNextIncomingCompressedClause();
+
         // Find first bucket with some clauses left
         if (_remaining_cls_of_bucket == 0) {
             do {    
@@ -88,5 +103,47 @@ public:
     }
 
 private:
+    inline const Mallob::Clause& getNextIncomingCompressedClause() {
+
+        // Find first bucket with some clauses left
+        if (_remaining_cls_of_bucket == 0) {
+            do {
+                // Nothing left to read?
+                if (_byte_pos >= _byte_end) {
+                    return endReading();
+                }
+
+                // Go to next bucket
+                _it.nextLengthLbdGroup();
+                _remaining_cls_of_bucket = CompressedClauseBuffer::readVarint(_byte_pos);
+
+            } while (_remaining_cls_of_bucket == 0);
+
+            // Update clause data; the first literal of a bucket is encoded relative to zero
+            _current_clause.size = _it.clauseLength;
+            _current_clause.lbd = _it.lbd;
+            _last_first_lit = 0;
+        }
+
+        // Decode literals
+        int* lits = _decoded_lits.data();
+        int lit = _last_first_lit + CompressedClauseBuffer::unzigzag(CompressedClauseBuffer::readVarint(_byte_pos));
+        lits[0] = lit;
+        _last_first_lit = lit;
+        for (int i = 1; i < _current_clause.size; i++) {
+            lit += CompressedClauseBuffer::unzigzag(CompressedClauseBuffer::readVarint(_byte_pos));
+            lits[i] = lit;
+        }
+        assert(_byte_pos <= _byte_end);
+
+        if (_use_checksum) {
+            hash_combine(_hash, Mallob::ClauseHasher::hash(lits, _current_clause.size, 3));
+        }
+
+        _current_clause.begin = lits;
+        _remaining_cls_of_bucket--;
+        return _current_clause;
+    }
+
     const Mallob::Clause& endReading();
 };
@@ -0,0 +1,177 @@
+
+#pragma once
+
+#include <deque>
+#include <forward_list>
+#include <memory>
+#include <vector>
+
+#include "../../data/clause.hpp"
+#include "util/assert.hpp"
+
+/*
+Flat storage for the clauses of a single slot of an AdaptiveClauseDatabase.
+Clauses are appended to contiguous chunks of fixed capacity. Each clause is
+stored as a record [literals..., lbd (if not implicit), size (if not fixed)]
+so that the most recently inserted clause can always be accessed and removed
+at the back, which mirrors the LIFO behavior of the former linked list.
+Chunks which run empty are kept in a pool and reused for later insertions,
+so that in a steady state of sharing epochs no heap allocations occur.
+The structure is not thread-safe; the owning slot's mutex must be held.
+*/
+class ClauseArena {
+
+private:
+    struct Chunk {
+        std::vector<int> data;
+        size_t size {0};
+        Chunk(size_t capacity) : data(capacity) {}
+    };
+
+    int _fixed_size_or_zero {0};
+    int _implicit_lbd_or_zero {0};
+    size_t _chunk_capacity {0};
+    size_t _max_pooled_chunks {0};
+
+    std::deque<std::unique_ptr<Chunk>> _chunks;
+    std::vector<std::unique_ptr<Chunk>> _pool;
+    size_t _nb_clauses {0};
+
+public:
+    ClauseArena() = default;
+    ClauseArena(int fixedSizeOrZero, int implicitLbdOrZero, size_t chunkCapacity, size_t maxPooledChunks) :
+        _fixed_size_or_zero(fixedSizeOrZero), _implicit_lbd_or_zero(implicitLbdOrZero),
+        _chunk_capacity(chunkCapacity), _max_pooled_chunks(maxPooledChunks) {}
+    ClauseArena(ClauseArena&& other) = default;
+    ClauseArena& operator=(ClauseArena&& other) = default;
+
+    // Creates an empty arena with the same parametrization as this one.
+    ClauseArena emptyCopy() const {
+        return ClauseArena(_fixed_size_or_zero, _implicit_lbd_or_zero, _chunk_capacity, _max_pooled_chunks);
+    }
+
+    void push(const int* lits, int size, int lbd) {
+        assert(_fixed_size_or_zero == 0 || size == _fixed_size_or_zero);
+        assert(_implicit_lbd_or_zero == 0 || lbd == _implicit_lbd_or_zero);
+        const size_t recordSize = getRecordSize(size);
+        assert(recordSize <= _chunk_capacity);
+        if (_chunks.empty() || _chunks.back()->size + recordSize > _chunk_capacity) {
+            _chunks.push_back(acquireChunk());
+        }
+        auto& chunk = *_chunks.back();
+        int* out = chunk.data.data() + chunk.size;
+        for (int i = 0; i < size; i++) out[i] = lits[i];
+        int idx = size;
+        if (_implicit_lbd_or_zero == 0) out[idx++] = lbd;
+        if (_fixed_size_or_zero == 0) out[idx++] = size;
+        chunk.size += recordSize;
+        _nb_clauses++;
+    }
+
+    // Appends all clauses of a list of packed clauses as used by the import
+    // interface of PortfolioSolverInterface.
+    template <typename T>
+    void pushAll(std::forward_list<T>& clauses, int size, int lbd) {
+        for (auto& elem : clauses) {
+            if constexpr (std::is_same<int, T>::value) {
+                push(&elem, 1, 1);
+            }
+            if constexpr (std::is_same<std::pair<int, int>, T>::value) {
+                int lits[2] = {elem.first, elem.second};
+                push(lits, 2, 2);
+            }
+            if constexpr (std::is_same<std::vector<int>, T>::value) {
+                // Packed large clauses begin with an explicit LBD iff the slot has no implicit LBD
+                bool lbdInVector = _implicit_lbd_or_zero == 0;
+                assert(elem.size() == size + (lbdInVector ? 1 : 0));
+                push(elem.data() + (lbdInVector ? 1 : 0), size, lbdInVector ? elem[0] : lbd);
+            }
+        }
+    }
+
+    bool empty() const {
+        return _nb_clauses == 0;
+    }
+    size_t getNbClauses() const {
+        return _nb_clauses;
+    }
+
+    // Returns the most recently inserted clause, pointing into the arena.
+    Mallob::Clause back() const {
+        assert(!empty());
+        auto& chunk = *_chunks.back();
+        return readBackwards(chunk.data.data() + chunk.size);
+    }
+
+    void popBack() {
+        assert(!empty());
+        auto& chunk = *_chunks.back();
+        chunk.size -= getRecordSize(back().size);
+        _nb_clauses--;
+        if (chunk.size == 0) {
+            releaseChunk(std::move(_chunks.back()));
+            _chunks.pop_back();
+        }
+    }
+
+    // Calls f on each clause from the most recent to the oldest clause
+    // until f returns false.
+    template <typename F>
+    void forEachFromBack(F f) const {
+        for (auto it = _chunks.rbegin(); it != _chunks.rend(); ++it) {
+            const int* begin = (*it)->data.data();
+            const int* end = begin + (*it)->size;
+            while (end != begin) {
+                Mallob::Clause c = readBackwards(end);
+                if (!f(c)) return;
+                end -= getRecordSize(c.size);
+            }
+        }
+    }
+
+    void swap(ClauseArena& other) {
+        _chunks.swap(other._chunks);
+        std::swap(_nb_clauses, other._nb_clauses);
+    }
+
+    // Moves all clauses of the other arena in front of (i.e., as older than)
+    // the clauses of this arena. Also takes over the other arena's free chunks.
+    void prependFrom(ClauseArena& other) {
+        while (!other._chunks.empty()) {
+            _chunks.push_front(std::move(other._chunks.back()));
+            other._chunks.pop_back();
+        }
+        _nb_clauses += other._nb_clauses;
+        other._nb_clauses = 0;
+        for (auto& chunk : other._pool) releaseChunk(std::move(chunk));
+        other._pool.clear();
+    }
+
+private:
+    inline size_t getRecordSize(int size) const {
+        return size + (_implicit_lbd_or_zero == 0 ? 1 : 0) + (_fixed_size_or_zero == 0 ? 1 : 0);
+    }
+
+    // Parses the clause record which ends right before the provided position.
+    inline Mallob::Clause readBackwards(const int* recordEnd) const {
+        const int* pos = recordEnd;
+        int size = _fixed_size_or_zero == 0 ? *(--pos) : _fixed_size_or_zero;
+        int lbd = _implicit_lbd_or_zero == 0 ? *(--pos) : _implicit_lbd_or_zero;
+        return Mallob::Clause(const_cast<int*>(pos - size), size, lbd);
+    }
+
+    std::unique_ptr<Chunk> acquireChunk() {
+        if (!_pool.empty()) {
+            auto chunk = std::move(_pool.back());
+            _pool.pop_back();
+            return chunk;
+        }
+        return std::unique_ptr<Chunk>(new Chunk(_chunk_capacity));
+    }
+
+    void releaseChunk(std::unique_ptr<Chunk>&& chunk) {
+        chunk->size = 0;
+        if (_pool.size() < _max_pooled_chunks) _pool.push_back(std::move(chunk));
+        // else: chunk is freed implicitly
+    }
+};
@@ -0,0 +1,138 @@
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "util/assert.hpp"
+#include "buffer_iterator.hpp"
+
+/*
+Compact wire format for the flat clause buffers produced by BufferBuilder.
+The structure of the flat format (checksum header, then a clause count for
+each bucket followed by the bucket's clauses) is retained, but every integer
+is written as a LEB128 varint. Literals are delta-encoded and zigzag-mapped:
+The first literal of a clause relative to the first literal of the previous
+clause in the same bucket (clauses are sorted), all other literals relative
+to their predecessor within the clause.
+The bytes are packed into a std::vector<int> of the form [#bytes, bytes...]
+so that the buffer can be sent as a normal message payload. An empty flat
+buffer is encoded as an empty vector.
+BufferReader can decode this format on the fly (see its "compressed" flag),
+so that compressed buffers can be merged without inflating them first.
+Note that a clause returned by such a reader is only valid until the next
+clause is read.
+*/
+class CompressedClauseBuffer {
+
+public:
+    static std::vector<int> compress(const int* data, size_t size, int maxClauseLength, bool slotsForSumOfLengthAndLbd) {
+        std::vector<int> out;
+        const size_t numHeaderInts = sizeof(size_t)/sizeof(int);
+        if (size == 0) return out;
+        assert(size >= numHeaderInts);
+
+        // Each varint takes at most 5 bytes per int (10 bytes for the header)
+        const size_t maxNumBytes = 10 + 5*size;
+        out.resize(1 + (maxNumBytes + sizeof(int)-1) / sizeof(int));
+        uint8_t* const begin = (uint8_t*) (out.data()+1);
+        uint8_t* pos = begin;
+
+        size_t header;
+        memcpy(&header, data, sizeof(size_t));
+        pos = writeVarint(pos, header);
+
+        BufferIterator it(maxClauseLength, slotsForSumOfLengthAndLbd);
+        size_t i = numHeaderInts;
+        bool firstBucket = true;
+        while (i < size) {
+            if (!firstBucket) it.nextLengthLbdGroup();
+            firstBucket = false;
+            int numClauses = data[i++];
+            assert(numClauses >= 0);
+            pos = writeVarint(pos, numClauses);
+            int lastFirstLit = 0;
+            for (int c = 0; c < numClauses; c++) {
+                assert(i + it.clauseLength <= size);
+                const int* lits = data+i;
+                pos = writeVarint(pos, zigzag((int64_t)lits[0] - lastFirstLit));
+                lastFirstLit = lits[0];
+                for (int l = 1; l < it.clauseLength; l++)
+                    pos = writeVarint(pos, zigzag((int64_t)lits[l] - lits[l-1]));
+                i += it.clauseLength;
+            }
+        }
+
+        size_t numBytes = pos - begin;
+        out[0] = numBytes;
+        out.resize(1 + (numBytes + sizeof(int)-1) / sizeof(int));
+        return out;
+    }
+
+    static std::vector<int> decompress(const int* data, size_t size, int maxClauseLength, bool slotsForSumOfLengthAndLbd) {
+        std::vector<int> out;
+        if (size == 0) return out;
+        const uint8_t* pos = getBytes(data);
+        const uint8_t* end = pos + getNumBytes(data, size);
+
+        size_t header = readVarint(pos);
+        out.resize(sizeof(size_t)/sizeof(int));
+        memcpy(out.data(), &header, sizeof(size_t));
+
+        BufferIterator it(maxClauseLength, slotsForSumOfLengthAndLbd);
+        bool firstBucket = true;
+        while (pos < end) {
+            if (!firstBucket) it.nextLengthLbdGroup();
+            firstBucket = false;
+            int numClauses = readVarint(pos);
+            out.push_back(numClauses);
+            int lastFirstLit = 0;
+            for (int c = 0; c < numClauses; c++) {
+                int lit = lastFirstLit + unzigzag(readVarint(pos));
+                lastFirstLit = lit;
+                out.push_back(lit);
+                for (int l = 1; l < it.clauseLength; l++) {
+                    lit += unzigzag(readVarint(pos));
+                    out.push_back(lit);
+                }
+            }
+        }
+        return out;
+    }
+
+    static inline const uint8_t* getBytes(const int* data) {
+        return (const uint8_t*) (data+1);
+    }
+    static inline size_t getNumBytes(const int* data, size_t size) {
+        size_t numBytes = data[0];
+        assert(1 + (numBytes + sizeof(int)-1) / sizeof(int) <= size);
+        return numBytes;
+    }
+
+    static inline uint8_t* writeVarint(uint8_t* pos, uint64_t val) {
+        while (val >= 0x80) {
+            *pos++ = (uint8_t) (val | 0x80);
+            val >>= 7;
+        }
+        *pos++ = (uint8_t) val;
+        return pos;
+    }
+    static inline uint64_t readVarint(const uint8_t*& pos) {
+        uint64_t val = 0;
+        int shift = 0;
+        while (*pos & 0x80) {
+            val |= (uint64_t) (*pos++ & 0x7f) << shift;
+            shift += 7;
+        }
+        val |= (uint64_t) (*pos++) << shift;
+        return val;
+    }
+
+    static inline uint64_t zigzag(int64_t val) {
+        return ((uint64_t) val << 1) ^ (uint64_t) (val >> 63);
+    }
+    static inline int64_t unzigzag(uint64_t val) {
+        return (int64_t) (val >> 1) ^ -(int64_t) (val & 1);
+    }
+};
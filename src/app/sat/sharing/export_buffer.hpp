@@ -1,18 +1,36 @@
 
 #pragma once
 
-#include <list>
+#include <algorithm>
+#include <atomic>
+#include <memory>
 
 #include "util/sys/threading.hpp"
+#include "util/sys/spsc_ring_buffer.hpp"
 #include "filter/produced_clause_filter.hpp"
 #include "buffer/adaptive_clause_database.hpp"
 #include "../data/solver_statistics.hpp"
 
+// Passes clauses produced by the local solvers to the clause filter and
+// the clause database. If the filter shard of a produced clause is busy,
+// the clause is deferred to a lock-free ring owned by the producing solver.
+// The rings are drained in batches by one thread at a time (and fully before
+// each export). Clauses which do not fit into their ring are dropped.
 class ExportBuffer {
 
 private:
-    Mutex _backlog_mutex;
-    std::list<ProducedClauseCandidate> _export_backlog;
+    // Max. number of deferred clauses processed by a producer after its own clause
+    static constexpr size_t BACKLOG_BATCH_SIZE = 256;
+    // Each record in a ring: [size, lbd, epoch, literals ...]
+    static constexpr size_t RECORD_HEADER_SIZE = 3;
+
+    std::vector<std::unique_ptr<SPSCRingBuffer>> _backlog_rings;
+    // Held by the single consumer of the backlog rings
+    Mutex _backlog_consumer_mutex;
+    size_t _next_ring_to_drain = 0;
+    std::atomic_int _nb_pending {0};
+    std::atomic_ulong _nb_deferred {0};
+    std::atomic_ulong _nb_dropped_from_backlog {0};
 
     ProducedClauseFilter& _filter;
     AdaptiveClauseDatabase& _cdb;
@@ -24,56 +42,86 @@ private:
 
 public:
     ExportBuffer(ProducedClauseFilter& filter, AdaptiveClauseDatabase& cdb, 
-            std::vector<SolverStatistics*>& solverStats, int maxClauseLength) : 
+            std::vector<SolverStatistics*>& solverStats, int maxClauseLength,
+            int numProducers, size_t ringSizePerProducer) : 
         _filter(filter), _cdb(cdb), _solver_stats(solverStats),
         _hist_failed_filter(maxClauseLength), 
         _hist_admitted_to_db(maxClauseLength), 
-        _hist_dropped_before_db(maxClauseLength) {}
+        _hist_dropped_before_db(maxClauseLength) {
+        
+        // Each ring must fit at least one record of a clause of maximum length
+        ringSizePerProducer = std::max(ringSizePerProducer, 1 + RECORD_HEADER_SIZE + maxClauseLength);
+        for (int i = 0; i < numProducers; i++) {
+            _backlog_rings.emplace_back(new SPSCRingBuffer(ringSizePerProducer));
+        }
+    }
 
+    // Must be called only by the thread of the producing solver.
     void produce(int* begin, int size, int lbd, int producerId, int epoch) {
 
-        if (_filter.tryAcquireLock()) {
+        ProducedClauseFilter::ExportResult result;
+        if (_filter.tryRegisterAndInsertIfUncontended(begin, size, lbd, producerId, epoch, _cdb, result)) {
 
-            // Insert clause directly
-            auto result = _filter.tryRegisterAndInsert(
-                ProducedClauseCandidate(begin, size, lbd, producerId, epoch), 
-                _cdb
-            );
+            // Inserted directly
             handleResult(producerId, result, size);
 
-            // Also decrease backlog size by some amount
-            std::list<ProducedClauseCandidate> backlogSplice;
-            {
-                auto lock = _backlog_mutex.getLock();
-                if (!_export_backlog.empty()) {
-                    backlogSplice.splice(backlogSplice.begin(), _export_backlog, 
-                        _export_backlog.begin(),
-                        std::next(_export_backlog.begin(), std::min(16ul, _export_backlog.size()))
-                    );
-                }
-            }
-            for (auto& pcc : backlogSplice) {
-                int clauseLength = pcc.size;
-                int producerId = pcc.producerId;
-                result = _filter.tryRegisterAndInsert(std::move(pcc), _cdb);
-                handleResult(producerId, result, clauseLength);
-            }
-
-            _filter.releaseLock();
-
         } else {
 
-            // Filter busy: Append clause to backlog
-            auto lock = _backlog_mutex.getLock();
-            _export_backlog.emplace_back(begin, size, lbd, producerId, epoch);        
+            // Filter shard busy: Append clause to this producer's backlog ring
+            const int header[RECORD_HEADER_SIZE] = {size, lbd, epoch};
+            if (_backlog_rings.at(producerId)->tryPush(header, RECORD_HEADER_SIZE, begin, size)) {
+                atomics::incrementRelaxed(_nb_pending);
+                atomics::incrementRelaxed(_nb_deferred);
+            } else {
+                // Backlog full: drop clause explicitly
+                atomics::incrementRelaxed(_nb_dropped_from_backlog);
+                handleResult(producerId, ProducedClauseFilter::DROPPED, size);
+            }
         }
+
+        // Also decrease backlog size by some amount if no one else does
+        if (_nb_pending.load(std::memory_order_relaxed) > 0 && _backlog_consumer_mutex.tryLock()) {
+            drainBacklog(BACKLOG_BATCH_SIZE);
+            _backlog_consumer_mutex.unlock();
+        }
+    }
+
+    // Processes all clauses currently deferred in the backlog.
+    // Must be called before exporting clauses from the database.
+    void flushBacklog() {
+        auto lock = _backlog_consumer_mutex.getLock();
+        drainBacklog(SIZE_MAX);
     }
 
+    unsigned long getNumDeferredClauses() const {return _nb_deferred.load(std::memory_order_relaxed);}
+    unsigned long getNumDroppedFromBacklog() const {return _nb_dropped_from_backlog.load(std::memory_order_relaxed);}
+
     ClauseHistogram& getFailedFilterHistogram() {return _hist_failed_filter;}
 	ClauseHistogram& getAdmittedHistogram() {return _hist_admitted_to_db;}
 	ClauseHistogram& getDroppedHistogram() {return _hist_dropped_before_db;}
 
 private:
+    // The caller must hold the backlog consumer lock, which makes it
+    // the single consumer of all backlog rings.
+    void drainBacklog(size_t maxNbClauses) {
+        size_t nbDrained = 0;
+        for (size_t n = 0; n < _backlog_rings.size() && nbDrained < maxNbClauses; n++) {
+            int producerId = _next_ring_to_drain;
+            _next_ring_to_drain = (_next_ring_to_drain+1) % _backlog_rings.size();
+            nbDrained += _backlog_rings[producerId]->consume(maxNbClauses - nbDrained, 
+                    [&](const int* record, [[maybe_unused]] size_t recordSize) {
+                int size = record[0];
+                assert(recordSize == RECORD_HEADER_SIZE + size);
+                auto result = _filter.tryRegisterAndInsert(
+                    ProducedClauseCandidate((int*) record+RECORD_HEADER_SIZE, size, record[1], producerId, record[2]),
+                    _cdb
+                );
+                handleResult(producerId, result, size);
+            });
+        }
+        atomics::subRelaxed(_nb_pending, (int) nbDrained);
+    }
+
     void handleResult(int producerId, ProducedClauseFilter::ExportResult result, int clauseLength) {
         auto solverStats = _solver_stats.at(producerId);
         if (result == ProducedClauseFilter::ADMITTED) {
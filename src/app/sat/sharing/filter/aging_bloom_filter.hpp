@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "util/assert.hpp"
+#include "util/robin_hood.hpp"
+
+/*
+Approximate membership structure for 64-bit hash values with bounded memory.
+The filter is a blocked Bloom filter: each key selects one block of 512 bits
+(a cache line) and sets k bits within this block, so that each query touches
+a single cache line per generation.
+To forget old keys, the memory is split into a number of generations. Keys
+are inserted into the current generation only, and queries check all
+generations. Advancing the generation clears the oldest generation and makes
+it the current one. A key is thus remembered for at least (#generations - 1)
+and at most #generations generation advances.
+The false positive rate for n keys per generation, m bits per generation,
+and g generations is about 1 - (1 - (1 - e^(-k*n/m))^k)^g (slightly higher
+due to blocking).
+*/
+class AgingBloomFilter {
+
+private:
+    static constexpr size_t WORDS_PER_BLOCK = 8; // 8*64 = 512 bits
+    static constexpr size_t BITS_PER_BLOCK = 64 * WORDS_PER_BLOCK;
+
+    int _num_hash_functions;
+    size_t _num_blocks_per_generation;
+
+    std::vector<std::vector<uint64_t>> _generations;
+    std::vector<size_t> _num_insertions;
+    int _current_generation {0};
+
+public:
+    AgingBloomFilter(size_t numBytes, int numHashFunctions, int numGenerations) :
+            _num_hash_functions(numHashFunctions) {
+        assert(numHashFunctions >= 1);
+        assert(numGenerations >= 1);
+        _num_blocks_per_generation = std::max((size_t)1, numBytes / numGenerations / (BITS_PER_BLOCK/8));
+        _generations.resize(numGenerations);
+        for (auto& gen : _generations) gen.resize(_num_blocks_per_generation * WORDS_PER_BLOCK);
+        _num_insertions.resize(numGenerations);
+    }
+
+    bool contains(uint64_t hash) const {
+        for (auto& gen : _generations) {
+            if (containsIn(gen, hash)) return true;
+        }
+        return false;
+    }
+
+    void insert(uint64_t hash) {
+        auto& gen = _generations[_current_generation];
+        uint64_t* block = gen.data() + getBlockIndex(hash) * WORDS_PER_BLOCK;
+        forEachBit(hash, [&](int bit) {
+            block[bit / 64] |= 1UL << (bit % 64);
+        });
+        _num_insertions[_current_generation]++;
+    }
+
+    // Forget all keys of the oldest generation and make it the current one.
+    void advanceGeneration() {
+        _current_generation = (_current_generation+1) % _generations.size();
+        auto& gen = _generations[_current_generation];
+        std::fill(gen.begin(), gen.end(), 0);
+        _num_insertions[_current_generation] = 0;
+    }
+
+    size_t getNumGenerations() const {
+        return _generations.size();
+    }
+    size_t getNumInsertions() const {
+        size_t sum = 0;
+        for (size_t n : _num_insertions) sum += n;
+        return sum;
+    }
+    size_t getMemoryBytes() const {
+        return _generations.size() * _num_blocks_per_generation * WORDS_PER_BLOCK * sizeof(uint64_t);
+    }
+
+    // Estimated probability that a key which was never inserted is reported
+    // as contained, given the current number of insertions.
+    double getEstimatedFalsePositiveRate() const {
+        const double bitsPerGeneration = _num_blocks_per_generation * BITS_PER_BLOCK;
+        double pNegative = 1;
+        for (size_t n : _num_insertions) {
+            double pGen = std::pow(1 - std::exp(-_num_hash_functions * (double) n / bitsPerGeneration), _num_hash_functions);
+            pNegative *= 1 - pGen;
+        }
+        return 1 - pNegative;
+    }
+
+private:
+    inline size_t getBlockIndex(uint64_t hash) const {
+        // Re-mix the key so that the block index is independent of the bit positions
+        return robin_hood::hash_int(hash) % _num_blocks_per_generation;
+    }
+
+    template <typename F>
+    inline void forEachBit(uint64_t hash, F f) const {
+        // Double hashing within the block. The key is re-mixed (differently than
+        // for the block index) since the provided hashes may be poorly distributed.
+        uint64_t mixed = robin_hood::hash_int(hash ^ 0x9e3779b97f4a7c15UL);
+        uint32_t h1 = (uint32_t) mixed;
+        uint32_t h2 = (uint32_t) (mixed >> 32) | 1;
+        for (int i = 0; i < _num_hash_functions; i++) {
+            f((h1 + i*h2) % BITS_PER_BLOCK);
+        }
+    }
+
+    inline bool containsIn(const std::vector<uint64_t>& gen, uint64_t hash) const {
+        const uint64_t* block = gen.data() + getBlockIndex(hash) * WORDS_PER_BLOCK;
+        bool contained = true;
+        forEachBit(hash, [&](int bit) {
+            contained &= (block[bit / 64] >> (bit % 64)) & 1UL;
+        });
+        return contained;
+    }
+};
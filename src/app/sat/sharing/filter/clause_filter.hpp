@@ -31,7 +31,7 @@ public:
 struct AbstractClauseThreewayComparator {
 	virtual int compare(const Clause& left, const Clause& right) const = 0;
 };
-struct LexicographicClauseThreewayComparator : public AbstractClauseThreewayComparator {
+struct LexicographicClauseThreewayComparator final : public AbstractClauseThreewayComparator {
 	int compare(const Clause& left, const Clause& right) const {
 		// Shortest length first
 		if (left.size != right.size) return left.size < right.size ? -1 : 1;
@@ -45,7 +45,7 @@ struct LexicographicClauseThreewayComparator : public AbstractClauseThreewayComp
 		return 0;
 	}
 };
-struct LengthLbdSumClauseThreewayComparator : public AbstractClauseThreewayComparator {
+struct LengthLbdSumClauseThreewayComparator final : public AbstractClauseThreewayComparator {
 	int maxLengthLbdSum;
 	LengthLbdSumClauseThreewayComparator(int maxLengthLbdSum) : maxLengthLbdSum(maxLengthLbdSum) {}
 	int compare(const Clause& left, const Clause& right) const {
@@ -4,6 +4,7 @@
 #include <array>
 
 #include "util/tsl/robin_map.h"
+#include "util/robin_hood.hpp"
 #include "../../data/produced_clause.hpp"
 #include "../../data/produced_clause_candidate.hpp"
 #include "util/sys/threading.hpp"
@@ -17,7 +18,7 @@ struct ClauseInfo {
     uint8_t minSharedLbd:5;
     // Bitset of which local solver(s) exported the clause 
     uint8_t producers:6;
-    // Epoch of last modification (production, or sharing:=true)
+    // Epoch of last modification (production while unshared, or sharing)
     uint16_t lastSharedEpoch:16;
 
     ClauseInfo() {
@@ -30,7 +31,7 @@ struct ClauseInfo {
         minProducedLbd = c.lbd;
         minSharedLbd = 0;
         producers = 1 << c.producerId;
-        lastSharedEpoch = 0;
+        lastSharedEpoch = c.epoch;
     }
 };
 
@@ -40,17 +41,25 @@ struct ClauseInfo {
 // subset of solvers should receive the clauses (because they did not export it themselves).
 // The structure takes space linear in the number of clauses successfully added to the
 // AdaptiveClauseDatabase instance which is used for tryRegisterAndInsert. 
+// The clauses are partitioned into shards by their (commutative) hash value, each shard
+// with its own lock, so that concurrent producers rarely contend for the same lock.
 class ProducedClauseFilter {
 
 template <typename T>
 using ProducedMap = tsl::robin_map<T, ClauseInfo, ProducedClauseHasher<T>, ProducedClauseEqualsCommutative<T>>;
 
-private:
-    ProducedMap<ProducedUnitClause> _map_units;
-    ProducedMap<ProducedBinaryClause> _map_binaries;
-    ProducedMap<ProducedLargeClause> _map_large_clauses;
+public:
+    static constexpr int NUM_SHARDS = 32;
 
-    Mutex _map_mutex;
+private:
+    struct alignas(64) Shard {
+        ProducedMap<ProducedUnitClause> mapUnits;
+        ProducedMap<ProducedBinaryClause> mapBinaries;
+        ProducedMap<ProducedLargeClause> mapLargeClauses;
+        Mutex mtx;
+    };
+    std::array<Shard, NUM_SHARDS> _shards;
+    int _next_shard_to_clear = 0;
 
     const int _epoch_horizon;
     const bool _reshare_improved_lbd;
@@ -62,24 +71,127 @@ public:
         _epoch_horizon(epochHorizon), _reshare_improved_lbd(reshareImprovedLbd) {}
 
     enum ExportResult {ADMITTED, FILTERED, DROPPED};
+
+    // Register the clause and, if it is not filtered, insert it into the database.
+    // Acquires the lock of the clause's shard.
     ExportResult tryRegisterAndInsert(ProducedClauseCandidate&& c, AdaptiveClauseDatabase& cdb) {
+        auto& shard = _shards[getShardIndex(c.begin, c.size)];
+        auto lock = shard.mtx.getLock();
+        return registerAndInsertWithLockedShard(std::move(c), shard, cdb);
+    }
+
+    // Same as tryRegisterAndInsert, but gives up immediately (returning false)
+    // if the clause's shard is currently locked by another thread.
+    bool tryRegisterAndInsertIfUncontended(int* begin, int size, int lbd, int producerId, int epoch, 
+            AdaptiveClauseDatabase& cdb, ExportResult& result) {
+        auto& shard = _shards[getShardIndex(begin, size)];
+        if (!shard.mtx.tryLock()) return false;
+        result = registerAndInsertWithLockedShard(
+            ProducedClauseCandidate(begin, size, lbd, producerId, epoch), shard, cdb);
+        shard.mtx.unlock();
+        return true;
+    }
+
+    uint8_t getProducers(Mallob::Clause& c, int epoch) {
+
+        auto& shard = _shards[getShardIndex(c.begin, c.size)];
+        auto lock = shard.mtx.getLock();
+
+        if (c.size == 1) {
+            ProducedUnitClause pc(c);
+            return getProducers(pc, shard.mapUnits, epoch);
+
+        } else if (c.size == 2) {
+            ProducedBinaryClause pc(c);
+            return getProducers(pc, shard.mapBinaries, epoch);
+
+        } else {
+            ProducedLargeClause pc;
+            pc.size = c.size;
+            pc.data = c.begin;
+            auto info = getProducers(pc, shard.mapLargeClauses, epoch);
+            pc.data = nullptr;
+            return info;
+        }
+    }
+
+    bool admitSharing(Mallob::Clause& c, int epoch) {
+
+        auto& shard = _shards[getShardIndex(c.begin, c.size)];
+        auto lock = shard.mtx.getLock();
+
+        if (c.size == 1) {
+            ProducedUnitClause pc(c);
+            return admitSharing(pc, shard.mapUnits, c.lbd, epoch);
+
+        } else if (c.size == 2) {
+            ProducedBinaryClause pc(c);
+            return admitSharing(pc, shard.mapBinaries, c.lbd, epoch);
+
+        } else {
+            ProducedLargeClause pc;
+            pc.data = c.begin;
+            pc.size = c.size;
+            bool admitted = admitSharing(pc, shard.mapLargeClauses, c.lbd, epoch);
+            pc.data = nullptr; // avoid freeing of clause data reference
+            return admitted;
+        }
+    }
+
+    // Incrementally forgets clauses which have been neither produced (while unshared)
+    // nor shared within the epoch horizon. Each call handles a subset of the shards
+    // such that every shard is cleared once per horizon; only the lock of the shard
+    // currently being cleared is held. Returns the number of erased clauses.
+    size_t clearExpiredEntries(int epoch) {
+        if (_epoch_horizon < 0) return 0; // never clear
+        int nbShardsToClear = _epoch_horizon == 0 ? NUM_SHARDS : 
+            (NUM_SHARDS + _epoch_horizon - 1) / _epoch_horizon;
+        size_t nbErased = 0;
+        for (int i = 0; i < nbShardsToClear; i++) {
+            auto& shard = _shards[_next_shard_to_clear];
+            _next_shard_to_clear = (_next_shard_to_clear+1) % NUM_SHARDS;
+            auto lock = shard.mtx.getLock();
+            nbErased += clearExpiredEntries(shard.mapUnits, epoch);
+            nbErased += clearExpiredEntries(shard.mapBinaries, epoch);
+            nbErased += clearExpiredEntries(shard.mapLargeClauses, epoch);
+        }
+        return nbErased;
+    }
+
+    size_t size() {
+        size_t sum = 0;
+        for (auto& shard : _shards) {
+            auto lock = shard.mtx.getLock();
+            sum += shard.mapUnits.size() + shard.mapBinaries.size() + shard.mapLargeClauses.size();
+        }
+        return sum;
+    }
+
+private:
+    inline int getShardIndex(const int* begin, int size) const {
+        // Mix the commutative clause hash since the maps use its lower bits
+        auto hash = robin_hood::hash_int(Mallob::commutativeHash(begin, size, 3));
+        return hash % NUM_SHARDS;
+    }
+
+    ExportResult registerAndInsertWithLockedShard(ProducedClauseCandidate&& c, Shard& shard, AdaptiveClauseDatabase& cdb) {
         
         if (c.size == 1) {
             ProducedUnitClause pc;
             pc.literal = *c.begin;
-            return tryRegisterAndInsert(pc, c, _map_units, cdb);
+            return tryRegisterAndInsert(pc, c, shard.mapUnits, cdb);
 
         } else if (c.size == 2) {
             ProducedBinaryClause pc;
             pc.literals[0] = std::min(c.begin[0], c.begin[1]);
             pc.literals[1] = std::max(c.begin[0], c.begin[1]);
-            return tryRegisterAndInsert(pc, c, _map_binaries, cdb);
+            return tryRegisterAndInsert(pc, c, shard.mapBinaries, cdb);
 
         } else {
             ProducedLargeClause pc;
             pc.size = c.size;
             pc.data = c.releaseData();
-            return tryRegisterAndInsert(pc, c, _map_large_clauses, cdb);
+            return tryRegisterAndInsert(pc, c, shard.mapLargeClauses, cdb);
         }
     }
 
@@ -115,51 +227,6 @@ public:
         return ADMITTED;
     }
 
-    uint8_t getProducers(Mallob::Clause& c, int epoch) {
-
-        if (c.size == 1) {
-            ProducedUnitClause pc(c);
-            return getProducers(pc, _map_units, epoch);
-
-        } else if (c.size == 2) {
-            ProducedBinaryClause pc(c);
-            return getProducers(pc, _map_binaries, epoch);
-
-        } else {
-            ProducedLargeClause pc;
-            pc.size = c.size;
-            pc.data = c.begin;
-            auto info = getProducers(pc, _map_large_clauses, epoch);
-            pc.data = nullptr;
-            return info;
-        }
-    }
-
-    bool admitSharing(Mallob::Clause& c, int epoch) {
-
-        if (c.size == 1) {
-            ProducedUnitClause pc(c);
-            return admitSharing(pc, _map_units, c.lbd, epoch);
-
-        } else if (c.size == 2) {
-            ProducedBinaryClause pc(c);
-            return admitSharing(pc, _map_binaries, c.lbd, epoch);
-
-        } else {
-            ProducedLargeClause pc;
-            pc.data = c.begin;
-            pc.size = c.size;
-            bool admitted = admitSharing(pc, _map_large_clauses, c.lbd, epoch);
-            pc.data = nullptr; // avoid freeing of clause data reference
-            return admitted;
-        }
-    }
-
-    inline bool tryAcquireLock() {return _map_mutex.tryLock();}
-    inline void acquireLock() {_map_mutex.lock();}
-    inline void releaseLock() {_map_mutex.unlock();}
-
-private:
     void updateClauseInfo(const ProducedClauseCandidate& c, ClauseInfo& info, bool updateLbd) {
         assert(c.lbd > 0);
         if (updateLbd) {
@@ -170,6 +237,21 @@ private:
         }
         // Add producing solver as a producer
         info.producers |= (1 << c.producerId);
+        // Refresh modification epoch of clauses which were not shared yet
+        if (info.minSharedLbd == 0) info.lastSharedEpoch = c.epoch;
+    }
+
+    template <typename T>
+    size_t clearExpiredEntries(ProducedMap<T>& map, int epoch) {
+        size_t nbErased = 0;
+        for (auto it = map.begin(); it != map.end();) {
+            uint16_t age = (uint16_t) (epoch - it.value().lastSharedEpoch);
+            if (age > _epoch_horizon) {
+                it = map.erase(it);
+                nbErased++;
+            } else ++it;
+        }
+        return nbErased;
     }
 
     template <typename T>
@@ -3,17 +3,47 @@
 
 #include <vector>
 #include <list>
+#include <memory>
+#include <atomic>
+#include <cstring>
 
 #include "buffer/adaptive_clause_database.hpp"
+#include "import_epoch_buffer.hpp"
 #include "../execution/solver_setup.hpp"
+#include "util/sys/threading.hpp"
 
 class ImportBuffer {
 
 private:
+    // A shared epoch buffer together with this solver's position in it
+    // and the clauses which are not to be imported by this solver.
+    struct EpochCursor {
+        std::shared_ptr<const ImportEpochBuffer> epoch;
+        std::vector<uint64_t> excluded; // bit i set: clause i is filtered for this solver
+        size_t nextUnit;
+        size_t nextNonunit;
+        bool isExcluded(size_t idx) const {
+            return (excluded[idx / 64] >> (idx % 64)) & 1UL;
+        }
+        bool done() const {
+            return nextUnit == epoch->getNumUnits() && nextNonunit == epoch->getNumClauses();
+        }
+    };
+
     SolverStatistics& _stats;
     AdaptiveClauseDatabase _cdb;
     int _max_clause_length;
 
+    // Epochs handed over by the sharing thread, not yet seen by the solver thread
+    Mutex _incoming_epochs_mutex;
+    std::list<EpochCursor> _incoming_epochs;
+    std::atomic_bool _has_incoming_epochs {false};
+    // Epochs currently traversed by the solver thread
+    std::list<EpochCursor> _epochs;
+    // Admitted and not yet ingested literals in epochs
+    std::atomic_long _num_pending_epoch_literals {0};
+    long _epoch_literal_budget;
+
     std::vector<int> _plain_units_out;
     Mallob::Clause _clause_out;
 
@@ -23,26 +53,39 @@ public:
             AdaptiveClauseDatabase::Setup cdbSetup;
             cdbSetup.maxClauseLength = setup.strictClauseLengthLimit;
             cdbSetup.maxLbdPartitionedSize = 2;
-            cdbSetup.numLiterals = setup.clauseBaseBufferSize * std::max(
-                setup.minNumChunksPerSolver, 
-                (int) (
-                    ((float) setup.numBufferedClsGenerations) * 
-                    setup.anticipatedLitsToImportPerCycle / setup.clauseBaseBufferSize
-                )
-            );
+            cdbSetup.numLiterals = getLiteralCapacity(setup);
             cdbSetup.slotsForSumOfLengthAndLbd = false;
             cdbSetup.useChecksums = false;
             return cdbSetup;
-        }()), _max_clause_length(setup.strictClauseLengthLimit) {}
+        }()), _max_clause_length(setup.strictClauseLengthLimit),
+        _epoch_literal_budget(getLiteralCapacity(setup)) {}
+
+    static int getLiteralCapacity(const SolverSetup& setup) {
+        return setup.clauseBaseBufferSize * std::max(
+            setup.minNumChunksPerSolver, 
+            (int) (
+                ((float) setup.numBufferedClsGenerations) * 
+                setup.anticipatedLitsToImportPerCycle / setup.clauseBaseBufferSize
+            )
+        );
+    }
 
-    int getLiteralBudget(int clauseLength, int lbd) {
-        return _cdb.reserveLiteralBudget(clauseLength, lbd);
+    // Number of literals which can still be admitted from sharing epochs.
+    long getEpochLiteralBudget() const {
+        return std::max(0L, _epoch_literal_budget - _num_pending_epoch_literals.load(std::memory_order_relaxed));
     }
 
-    template <typename T>
-    void performImport(int clauseLength, int lbd, std::forward_list<T>& clauses, int nbLiterals) {
-        if (clauses.empty()) return;
-        _cdb.addReservedUniformClauses(clauseLength, lbd, clauses, nbLiterals);
+    // Hand over a sharing epoch shared by all solvers. The epoch is not copied;
+    // a clause is only copied once this solver actually ingests it.
+    // Can be called concurrently to the solver thread's methods.
+    void addEpoch(const std::shared_ptr<const ImportEpochBuffer>& epoch, std::vector<uint64_t>&& excluded, 
+            size_t numAdmittedLiterals) {
+        if (numAdmittedLiterals == 0) return;
+        assert(excluded.size() * 64 >= epoch->getNumClauses());
+        _num_pending_epoch_literals += numAdmittedLiterals;
+        auto lock = _incoming_epochs_mutex.getLock();
+        _incoming_epochs.push_back(EpochCursor{epoch, std::move(excluded), 0, epoch->getNumUnits()});
+        _has_incoming_epochs.store(true, std::memory_order_release);
     }
 
     void add(const Mallob::Clause& c) {
@@ -52,17 +95,28 @@ public:
 
     const std::vector<int>& getUnitsBuffer() {
 
-        if (_cdb.getNumLiterals(1, 1) == 0) {
-            _plain_units_out.clear();
-            return _plain_units_out;
+        _plain_units_out.clear();
+
+        // Collect units from sharing epochs
+        fetchIncomingEpochs();
+        for (auto& cursor : _epochs) {
+            for (; cursor.nextUnit < cursor.epoch->getNumUnits(); cursor.nextUnit++) {
+                if (cursor.isExcluded(cursor.nextUnit)) continue;
+                _plain_units_out.push_back(*cursor.epoch->getLiterals(cursor.nextUnit));
+                _num_pending_epoch_literals--;
+            }
         }
+        releaseDoneEpochs();
 
         int numUnits = 0;
-        std::vector<int> buf;
-        buf = _cdb.exportBuffer(-1, numUnits, AdaptiveClauseDatabase::UNITS, /*sortClauses=*/false);
+        if (_cdb.getNumLiterals(1, 1) > 0) {
+            std::vector<int> buf;
+            buf = _cdb.exportBuffer(-1, numUnits, AdaptiveClauseDatabase::UNITS, /*sortClauses=*/false);
+            _plain_units_out.insert(_plain_units_out.end(), buf.data()+(buf.size()-numUnits), buf.data()+buf.size());
+        }
+        numUnits = _plain_units_out.size();
+        if (numUnits == 0) return _plain_units_out;
 
-        _plain_units_out = std::vector<int>(buf.data()+(buf.size()-numUnits), buf.data()+buf.size());
-        assert(_plain_units_out.size() == numUnits);
         for (int i = 0; i < _plain_units_out.size(); i++) assert(_plain_units_out[i] != 0);
         _stats.receivedClausesDigested += numUnits;
         _stats.histDigested->increase(1, numUnits);
@@ -76,6 +130,18 @@ public:
             _clause_out.begin = nullptr;
         }
 
+        // Ingest a clause from the oldest sharing epoch which has one left
+        fetchIncomingEpochs();
+        for (auto& cursor : _epochs) {
+            if (popFromEpoch(cursor, mode)) break;
+        }
+        releaseDoneEpochs();
+        if (_clause_out.begin != nullptr) {
+            _stats.receivedClausesDigested++;
+            _stats.histDigested->increment(_clause_out.size);
+            return _clause_out;
+        }
+
         if (_cdb.getCurrentlyUsedLiterals() == 0) return _clause_out;
 
         if (_cdb.popFrontWeak(mode, _clause_out)) {
@@ -90,12 +156,60 @@ public:
     }
 
     bool empty() const {
+        if (_has_incoming_epochs.load(std::memory_order_acquire)) return false;
+        for (auto& cursor : _epochs) if (!cursor.done()) return false;
         int litsInUse = _cdb.getCurrentlyUsedLiterals();
         assert(litsInUse >= 0);
         if (litsInUse > 0) return false;
         return true;
     }
 
+private:
+    void fetchIncomingEpochs() {
+        if (!_has_incoming_epochs.load(std::memory_order_acquire)) return;
+        auto lock = _incoming_epochs_mutex.getLock();
+        _epochs.splice(_epochs.end(), _incoming_epochs);
+        _has_incoming_epochs.store(false, std::memory_order_relaxed);
+    }
+
+    bool popFromEpoch(EpochCursor& cursor, AdaptiveClauseDatabase::ExportMode mode) {
+        size_t idx = cursor.epoch->getNumClauses();
+        if (mode != AdaptiveClauseDatabase::NONUNITS) {
+            while (cursor.nextUnit < cursor.epoch->getNumUnits() && cursor.isExcluded(cursor.nextUnit)) 
+                cursor.nextUnit++;
+            if (cursor.nextUnit < cursor.epoch->getNumUnits()) idx = cursor.nextUnit++;
+        }
+        if (idx == cursor.epoch->getNumClauses() && mode != AdaptiveClauseDatabase::UNITS) {
+            while (cursor.nextNonunit < cursor.epoch->getNumClauses() && cursor.isExcluded(cursor.nextNonunit)) 
+                cursor.nextNonunit++;
+            if (cursor.nextNonunit < cursor.epoch->getNumClauses()) idx = cursor.nextNonunit++;
+        }
+        if (idx == cursor.epoch->getNumClauses()) return false;
+
+        // Copy the clause only now that it is actually ingested
+        const auto& entry = cursor.epoch->getEntry(idx);
+        _clause_out.begin = (int*) malloc(sizeof(int) * entry.size);
+        memcpy(_clause_out.begin, cursor.epoch->getLiterals(idx), sizeof(int) * entry.size);
+        _clause_out.size = entry.size;
+        _clause_out.lbd = entry.lbd;
+        _num_pending_epoch_literals -= entry.size;
+        return true;
+    }
+
+    void releaseDoneEpochs() {
+        // Skip excluded clauses at the end of an epoch so that it can be released
+        for (auto it = _epochs.begin(); it != _epochs.end(); ) {
+            auto& cursor = *it;
+            while (cursor.nextUnit < cursor.epoch->getNumUnits() && cursor.isExcluded(cursor.nextUnit)) 
+                cursor.nextUnit++;
+            while (cursor.nextNonunit < cursor.epoch->getNumClauses() && cursor.isExcluded(cursor.nextNonunit)) 
+                cursor.nextNonunit++;
+            if (cursor.done()) it = _epochs.erase(it);
+            else ++it;
+        }
+    }
+
+public:
     ~ImportBuffer() {
         if (_clause_out.begin != nullptr) free(_clause_out.begin);
     }
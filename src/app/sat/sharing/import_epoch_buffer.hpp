@@ -0,0 +1,53 @@
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "buffer/adaptive_clause_database.hpp"
+
+// Read-only clause buffer of a single sharing epoch which is shared by all local
+// solvers (via std::shared_ptr, i.e., reference counting). The buffer is copied
+// exactly once, and each clause is indexed so that each solver's ImportBuffer can
+// traverse the clauses with its own cursor and its own filter bitmap.
+// Literals are only copied again once a solver actually ingests a clause.
+class ImportEpochBuffer {
+
+public:
+    struct Entry {
+        size_t offset;
+        int size;
+        int lbd;
+    };
+
+private:
+    std::vector<int> _data;
+    std::vector<Entry> _entries;
+    size_t _num_units {0};
+
+public:
+    ImportEpochBuffer(std::vector<int>&& data, AdaptiveClauseDatabase& cdb) : _data(std::move(data)) {
+        auto reader = cdb.getBufferReader(_data.data(), _data.size());
+        auto clause = reader.getNextIncomingClause();
+        while (clause.begin != nullptr) {
+            _entries.push_back(Entry{(size_t) (clause.begin - _data.data()), clause.size, clause.lbd});
+            // Unit clauses always form the first bucket
+            if (clause.size == 1) _num_units++;
+            clause = reader.getNextIncomingClause();
+        }
+    }
+
+    size_t getNumClauses() const {return _entries.size();}
+    size_t getNumUnits() const {return _num_units;}
+
+    Mallob::Clause getClause(size_t idx) const {
+        const auto& e = _entries[idx];
+        return Mallob::Clause((int*) _data.data() + e.offset, e.size, e.lbd);
+    }
+    const Entry& getEntry(size_t idx) const {
+        return _entries[idx];
+    }
+    const int* getLiterals(size_t idx) const {
+        return _data.data() + _entries[idx].offset;
+    }
+};
@@ -29,7 +29,8 @@ SharingManager::SharingManager(
 		setup.slotsForSumOfLengthAndLbd = _params.groupClausesByLengthLbdSum();
 		return setup;
 	}()), 
-	_export_buffer(_filter, _cdb, _solver_stats, params.strictClauseLengthLimit()),
+	_export_buffer(_filter, _cdb, _solver_stats, params.strictClauseLengthLimit(), 
+		solvers.size(), params.exportRingSize()),
 	_hist_produced(params.strictClauseLengthLimit()), 
 	_hist_returned_to_db(params.strictClauseLengthLimit()) {
 
@@ -135,6 +136,11 @@ void SharingManager::onProduceClause(int solverId, int solverRevision, const Cla
 
 int SharingManager::prepareSharing(int* begin, int totalLiteralLimit) {
 
+	// Process all produced clauses which were deferred while the filter was busy
+	_export_buffer.flushBacklog();
+	// Forget outdated clauses in a part of the filter
+	_filter.clearExpiredEntries(_internal_epoch);
+
 	int numExportedClauses = 0;
 	auto buffer = _cdb.exportBuffer(totalLiteralLimit, numExportedClauses);
 	//assert(buffer.size() <= maxSize);
@@ -169,7 +175,6 @@ int SharingManager::filterSharing(int* begin, int buflen, int* filterOut) {
 	int nbFiltered = 0;
 	int nbTotal = 0;
 
-	_filter.acquireLock();
 	while (clause.begin != nullptr) {
 		++nbTotal;
 
@@ -189,7 +194,6 @@ int SharingManager::filterSharing(int* begin, int buflen, int* filterOut) {
 		++shift;
 		clause = reader.getNextIncomingClause();
 	}
-	_filter.releaseLock();
 
 	_logger.log(V4_VVER, "filtered %i/%i\n", nbFiltered, nbTotal);
 	return filterPos+1;
@@ -235,76 +239,25 @@ void SharingManager::digestSharingWithFilter(int* begin, int buflen, const int*
 		});
 	}
 
-	// Prepare to traverse clauses not filtered yet
-	std::vector<std::forward_list<int>> unitLists(importingSolvers.size());
-	std::vector<std::forward_list<std::pair<int, int>>> binaryLists(importingSolvers.size());
-	std::vector<std::forward_list<std::vector<int>>> largeLists(importingSolvers.size());
-	std::vector<int> currentCapacities(importingSolvers.size(), -1);
-	std::vector<int> currentAddedLiterals(importingSolvers.size(), 0);
-
-	auto reader = _cdb.getBufferReader(begin, buflen);
-	BufferIterator it(_params.strictClauseLengthLimit(), /*slotsForSumOfLengthAndLbd=*/false);
-	auto clause = reader.getNextIncomingClause();
-	bool explicitLbds = false;
-
-	// Method to publish completed clause lists
-	auto doPublishClauseLists = [&]() {
-		if (it.clauseLength == 1) {
-			// Publish unit lists
-			for (size_t i = 0; i < importingSolvers.size(); i++) {
-				if (!unitLists[i].empty()) {
-					importingSolvers[i]->addLearnedClauses(it.clauseLength, it.lbd, unitLists[i], currentAddedLiterals[i]);
-				}
-			}
-		} else if (it.clauseLength == 2) {
-			// Publish binary lists
-			for (size_t i = 0; i < importingSolvers.size(); i++) {
-				if (!binaryLists[i].empty()) {
-					importingSolvers[i]->addLearnedClauses(it.clauseLength, it.lbd, binaryLists[i], currentAddedLiterals[i]);
-				}
-			}
-		} else {
-			// Publish large lists
-			for (size_t i = 0; i < importingSolvers.size(); i++) {
-				if (!largeLists[i].empty()) {
-					importingSolvers[i]->addLearnedClauses(it.clauseLength, it.lbd, largeLists[i], currentAddedLiterals[i]);
-				}
-			}
-		}
-	};
-
+	// Copy the remaining clauses once into an epoch buffer shared by all solvers
 	_logger.log(verb+2, "DG prepare import\n");
-
-	// Traverse clauses
-	bool initialized = false;
-	_filter.acquireLock();
+	auto epoch = std::make_shared<const ImportEpochBuffer>(std::vector<int>(begin, begin+buflen), _cdb);
+	const size_t numClauses = epoch->getNumClauses();
+
+	// Each solver receives a bitmap of the clauses it should not import
+	std::vector<std::vector<uint64_t>> excluded(importingSolvers.size(), 
+		std::vector<uint64_t>((numClauses+63)/64, 0));
+	std::vector<long> currentCapacities(importingSolvers.size());
+	std::vector<size_t> currentAddedLiterals(importingSolvers.size(), 0);
+	for (size_t i = 0; i < importingSolvers.size(); i++) {
+		currentCapacities[i] = importingSolvers[i]->getEpochImportBudget();
+	}
 
 	_logger.log(verb+2, "DG import\n");
 
-	while (clause.begin != nullptr) {
-		
-		if (!initialized || clause.size != it.clauseLength || clause.lbd != it.lbd) {
-			initialized = true;
-			float publishTime = Timer::elapsedSeconds();
-			_filter.releaseLock();
-
-			doPublishClauseLists();
-
-			while (clause.size != it.clauseLength || clause.lbd != it.lbd) {
-				it.nextLengthLbdGroup();
-				explicitLbds = it.storeWithExplicitLbd(/*maxLbdPartitioningSize=*/2);
-			}
-
-			for (size_t i = 0; i < importingSolvers.size(); i++) {
-				currentCapacities[i] = importingSolvers[i]->getClauseImportBudget(clause.size, clause.lbd);
-				currentAddedLiterals[i] = 0;
-			}
-
-			_filter.acquireLock();
-			publishTime = Timer::elapsedSeconds() - publishTime;
-			_logger.log(verb+2, "DG published clause lists (%.4f s)\n", publishTime);
-		}
+	for (size_t idx = 0; idx < numClauses; idx++) {
 
+		auto clause = epoch->getClause(idx);
 		hist.increment(clause.size);
 		uint8_t producers = _filter.getProducers(clause, _internal_epoch);
 
@@ -316,33 +269,25 @@ void SharingManager::digestSharingWithFilter(int* begin, int buflen, const int*
 			if (currentCapacities[i] < clause.size) {
 				// No import budget left
 				solverStats->receivedClausesDropped++;
+				excluded[i][idx / 64] |= 1UL << (idx % 64);
 				continue;
 			}
-			uint8_t producerFlag = 1 << sid;
 			if ((producers & (1 << sid)) != 0) {
 				// filtered by solver filter
 				solverStats->receivedClausesFiltered++;
+				excluded[i][idx / 64] |= 1UL << (idx % 64);
 				continue;
-			} else {
-				// admitted by solver filter
-				if (clause.size == 1) unitLists[i].push_front(clause.begin[0]);
-				else if (clause.size == 2) binaryLists[i].emplace_front(clause.begin[0], clause.begin[1]);
-				else {
-					std::vector<int> clauseVec((explicitLbds ? 1 : 0) + clause.size);
-					size_t idx = 0;
-					if (explicitLbds) clauseVec[idx++] = clause.lbd;
-					for (size_t k = 0; k < clause.size; k++) clauseVec[idx++] = clause.begin[k];
-					largeLists[i].emplace_front(std::move(clauseVec));
-				}
-				currentCapacities[i] -= clause.size;
-				currentAddedLiterals[i] += clause.size;
 			}
+			// admitted by solver filter
+			currentCapacities[i] -= clause.size;
+			currentAddedLiterals[i] += clause.size;
 		}
+	}
 
-		clause = reader.getNextIncomingClause();
+	// Publish the epoch to the solvers
+	for (size_t i = 0; i < importingSolvers.size(); i++) {
+		importingSolvers[i]->addLearnedClauseEpoch(epoch, std::move(excluded[i]), currentAddedLiterals[i]);
 	}
-	_filter.releaseLock();
-	doPublishClauseLists();
 	
 	// Process-wide stats
 	time = Timer::elapsedSeconds() - time;
@@ -363,6 +308,8 @@ SharingStatistics SharingManager::getStatistics() {
 		_observed_nonunit_lbd_of_length_minus_one, 
 		_observed_nonunit_lbd_of_length);
 	*/
+	_stats.clausesDeferredAtExport = _export_buffer.getNumDeferredClauses();
+	_stats.clausesDroppedAtBacklog = _export_buffer.getNumDroppedFromBacklog();
 	return _stats;
 }
 
@@ -82,9 +82,15 @@ void PortfolioSolverInterface::addLearnedClause(const Mallob::Clause& c) {
 	_import_buffer.add(c);
 }
 
-int PortfolioSolverInterface::getClauseImportBudget(int clauseLength, int lbd) {
+long PortfolioSolverInterface::getEpochImportBudget() {
 	if (_clause_sharing_disabled) return 0;
-	return _import_buffer.getLiteralBudget(clauseLength, lbd);
+	return _import_buffer.getEpochLiteralBudget();
+}
+
+void PortfolioSolverInterface::addLearnedClauseEpoch(const std::shared_ptr<const ImportEpochBuffer>& epoch, 
+		std::vector<uint64_t>&& excluded, size_t numAdmittedLiterals) {
+	if (_clause_sharing_disabled) return;
+	_import_buffer.addEpoch(epoch, std::move(excluded), numAdmittedLiterals);
 }
 
 bool PortfolioSolverInterface::fetchLearnedClause(Mallob::Clause& clauseOut, AdaptiveClauseDatabase::ExportMode mode) {
@@ -1,6 +1,7 @@
 
 #include "collective_assignment.hpp"
 
+#include <algorithm>
 #include "util/assert.hpp"
 
 #include "util/logger.hpp"
@@ -9,18 +10,21 @@
 
 const uint8_t COLL_ASSIGN_STATUS = 1;
 const uint8_t COLL_ASSIGN_REQUESTS = 2;
+const uint8_t COLL_ASSIGN_CLAIMED = 3;
 
 void CollectiveAssignment::handle(MessageHandle& handle) {
     deserialize(handle.getRecvData(), handle.source);
 }
 
 std::vector<uint8_t> CollectiveAssignment::serialize(const Status& status) {
-    std::vector<uint8_t> packed(1 + 2*sizeof(int));
+    std::vector<uint8_t> packed(1 + (2+status.idleRanks.size())*sizeof(int));
     int i = 0, n;
     n = 1; memcpy(packed.data() + i, &COLL_ASSIGN_STATUS, n); i += n;
     n = sizeof(int);
     memcpy(packed.data() + i, &_epoch, n); i += n;
     memcpy(packed.data() + i, &status.numIdle, n); i += n;
+    n = status.idleRanks.size()*sizeof(int);
+    memcpy(packed.data() + i, status.idleRanks.data(), n); i += n;
     return packed;
 }
 
@@ -34,6 +38,17 @@ std::vector<uint8_t> CollectiveAssignment::serialize(const std::vector<JobReques
     return packed;
 }
 
+std::vector<uint8_t> CollectiveAssignment::serializeClaims(const std::vector<int>& claimedRanks) {
+    std::vector<uint8_t> packed(1 + (1+claimedRanks.size())*sizeof(int));
+    int i = 0, n;
+    n = 1; memcpy(packed.data() + i, &COLL_ASSIGN_CLAIMED, n); i += n;
+    n = sizeof(int);
+    memcpy(packed.data() + i, &_epoch, n); i += n;
+    n = claimedRanks.size()*sizeof(int);
+    memcpy(packed.data() + i, claimedRanks.data(), n); i += n;
+    return packed;
+}
+
 void CollectiveAssignment::deserialize(const std::vector<uint8_t>& packed, int source) {
 
     int i = 0;
@@ -55,7 +70,9 @@ void CollectiveAssignment::deserialize(const std::vector<uint8_t>& packed, int s
 
         Status status;
         memcpy(&status.numIdle, packed.data()+i, n); i += n;
-        _child_statuses[source] = status;
+        status.idleRanks.resize((packed.size()-i) / sizeof(int));
+        memcpy(status.idleRanks.data(), packed.data()+i, status.idleRanks.size()*sizeof(int));
+        _child_statuses[source] = std::move(status);
         _status_dirty = true;
 
     } else if (kind == COLL_ASSIGN_REQUESTS) {
@@ -71,30 +88,75 @@ void CollectiveAssignment::deserialize(const std::vector<uint8_t>& packed, int s
             } else LOG_ADD_SRC(V4_VVER, "[CA] DISCARD %s", source, req.toStr().c_str());
             i += n;
         }
+
+    } else if (kind == COLL_ASSIGN_CLAIMED) {
+        // Named idle ranks of this subtree which a PE above has sent a request to
+        
+        int epoch;
+        n = sizeof(int); memcpy(&epoch, packed.data()+i, n); i += n;
+        if (epoch != _epoch) return; // statuses are (or will be) renewed anyway
+
+        robin_hood::unordered_map<int, std::vector<int>> claimsPerChild;
+        while ((size_t) (i+n) <= packed.size()) {
+            int claimedRank;
+            memcpy(&claimedRank, packed.data()+i, n); i += n;
+            LOG_ADD_SRC(V5_DEBG, "[CA] [%i] claimed", source, claimedRank);
+            int child = claim(claimedRank, _child_statuses);
+            if (child >= 0 && child != claimedRank) claimsPerChild[child].push_back(claimedRank);
+        }
+        // Pass the claims further down towards the claimed ranks
+        for (auto& [child, claimedRanks] : claimsPerChild) {
+            MyMpi::isend(child, MSG_NOTIFY_ASSIGNMENT_UPDATE, serializeClaims(claimedRanks));
+        }
+        _status_dirty = true;
     }
 }
 
-int CollectiveAssignment::getDestination() {
-    int destination = -1;
+int CollectiveAssignment::getDestination(int myRank, bool idle, robin_hood::unordered_map<int, Status>& childStatuses, 
+        int* namingChild) {
     // Is there an optimal fit for this request?
     // -- self?
-    if (isIdle()) {
-        // self is optimal fit
-        destination = MyMpi::rank(MPI_COMM_WORLD);
-    } else {
-        // -- other PE? (choose at random)
-        std::vector<int> viableDestinations;
-        for (const auto& [rank, status] : _child_statuses) {
-            if (status.numIdle > 0) {
-                viableDestinations.push_back(rank);
-            }
-        }
-        if (!viableDestinations.empty())
-            destination = Random::choice(viableDestinations);
+    if (idle) return myRank;
+
+    // -- idle PE named by a child? (choose at random)
+    std::vector<int> viableChildren;
+    for (const auto& [rank, status] : childStatuses) {
+        if (!status.idleRanks.empty()) viableChildren.push_back(rank);
+    }
+    if (!viableChildren.empty()) {
+        int child = Random::choice(viableChildren);
+        auto& status = childStatuses[child];
+        int idx = (int) (Random::rand() * status.idleRanks.size());
+        int destination = status.idleRanks[idx];
+        status.idleRanks[idx] = status.idleRanks.back();
+        status.idleRanks.pop_back();
+        status.numIdle--;
+        if (namingChild != nullptr) *namingChild = child;
+        return destination;
+    }
+
+    // -- child with idle PEs in its subtree? (choose at random)
+    for (const auto& [rank, status] : childStatuses) {
+        if (status.numIdle > 0) viableChildren.push_back(rank);
     }
+    if (viableChildren.empty()) return -1;
+    int destination = Random::choice(viableChildren);
+    childStatuses[destination].numIdle--;
     return destination;
 }
 
+int CollectiveAssignment::claim(int claimedRank, robin_hood::unordered_map<int, Status>& childStatuses) {
+    for (auto& [rank, status] : childStatuses) {
+        auto it = std::find(status.idleRanks.begin(), status.idleRanks.end(), claimedRank);
+        if (it == status.idleRanks.end()) continue;
+        *it = status.idleRanks.back();
+        status.idleRanks.pop_back();
+        status.numIdle = std::max(0, status.numIdle-1);
+        return rank;
+    }
+    return -1;
+}
+
 void CollectiveAssignment::resolveRequests() {
 
     if(_request_list.empty()) return;
@@ -106,19 +168,30 @@ void CollectiveAssignment::resolveRequests() {
 
     std::vector<JobRequest> requestsToKeep;
     robin_hood::unordered_map<int, std::vector<JobRequest>> requestsPerDestination;
+    robin_hood::unordered_map<int, std::vector<int>> claimsPerChild;
 
     // TODO if a request is digested locally but fails (e.g. because scheduler is busy),
     // it should not be added concurrently to the request list via addJobRequest.
     // It should be handled separately in some way, and there should be an explicit "retry"
     // as soon as the scheduler is not busy any longer.
 
+    int myRank = MyMpi::rank(MPI_COMM_WORLD);
+    bool idle = isIdle();
     for (const auto& req : _request_list) {
         if (req.balancingEpoch < _epoch && req.requestedNodeIndex > 0) {
             // Obsolete request: Discard
             continue;
         }
-        int id = req.jobId;
-        int destination = getDestination();
+        int namingChild = -1;
+        int destination = getDestination(myRank, idle, _child_statuses, &namingChild);
+        // This PE can digest at most one request
+        if (destination == myRank) idle = false;
+        if (namingChild >= 0) {
+            // A named idle rank is taken: let the PEs below this PE which name it know,
+            // and the PEs above via the next status of this PE
+            if (namingChild != destination) claimsPerChild[namingChild].push_back(destination);
+            _status_dirty = true;
+        }
         if (destination < 0) {
             // No fit found
             if (getCurrentRoot() == MyMpi::rank(MPI_COMM_WORLD)) {
@@ -139,7 +212,6 @@ void CollectiveAssignment::resolveRequests() {
                 LOG_ADD_DEST(V4_VVER, "[CA] Send %s to dest.", destination, 
                     req.toStr().c_str());
                 requestsPerDestination[destination].push_back(req);
-                _child_statuses[destination].numIdle--;
             }
         }
     }
@@ -152,6 +224,9 @@ void CollectiveAssignment::resolveRequests() {
         auto packed = serialize(requests);
         MyMpi::isend(rank, MSG_NOTIFY_ASSIGNMENT_UPDATE, std::move(packed));
     }
+    for (auto& [child, claimedRanks] : claimsPerChild) {
+        MyMpi::isend(child, MSG_NOTIFY_ASSIGNMENT_UPDATE, serializeClaims(claimedRanks));
+    }
 
     resolving = false;
 }
@@ -167,11 +242,27 @@ void CollectiveAssignment::addJobRequest(JobRequest& req) {
 }
 
 CollectiveAssignment::Status CollectiveAssignment::getAggregatedStatus() {
+    return aggregate(MyMpi::rank(MPI_COMM_WORLD), isIdle(), _child_statuses, _max_named_idle_ranks);
+}
+
+CollectiveAssignment::Status CollectiveAssignment::aggregate(int myRank, bool idle, 
+        const robin_hood::unordered_map<int, Status>& childStatuses, size_t maxNamedIdleRanks) {
     Status s;
-    s.numIdle = isIdle() ? 1 : 0;
-    for (auto& [childRank, childStatus] : _child_statuses) {
+    s.numIdle = idle ? 1 : 0;
+    if (idle && maxNamedIdleRanks > 0) s.idleRanks.push_back(myRank);
+    for (auto& [childRank, childStatus] : childStatuses) {
         s.numIdle += childStatus.numIdle;
     }
+    // Name idle ranks of all children in a round-robin fashion
+    for (size_t i = 0; s.idleRanks.size() < maxNamedIdleRanks; i++) {
+        bool anyLeft = false;
+        for (auto& [childRank, childStatus] : childStatuses) {
+            if (i >= childStatus.idleRanks.size()) continue;
+            anyLeft = true;
+            if (s.idleRanks.size() < maxNamedIdleRanks) s.idleRanks.push_back(childStatus.idleRanks[i]);
+        }
+        if (!anyLeft) break;
+    }
     return s;
 }
 
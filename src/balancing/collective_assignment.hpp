@@ -12,14 +12,20 @@ class JobDatabase; // forward declaration
 
 class CollectiveAssignment {
 
+public:
+    // Idle PEs in the subtree of some PE. A few of them are named explicitly
+    // so that requests can be sent to them directly instead of descending the tree.
+    struct Status {
+        int numIdle = 0;
+        std::vector<int> idleRanks;
+    };
+
 private:
     JobDatabase* _job_db = nullptr;
     std::function<void(const JobRequest&, int)> _local_request_callback;
     
-    struct Status {
-        int numIdle;
-    };
     robin_hood::unordered_map<int, Status> _child_statuses;
+    size_t _max_named_idle_ranks = 0;
     std::set<JobRequest> _request_list;
 
     int _num_workers;
@@ -31,15 +37,16 @@ private:
 public:
     CollectiveAssignment() {}
     CollectiveAssignment(JobDatabase& jobDb, int numWorkers, std::vector<int>&& neighborTowardsRank, 
-    std::function<void(const JobRequest&, int)> localRequestCallback) : 
-        _job_db(&jobDb), _local_request_callback(localRequestCallback), _num_workers(numWorkers), 
-        _neighbor_towards_rank(std::move(neighborTowardsRank)) {}
+    size_t maxNamedIdleRanks, std::function<void(const JobRequest&, int)> localRequestCallback) : 
+        _job_db(&jobDb), _local_request_callback(localRequestCallback), _max_named_idle_ranks(maxNamedIdleRanks),
+        _num_workers(numWorkers), _neighbor_towards_rank(std::move(neighborTowardsRank)) {}
 
     void handle(MessageHandle& handle);
 
     Status getAggregatedStatus();
     std::vector<uint8_t> serialize(const Status& status);
     std::vector<uint8_t> serialize(const std::vector<JobRequest>& requests);
+    std::vector<uint8_t> serializeClaims(const std::vector<int>& claimedRanks);
     void deserialize(const std::vector<uint8_t>& packed, int source);
 
     void setStatusDirty();
@@ -54,8 +61,17 @@ public:
 
     bool isIdle();
 
-private:
-    int getDestination();
+    // Status of the subtree of this PE, naming up to the given number of idle ranks.
+    static Status aggregate(int myRank, bool idle, const robin_hood::unordered_map<int, Status>& childStatuses, 
+        size_t maxNamedIdleRanks);
+    // Where to send a request: this PE if idle, else an idle PE named by some child,
+    // else a child with idle PEs in its subtree, else -1. Accounts for the choice in the statuses.
+    // If the destination is a named idle PE, the child which named it is written to namingChild.
+    static int getDestination(int myRank, bool idle, robin_hood::unordered_map<int, Status>& childStatuses, 
+        int* namingChild = nullptr);
+    // Removes a named idle PE which was handed out elsewhere from the child status naming it
+    // (and counts it as busy). Returns the rank of this child, or -1 if no child names the PE.
+    static int claim(int claimedRank, robin_hood::unordered_map<int, Status>& childStatuses);
 
 };
 
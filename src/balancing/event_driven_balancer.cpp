@@ -4,10 +4,10 @@
 #include "event_driven_balancer.hpp"
 #include "util/random.hpp"
 #include "app/job.hpp"
-#include "volume_calculator.hpp"
 #include "util/data_statistics.hpp"
 
-EventDrivenBalancer::EventDrivenBalancer(MPI_Comm& comm, Parameters& params) : _comm(comm), _params(params) {
+EventDrivenBalancer::EventDrivenBalancer(MPI_Comm& comm, Parameters& params) : _comm(comm), _params(params),
+        _volume_calc(params, MyMpi::size(comm), /*logging=*/MyMpi::rank(comm) == 0) {
 
     int size = MyMpi::size(_comm);
     int myRank = MyMpi::rank(_comm);
@@ -208,7 +208,11 @@ void EventDrivenBalancer::digest(const EventMap& data) {
     LOG(V5_DEBG, "BLC DIGEST data=%s\n", data.toStr().c_str());
     LOG(V5_DEBG, "BLC DIGEST states_pre=%s\n", _states.toStr().c_str());
 
-    _states.updateBy(data);
+    // Only the novel events need to be re-sorted into the volume calculation
+    for (const auto& [jobId, ev] : data.getEntries()) {
+        if (_states.insertIfNovel(ev)) _volume_calc.update(ev);
+    }
+    _states.setGlobalEpoch(std::max(_states.getGlobalEpoch(), data.getGlobalEpoch()));
     _balancing_epoch = data.getGlobalEpoch();
 
     LOG(V5_DEBG, "BLC DIGEST states_post=%s\n", _states.toStr().c_str());
@@ -221,7 +225,7 @@ void EventDrivenBalancer::digest(const EventMap& data) {
 
     LOG(V5_DEBG, "BLC digest %i diffs, %i/%i local diffs remaining\n", 
             data.getEntries().size(), _diffs.getEntries().size(), diffSize);
-    _states.removeOldZeros();
+    for (int jobId : _states.removeOldZeros()) _volume_calc.remove(jobId);
 }
 
 void EventDrivenBalancer::computeBalancingResult() {
@@ -235,11 +239,10 @@ void EventDrivenBalancer::computeBalancingResult() {
 
     if (rank == 0) LOG(V5_DEBG, "BLC: calc result\n");
 
-    VolumeCalculator calc(_states, _params, MyMpi::size(_comm), /*logging=*/rank == 0);
-    calc.calculateResult();
+    _volume_calc.calculateResult();
 
     std::string msg = "";
-    for (const auto& entry : calc.getEntries()) {
+    for (const auto& entry : _volume_calc.getEntries()) {
         if (rank == 0)
             msg += std::to_string(entry.jobId) + ":" + std::to_string(entry.volume) + " ";
         
@@ -268,7 +271,7 @@ void EventDrivenBalancer::computeBalancingResult() {
     }
 
     // also call callback for all jobs whose volume became zero
-    for (const auto& entry : calc.getZeroEntries()) {
+    for (const auto& entry : _volume_calc.getZeroEntries()) {
         if (_local_jobs.count(entry.jobId))
             _volume_update_callback(entry.jobId, 0, 0);
     }
@@ -12,6 +12,7 @@
 #include "data/reduceable.hpp"
 #include "util/logger.hpp"
 #include "balancing/event_map.hpp"
+#include "balancing/volume_calculator.hpp"
 #include "util/periodic_event.hpp"
 
 class Job;
@@ -47,6 +48,8 @@ private:
 
     EventMap _states;
     EventMap _diffs;
+    // Incrementally updated with each digested diff
+    VolumeCalculator _volume_calc;
     PeriodicEvent<10> _periodic_balancing;
     int _balancing_epoch = 0;
 
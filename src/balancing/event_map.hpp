@@ -39,34 +39,53 @@ private:
     size_t _global_epoch = 0;
     std::map<int, Event> _map;
 
-    const int _size_per_event = 3*sizeof(int)+sizeof(float);
-
 public:
+    // Compact encoding of the (usually few) events which changed since the last
+    // globally agreed state: Events are written in the order of their job IDs,
+    // each job ID as the difference to the previous job ID, the epoch and the demand
+    // as variable-length integers, and the priority only if it differs from the
+    // previous event's priority (flagged in the lowest bit of the encoded demand).
+    // Most events then occupy a few bytes instead of 16.
     virtual std::vector<uint8_t> serialize() const override {
-        std::vector<uint8_t> result(sizeof(size_t) + _map.size() * _size_per_event);
-        int i = 0, n;
-        n = sizeof(size_t); memcpy(result.data()+i, &_global_epoch, n); i += n;
-        for (const auto& entry : _map) {
-            n = sizeof(int); memcpy(result.data()+i, &entry.second.jobId, n); i += n;
-            n = sizeof(int); memcpy(result.data()+i, &entry.second.epoch, n); i += n;
-            n = sizeof(int); memcpy(result.data()+i, &entry.second.demand, n); i += n;
-            n = sizeof(float); memcpy(result.data()+i, &entry.second.priority, n); i += n;
+        std::vector<uint8_t> result(sizeof(size_t));
+        result.reserve(sizeof(size_t) + _map.size() * 8);
+        memcpy(result.data(), &_global_epoch, sizeof(size_t));
+        uint32_t prevJobId = 0;
+        float prevPriority = 0;
+        for (const auto& [jobId, ev] : _map) {
+            writeVarInt(result, (uint32_t) ev.jobId - prevJobId);
+            writeVarInt(result, (uint32_t) ev.epoch);
+            bool newPriority = ev.priority != prevPriority;
+            writeVarInt(result, (((uint64_t) (uint32_t) ev.demand) << 1) | (newPriority ? 1 : 0));
+            if (newPriority) {
+                size_t i = result.size();
+                result.resize(i + sizeof(float));
+                memcpy(result.data()+i, &ev.priority, sizeof(float));
+            }
+            prevJobId = ev.jobId;
+            prevPriority = ev.priority;
         }
         return result;
     }
     virtual EventMap& deserialize(const std::vector<uint8_t>& packed) override {
         _map.clear();
-        int numEvents = (packed.size()-sizeof(size_t)) / _size_per_event;
-        int i = 0, n;
-        n = sizeof(size_t); memcpy(&_global_epoch, packed.data()+i, n); i += n;
-        if (packed.size() <= sizeof(size_t)+sizeof(int)) return *this;
-        for (int ev = 0; ev < numEvents; ev++) {
+        size_t i = 0;
+        memcpy(&_global_epoch, packed.data(), sizeof(size_t)); i += sizeof(size_t);
+        uint32_t prevJobId = 0;
+        float prevPriority = 0;
+        while (i < packed.size()) {
             Event newEvent;
-            n = sizeof(int); memcpy(&newEvent.jobId, packed.data()+i, n); i += n;
-            n = sizeof(int); memcpy(&newEvent.epoch, packed.data()+i, n); i += n;
-            n = sizeof(int); memcpy(&newEvent.demand, packed.data()+i, n); i += n;
-            n = sizeof(float); memcpy(&newEvent.priority, packed.data()+i, n); i += n;
-            _map[newEvent.jobId] = newEvent;
+            newEvent.jobId = (int) (prevJobId + (uint32_t) readVarInt(packed, i));
+            newEvent.epoch = (int) (uint32_t) readVarInt(packed, i);
+            uint64_t demandAndFlag = readVarInt(packed, i);
+            newEvent.demand = (int) (uint32_t) (demandAndFlag >> 1);
+            newEvent.priority = prevPriority;
+            if (demandAndFlag & 1) {
+                memcpy(&newEvent.priority, packed.data()+i, sizeof(float)); i += sizeof(float);
+            }
+            prevJobId = newEvent.jobId;
+            prevPriority = newEvent.priority;
+            _map.emplace_hint(_map.end(), newEvent.jobId, newEvent);
         }
         return *this;
     }
@@ -205,6 +224,25 @@ public:
         out += "}";
         return out;
     }
+
+private:
+    static void writeVarInt(std::vector<uint8_t>& out, uint64_t val) {
+        while (val >= 128) {
+            out.push_back((uint8_t) (val | 128));
+            val >>= 7;
+        }
+        out.push_back((uint8_t) val);
+    }
+    static uint64_t readVarInt(const std::vector<uint8_t>& in, size_t& i) {
+        uint64_t val = 0;
+        int shift = 0;
+        while (in[i] & 128) {
+            val |= ((uint64_t) (in[i++] & 127)) << shift;
+            shift += 7;
+        }
+        val |= ((uint64_t) in[i++]) << shift;
+        return val;
+    }
 };
 
 #endif
@@ -0,0 +1,181 @@
+
+#include "region_router.hpp"
+
+#include <algorithm>
+#include <new>
+#include <sys/mman.h>
+
+#include "comm/host_comm.hpp"
+#include "util/sys/shared_memory.hpp"
+#include "util/random.hpp"
+#include "util/logger.hpp"
+#include "util/assert.hpp"
+
+RegionRouter::RegionRouter(int myRank, const std::vector<int>& regionOfRank, std::atomic<uint8_t>* idleBoard, 
+        std::atomic_int* boardVersion) {
+    setup(myRank, regionOfRank, idleBoard, boardVersion);
+}
+
+void RegionRouter::setup(int myRank, const std::vector<int>& regionOfRank, std::atomic<uint8_t>* idleBoard, 
+        std::atomic_int* boardVersion) {
+    _my_rank = myRank;
+    _region_of_rank = regionOfRank;
+    int numRegions = 1 + *std::max_element(regionOfRank.begin(), regionOfRank.end());
+    _ranks_of_region.assign(numRegions, std::vector<int>());
+    for (size_t rank = 0; rank < regionOfRank.size(); rank++) {
+        if ((int) rank == myRank) _my_index_in_region = _ranks_of_region[regionOfRank[rank]].size();
+        _ranks_of_region[regionOfRank[rank]].push_back(rank);
+    }
+    _my_region = regionOfRank[myRank];
+    _idle_board = idleBoard;
+    _board_version = boardVersion;
+    _idle_counts.resize(numRegions, 0);
+    _versions.resize(numRegions, 0);
+}
+
+RegionRouter::~RegionRouter() {
+    if (!_board_specifier.empty()) munmap((void*) _board_version, _board_size);
+}
+
+void RegionRouter::init(MPI_Comm comm) {
+
+    int myRank, numRanks;
+    MPI_Comm_rank(comm, &myRank);
+    MPI_Comm_size(comm, &numRanks);
+
+    // A region consists of all processes which can share memory with each other,
+    // identified by its smallest rank
+    std::vector<int> hostRanks;
+    MPI_Comm hostComm = HostComm::splitBySharedMemory(comm, hostRanks);
+    int leader = hostRanks.front();
+    std::vector<int> leaders(numRanks);
+    MPI_Allgather(&leader, 1, MPI_INT, leaders.data(), 1, MPI_INT, comm);
+    std::vector<int> sortedLeaders = leaders;
+    std::sort(sortedLeaders.begin(), sortedLeaders.end());
+    sortedLeaders.erase(std::unique(sortedLeaders.begin(), sortedLeaders.end()), sortedLeaders.end());
+    std::vector<int> regionOfRank(numRanks);
+    for (int rank = 0; rank < numRanks; rank++) {
+        regionOfRank[rank] = std::lower_bound(sortedLeaders.begin(), sortedLeaders.end(), leaders[rank])
+            - sortedLeaders.begin();
+    }
+
+    std::string specifier = HostComm::getSharedMemoryPrefix(comm, "idle") + std::to_string(leader);
+
+    // The region's smallest rank creates the idle board, then all others attach to it.
+    // The board begins with its version, followed by the idle flags on the next cache line.
+    int regionSize = hostRanks.size();
+    const size_t flagsOffset = 64;
+    size_t boardSize = flagsOffset + regionSize * sizeof(std::atomic<uint8_t>);
+    void* mem = nullptr;
+    if (myRank == leader) {
+        mem = SharedMemory::create(specifier, boardSize);
+        new (mem) std::atomic_int(0);
+        for (int i = 0; i < regionSize; i++) 
+            new (((std::atomic<uint8_t>*) ((uint8_t*) mem + flagsOffset)) + i) std::atomic<uint8_t>(0);
+    }
+    MPI_Barrier(hostComm);
+    if (myRank != leader) mem = SharedMemory::access(specifier, boardSize);
+    MPI_Barrier(hostComm);
+    if (myRank == leader) shm_unlink(specifier.c_str());
+    MPI_Comm_free(&hostComm);
+    if (mem == nullptr) {
+        LOG(V1_WARN, "[WARN] Cannot access idle board of region %i\n", leader);
+        return;
+    }
+
+    setup(myRank, regionOfRank, (std::atomic<uint8_t>*) ((uint8_t*) mem + flagsOffset), (std::atomic_int*) mem);
+    _board_specifier = specifier;
+    _board_size = boardSize;
+    LOG(V3_VERB, "Region routing: region %i of %i, %i processes\n",
+        _my_region, getNumRegions(), regionSize);
+}
+
+void RegionRouter::setIdle(bool idle) {
+    _idle_board[_my_index_in_region].store(idle ? 1 : 0, std::memory_order_relaxed);
+}
+
+void RegionRouter::updateLocalRegion() {
+    // Draw the version before reading the flags: a process of this region which
+    // draws a higher version does not begin to read the flags before this process
+    _versions[_my_region] = 1 + _board_version->fetch_add(1, std::memory_order_acq_rel);
+    int count = 0;
+    for (size_t i = 0; i < _ranks_of_region[_my_region].size(); i++)
+        count += _idle_board[i].load(std::memory_order_relaxed);
+    _idle_counts[_my_region] = count;
+}
+
+std::vector<int> RegionRouter::getSummary() const {
+    std::vector<int> summary(2*_idle_counts.size());
+    for (size_t r = 0; r < _idle_counts.size(); r++) {
+        summary[2*r] = _versions[r];
+        summary[2*r+1] = _idle_counts[r];
+    }
+    return summary;
+}
+
+void RegionRouter::mergeSummary(const std::vector<int>& summary) {
+    if (summary.size() != 2*_idle_counts.size()) return;
+    for (size_t r = 0; r < _idle_counts.size(); r++) {
+        // This region's own information is always the most recent
+        if ((int) r == _my_region || summary[2*r] <= _versions[r]) continue;
+        _versions[r] = summary[2*r];
+        _idle_counts[r] = summary[2*r+1];
+    }
+}
+
+int RegionRouter::route(int requestingRank, int senderRank) {
+
+    // Prefer the region of the requesting process so that a job's tree nodes share a host
+    int requestingRegion = _region_of_rank[requestingRank];
+    if (requestingRegion != _my_region && _idle_counts[requestingRegion] > 0) {
+        _idle_counts[requestingRegion]--;
+        return pickInRegion(requestingRegion, requestingRank, senderRank);
+    }
+
+    // Idle process in this region?
+    int rank = pickIdleInThisRegion(requestingRank, senderRank);
+    if (rank >= 0) return rank;
+
+    // Pick some other region with probability proportional to its number of idle workers
+    long sum = 0;
+    for (int r = 0; r < getNumRegions(); r++) {
+        if (r != _my_region) sum += std::max(0, _idle_counts[r]);
+    }
+    if (sum == 0) return -1;
+    long pick = (long) (Random::rand() * sum);
+    for (int r = 0; r < getNumRegions(); r++) {
+        if (r == _my_region || _idle_counts[r] <= 0) continue;
+        if (pick < _idle_counts[r]) {
+            // Account for this request until the region reports again
+            _idle_counts[r]--;
+            return pickInRegion(r, requestingRank, senderRank);
+        }
+        pick -= _idle_counts[r];
+    }
+    return -1;
+}
+
+int RegionRouter::pickIdleInThisRegion(int requestingRank, int senderRank) {
+    const auto& ranks = _ranks_of_region[_my_region];
+    std::vector<int> candidates;
+    for (size_t i = 0; i < ranks.size(); i++) {
+        int rank = ranks[i];
+        if (rank == _my_rank || rank == requestingRank || rank == senderRank) continue;
+        if (_idle_board[i].load(std::memory_order_relaxed)) candidates.push_back(i);
+    }
+    if (candidates.empty()) return -1;
+    int idx = candidates[(int) (Random::rand() * candidates.size())];
+    // Do not send further requests to this process until it reports to be idle again
+    _idle_board[idx].store(0, std::memory_order_relaxed);
+    return ranks[idx];
+}
+
+int RegionRouter::pickInRegion(int region, int requestingRank, int senderRank) {
+    const auto& ranks = _ranks_of_region[region];
+    std::vector<int> candidates;
+    for (int rank : ranks) {
+        if (rank != requestingRank && rank != senderRank) candidates.push_back(rank);
+    }
+    if (candidates.empty()) return ranks[(int) (Random::rand() * ranks.size())];
+    return candidates[(int) (Random::rand() * candidates.size())];
+}
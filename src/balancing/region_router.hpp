@@ -0,0 +1,79 @@
+
+#ifndef DOMPASCH_MALLOB_REGION_ROUTER_HPP
+#define DOMPASCH_MALLOB_REGION_ROUTER_HPP
+
+#include <atomic>
+#include <vector>
+#include <string>
+
+#include "comm/mpi_base.hpp"
+
+// Steers job requests towards regions of the rank space which likely contain idle workers.
+// A region is the set of worker processes on one host. Within its own region, a process
+// knows which processes are idle from a board of idle flags in shared memory. The number
+// of idle workers in other regions is estimated from a summary which the processes gossip
+// to each other periodically: each entry carries a version from a counter on the region's
+// board which every process of the region increments whenever it reads the board,
+// so newer information always replaces older information.
+class RegionRouter {
+
+private:
+    int _my_rank {-1};
+    int _my_region {-1};
+    std::vector<int> _region_of_rank;
+    std::vector<std::vector<int>> _ranks_of_region;
+    int _my_index_in_region {-1};
+
+    // One flag per process of this region and the version of the region's information
+    std::atomic<uint8_t>* _idle_board {nullptr};
+    std::atomic_int* _board_version {nullptr};
+    std::string _board_specifier;
+    size_t _board_size {0};
+
+    // Per region: estimated number of idle workers, version of the estimate
+    std::vector<int> _idle_counts;
+    std::vector<int> _versions;
+
+public:
+    RegionRouter() = default;
+    // Region i consists of all ranks r with regionOfRank[r] == i.
+    // The idle board must hold one flag per process in this process' region,
+    // and the board version must be shared by all processes of the region.
+    RegionRouter(int myRank, const std::vector<int>& regionOfRank, std::atomic<uint8_t>* idleBoard, 
+        std::atomic_int* boardVersion);
+    ~RegionRouter();
+
+    RegionRouter(const RegionRouter&) = delete;
+    RegionRouter& operator=(const RegionRouter&) = delete;
+
+    // Collective operation over the provided communicator of workers:
+    // determines the regions and sets up the idle board of each region.
+    void init(MPI_Comm comm);
+    bool isInitialized() const {return _my_rank >= 0;}
+
+    void setIdle(bool idle);
+
+    // Re-reads the idle board of this region into the summary (as a new version).
+    void updateLocalRegion();
+    // Summary to gossip: (version, #idle workers) for each region.
+    std::vector<int> getSummary() const;
+    void mergeSummary(const std::vector<int>& summary);
+
+    // Returns a rank to forward a job request of the given requesting rank to,
+    // or -1 if no region is known to contain idle workers. Prefers the requesting
+    // rank's region, then this rank's region, then any region weighted by its
+    // estimated number of idle workers.
+    int route(int requestingRank, int senderRank);
+
+    int getNumRegions() const {return _ranks_of_region.size();}
+    int getRegion(int rank) const {return _region_of_rank[rank];}
+    int getEstimatedIdleCount(int region) const {return _idle_counts[region];}
+
+private:
+    void setup(int myRank, const std::vector<int>& regionOfRank, std::atomic<uint8_t>* idleBoard, 
+        std::atomic_int* boardVersion);
+    int pickIdleInThisRegion(int requestingRank, int senderRank);
+    int pickInRegion(int region, int requestingRank, int senderRank);
+};
+
+#endif
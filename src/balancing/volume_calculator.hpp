@@ -7,20 +7,48 @@
 #include <cmath>
 #include <list>
 #include <algorithm>
+#include <map>
+#include <set>
 
 #include "util/assert.hpp"
 #include "util/params.hpp"
 #include "balancing/event_map.hpp"
 #include "balancing/balancing_entry.hpp"
+#include "util/hashing.hpp"
 //#include "util/math/chandrupatla.hpp"
 
 class VolumeCalculator {
 
 private:
+    struct EntryComparatorByPriority {
+        bool operator()(const BalancingEntry& first, const BalancingEntry& second) const {
+            // Highest priority first
+            if (first.priority != second.priority) 
+                return first.priority > second.priority;
+            // Highest demand first
+            if (first.originalDemand != second.originalDemand) 
+                return first.originalDemand > second.originalDemand;
+            // Break ties pseudo-randomly (yet deterministically) via hash of job ID
+            auto firstHash = robin_hood::hash_int(first.jobId);
+            auto secondHash = robin_hood::hash_int(second.jobId);
+            if (firstHash != secondHash) return firstHash < secondHash;
+            // Break ties via job ID
+            return first.jobId < second.jobId;
+        }
+    };
+
     Parameters& _params;
+
+    // Persistent state, updated incrementally via update() and remove():
+    // all jobs with a positive demand in the order in which they are balanced
+    // and all jobs without demand in the order of their IDs
+    std::set<BalancingEntry, EntryComparatorByPriority> _sorted_entries;
+    robin_hood::unordered_map<int, BalancingEntry> _entry_of_job;
+    std::map<int, BalancingEntry> _zero_entries_of_job;
+
+    // Working copies of the above for a single calculation
     std::vector<BalancingEntry> _entries;
     std::vector<BalancingEntry> _zero_entries;
-    int _epoch;
     int _num_workers;
     bool _logging;
 
@@ -39,28 +67,61 @@ private:
     int _max_volume_diff_between_bounds = 0;
 
 public:
-    VolumeCalculator(const EventMap& events, Parameters& params, int numWorkers, bool logging) : 
-            _params(params), _epoch(events.getGlobalEpoch()), _num_workers(numWorkers),
-            _logging(logging) {
+    VolumeCalculator(Parameters& params, int numWorkers, bool logging) : 
+            _params(params), _num_workers(numWorkers), _logging(logging) {
+        _available_volume = _num_workers * _params.loadFactor();
+    }
 
-        // For each event
+    VolumeCalculator(const EventMap& events, Parameters& params, int numWorkers, bool logging) : 
+            VolumeCalculator(params, numWorkers, logging) {
         if (_logging) LOG(V5_DEBG, "BLC Collecting %i entries\n", events.getEntries().size());
-        _entries.reserve(events.getEntries().size());
-        for (const auto& [jobId, ev] : events.getEntries()) {
-            assert(ev.demand >= 0);
-            if (ev.demand == 0) _zero_entries.emplace_back(ev.jobId, ev.demand, ev.priority); // job has no demand
-            else {
-                assert((ev.priority > 0) || LOG_RETURN_FALSE("#%i has priority %.2f!\n", ev.jobId, ev.priority));
-                _entries.emplace_back(ev.jobId, ev.demand, ev.priority);
-                _sum_of_priorities += ev.priority;
-            }
+        update(events);
+    }
+
+    // Incorporates all events of the given map, each of which replaces
+    // the current entry of the respective job (if any).
+    void update(const EventMap& events) {
+        for (const auto& [jobId, ev] : events.getEntries()) update(ev);
+    }
+
+    void update(const Event& ev) {
+        remove(ev.jobId);
+        assert(ev.demand >= 0);
+        if (ev.demand == 0) {
+            // job has no demand
+            _zero_entries_of_job.emplace(ev.jobId, BalancingEntry(ev.jobId, ev.demand, ev.priority));
+        } else {
+            assert((ev.priority > 0) || LOG_RETURN_FALSE("#%i has priority %.2f!\n", ev.jobId, ev.priority));
+            BalancingEntry entry(ev.jobId, ev.demand, ev.priority);
+            _sorted_entries.insert(entry);
+            _entry_of_job.emplace(ev.jobId, entry);
         }
+    }
 
-        _available_volume = _num_workers * _params.loadFactor();
+    void remove(int jobId) {
+        auto it = _entry_of_job.find(jobId);
+        if (it != _entry_of_job.end()) {
+            _sorted_entries.erase(it->second);
+            _entry_of_job.erase(it);
+        }
+        _zero_entries_of_job.erase(jobId);
+    }
+
+    size_t getNumJobs() const {
+        return _entry_of_job.size() + _zero_entries_of_job.size();
     }
 
     void calculateResult() {
 
+        // Fetch the current (already sorted) entries
+        _entries.assign(_sorted_entries.begin(), _sorted_entries.end());
+        _zero_entries.clear();
+        for (const auto& [jobId, entry] : _zero_entries_of_job) _zero_entries.push_back(entry);
+        _sum_of_priorities = 0;
+        for (const auto& entry : _entries) _sum_of_priorities += entry.priority;
+        _sum_of_demands = 0;
+        _num_dismissed_jobs = 0;
+
         // Check if there are enough workers for the active jobs
         if (_logging) LOG(V5_DEBG, "BLC #av=%i #j=%i\n", _available_volume, _entries.size());
         if (_available_volume <= _entries.size()) {
@@ -68,7 +129,6 @@ public:
             return;
         }
 
-        sortRemainingEntries();
         computeFairShares();
 
         // Trivial case: every job receives its full demand
@@ -91,23 +151,6 @@ public:
 
 private:
 
-    struct EntryComparatorByPriority {
-        bool operator()(const BalancingEntry& first, const BalancingEntry& second) const {
-            // Highest priority first
-            if (first.priority != second.priority) 
-                return first.priority > second.priority;
-            // Highest demand first
-            if (first.originalDemand != second.originalDemand) 
-                return first.originalDemand > second.originalDemand;
-            // Break ties pseudo-randomly (yet deterministically) via hash of job ID
-            auto firstHash = robin_hood::hash_int(first.jobId);
-            auto secondHash = robin_hood::hash_int(second.jobId);
-            if (firstHash != secondHash) return firstHash < secondHash;
-            // Break ties via job ID
-            return first.jobId < second.jobId;
-        }
-    };
-
     void sortRemainingEntries() {
         std::sort(_entries.begin()+_num_dismissed_jobs, _entries.end(), EntryComparatorByPriority());
     }
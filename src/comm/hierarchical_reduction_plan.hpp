@@ -0,0 +1,112 @@
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+#include "util/hashing.hpp"
+
+// Two-level all-reduction tree over a fixed set of job tree nodes, each given
+// by its job tree index, its world rank, and the ID of its host: On each host,
+// the node with the lowest index is the host's representative, and all other
+// nodes on the host are its direct children. The representatives form a binary
+// tree among themselves (ordered by index) which is rooted at index 0.
+// Each node's parent has a lower index than the node itself. Hence, if a job
+// shrinks (i.e., all nodes beyond a certain index leave), no remaining node
+// depends on a departed node.
+class HierarchicalReductionPlan {
+
+public:
+    struct Member {
+        int index;
+        int rank;
+        int host;
+    };
+
+private:
+    std::vector<Member> _members; // sorted by index
+    robin_hood::unordered_flat_map<int, size_t> _pos_of_rank;
+    std::vector<int> _parent_pos;
+    std::vector<std::vector<int>> _child_pos;
+    int _num_hosts = 0;
+
+public:
+    static void appendMember(std::vector<int>& flatMembers, int index, int rank, int host) {
+        flatMembers.push_back(index);
+        flatMembers.push_back(rank);
+        flatMembers.push_back(host);
+    }
+
+    HierarchicalReductionPlan() = default;
+    HierarchicalReductionPlan(const std::vector<int>& flatMembers) {
+
+        for (size_t i = 0; i+2 < flatMembers.size(); i += 3) {
+            _members.push_back(Member{flatMembers[i], flatMembers[i+1], flatMembers[i+2]});
+        }
+        std::sort(_members.begin(), _members.end(), [](const Member& a, const Member& b) {
+            return a.index < b.index;
+        });
+        for (size_t i = 0; i < _members.size(); i++) _pos_of_rank[_members[i].rank] = i;
+        _parent_pos.resize(_members.size(), -1);
+        _child_pos.resize(_members.size());
+
+        // Representative of each host: the first member (lowest index) on the host
+        robin_hood::unordered_flat_map<int, int> repPosOfHost;
+        std::vector<int> repPositions;
+        for (size_t i = 0; i < _members.size(); i++) {
+            auto it = repPosOfHost.find(_members[i].host);
+            if (it == repPosOfHost.end()) {
+                repPosOfHost[_members[i].host] = i;
+                repPositions.push_back(i);
+            } else {
+                // Host-local member: child of its representative
+                _parent_pos[i] = it->second;
+                _child_pos[it->second].push_back(i);
+            }
+        }
+        _num_hosts = repPositions.size();
+
+        // Binary tree over all representatives
+        for (size_t k = 1; k < repPositions.size(); k++) {
+            int parent = repPositions[(k-1)/2];
+            _parent_pos[repPositions[k]] = parent;
+            _child_pos[parent].push_back(repPositions[k]);
+        }
+    }
+
+    bool contains(int rank) const {return _pos_of_rank.count(rank);}
+    int getIndex(int rank) const {return _members[_pos_of_rank.at(rank)].index;}
+    size_t size() const {return _members.size();}
+    int getNumHosts() const {return _num_hosts;}
+
+    // -1 for the root
+    int getParentRank(int rank) const {
+        int parentPos = _parent_pos[_pos_of_rank.at(rank)];
+        return parentPos < 0 ? -1 : _members[parentPos].rank;
+    }
+
+    std::vector<int> getChildRanks(int rank) const {
+        std::vector<int> ranks;
+        for (int pos : _child_pos[_pos_of_rank.at(rank)]) ranks.push_back(_members[pos].rank);
+        return ranks;
+    }
+
+    // For each member within the job tree's subtree below the given index (inclusive)
+    // whose parent is outside of this subtree, returns the pair (member rank, parent rank).
+    std::vector<std::pair<int, int>> getMembersDetachedBelow(int index) const {
+        std::vector<std::pair<int, int>> result;
+        for (size_t i = 0; i < _members.size(); i++) {
+            if (!isInJobSubtree(_members[i].index, index)) continue;
+            int parentPos = _parent_pos[i];
+            if (parentPos < 0 || isInJobSubtree(_members[parentPos].index, index)) continue;
+            result.emplace_back(_members[i].rank, _members[parentPos].rank);
+        }
+        return result;
+    }
+
+private:
+    static bool isInJobSubtree(int index, int subtreeRootIndex) {
+        while (index > subtreeRootIndex) index = (index-1)/2;
+        return index == subtreeRootIndex;
+    }
+};
@@ -36,12 +36,45 @@ private:
     int _active_job_index = -1;
     float _last_contributed_criticality = 0;
 
+    static inline int _host_id = -1;
+    static inline robin_hood::unordered_set<int> _world_ranks_on_host;
+
 public:
     HostComm(MPI_Comm parentComm, const Parameters& params) : _params(params), _parent_comm(parentComm) {}
     ~HostComm() {
         if (_sysstate != nullptr) delete _sysstate;
     }
 
+    // Identifier of the host of this process which is shared by all processes
+    // on the same host, or -1 if it has not been determined (yet).
+    static int getHostId() {return _host_id;}
+    // Whether the process of the given world rank runs on the same host as this process.
+    static bool isOnThisHost(int worldRank) {return _world_ranks_on_host.count(worldRank);}
+    // World ranks of all processes on the same host as this process (including itself).
+    static std::vector<int> getWorldRanksOnHost() {
+        return std::vector<int>(_world_ranks_on_host.begin(), _world_ranks_on_host.end());
+    }
+
+    // Collective operation over the given communicator: returns a communicator of all its
+    // processes which can share memory with this process (to be freed by the caller)
+    // and writes their ranks within the given communicator, in ascending order, to ranks.
+    static MPI_Comm splitBySharedMemory(MPI_Comm comm, std::vector<int>& ranks) {
+        int myRank = MyMpi::rank(comm);
+        MPI_Comm sharedComm;
+        MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, myRank, MPI_INFO_NULL, &sharedComm);
+        ranks.resize(MyMpi::size(sharedComm));
+        MPI_Allgather(&myRank, 1, MPI_INT, ranks.data(), 1, MPI_INT, sharedComm);
+        return sharedComm;
+    }
+
+    // Collective operation over the given communicator: returns a prefix for the names of
+    // shared memory segments which is the same for all its processes and unique for this run.
+    static std::string getSharedMemoryPrefix(MPI_Comm comm, const std::string& purpose) {
+        long runId = Proc::getPid();
+        MPI_Bcast(&runId, 1, MPI_LONG, 0, comm);
+        return "/mallob." + purpose + "." + std::to_string(runId) + ".";
+    }
+
     void depositInformation() {
         if (_parent_comm == MPI_COMM_NULL) return;
         // Regular layout? -> No deposit of information necessary.
@@ -69,7 +102,6 @@ public:
         } else {
             // List temporary files and extract corresponding ranks
             auto files = FileUtils::glob(_base_filename + "*");
-            int nbWorkersThisMachine = files.size();
             static constexpr ctll::fixed_string REGEX_COLLEAGUE_RECOGNITION = 
                 ctll::fixed_string{ "(/tmp/mallob\\.colleaguerecognition\\.[0-9a-f]+\\.)([0-9\\.]+)" };
             int minRank = MyMpi::size(MPI_COMM_WORLD);
@@ -85,6 +117,13 @@ public:
 
         // Create communicator using the minimum found rank as its "color"
         MPI_Comm_split(_parent_comm, color, MyMpi::rank(_parent_comm), &_comm);
+        _host_id = color;
+
+        // Remember the world ranks of all processes on this host
+        int myWorldRank = MyMpi::rank(MPI_COMM_WORLD);
+        std::vector<int> worldRanks(MyMpi::size(_comm));
+        MPI_Allgather(&myWorldRank, 1, MPI_INT, worldRanks.data(), 1, MPI_INT, _comm);
+        _world_ranks_on_host.insert(worldRanks.begin(), worldRanks.end());
 
         LOG(V2_INFO, "Machine color %i with %i total workers (my rank: %i)\n", 
             color, MyMpi::size(_comm), MyMpi::rank(_comm));
@@ -127,7 +166,7 @@ public:
         struct ProcessInfo {size_t procIdx; float usedMem; float utility;};
         std::vector<ProcessInfo> processInfo;
         size_t i = 0;
-        for (size_t procIdx = 0; procIdx < MyMpi::size(_comm); procIdx++) {
+        for (size_t procIdx = 0; procIdx < (size_t) MyMpi::size(_comm); procIdx++) {
             // Extract data
             float procUsedMem = memoryInformation[i+SYSSTATE_PROCESS_USED_MEMORY];
             float workerIndex = memoryInformation[i+SYSSTATE_WORKER_INDEX];
@@ -168,7 +207,7 @@ public:
             if (info.utility <= 0) break;
             machineMinFreeMem += 0.5 * info.usedMem;
             LOG(V3_VERB, "Enable memory panic for proc. %i on this machine (util=%.4f)\n", info.procIdx, info.utility);
-            if (info.procIdx == MyMpi::rank(_comm)) {
+            if (info.procIdx == (size_t) MyMpi::rank(_comm)) {
                 // That's me!
                 return true;
             }
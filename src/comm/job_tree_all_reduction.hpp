@@ -11,22 +11,44 @@ class JobTreeAllReduction {
 
 public:
     typedef std::vector<int> AllReduceElement;
+    typedef std::function<std::vector<AllReduceElement>(AllReduceElement&&)> Splitter;
+    typedef std::function<AllReduceElement(std::vector<AllReduceElement>&&)> Joiner;
 
 private:
     JobTree& _tree;
     JobMessage _base_msg;
     AllReduceElement _neutral_elem;
+
+    // Pipelined mode (see setPipelining): Each element consists of this many
+    // segments which are aggregated, sent, and broadcast one after the other.
+    int _num_segments = 1;
+    Splitter _splitter;
+    Joiner _joiner;
     
-    std::optional<AllReduceElement> _local_elem;
-    std::list<AllReduceElement> _child_elems;
-    int _num_expected_child_elems;
-    IntPair _expected_child_ranks;
-    std::pair<bool, bool> _received_child_elems;
+    std::vector<AllReduceElement> _local_segments;
+    bool _has_local_elem = false;
+    // Received elements and received-flags for each expected child, per segment
+    std::vector<std::list<AllReduceElement>> _child_elems;
+    std::vector<std::vector<bool>> _received_child_elems;
+    size_t _num_expected_child_elems;
+    std::vector<int> _expected_child_ranks;
+
+    // Alternative tree structure which replaces the job tree (see setTopology)
+    bool _custom_topology = false;
+    bool _topology_pending = false;
+    int _custom_parent_rank = -1;
+    std::list<std::pair<int, AllReduceElement>> _deferred_child_elems;
 
     bool _aggregating = false;
     std::future<void> _future_aggregate;
     std::function<AllReduceElement(std::list<AllReduceElement>&)> _aggregator;
     std::optional<AllReduceElement> _aggregated_elem;
+    int _num_aggregated_segments = 0;
+
+    // Segments of the final result
+    std::vector<AllReduceElement> _final_segments;
+    std::vector<bool> _received_final_segments;
+    int _num_final_segments = 0;
 
     bool _has_transformation_at_root = false;
     std::function<AllReduceElement(const AllReduceElement&)> _transformation_at_root;
@@ -42,10 +64,50 @@ public:
         _tree(jobTree), _base_msg(baseMsg), _neutral_elem(std::move(neutralElem)), 
         _num_expected_child_elems(_tree.getNumChildren()), _aggregator(aggregator) {
 
-        int leftRank = _tree.hasLeftChild() ? _tree.getLeftChildNodeRank() : -1;
-        int rightRank = _tree.hasRightChild() ? _tree.getRightChildNodeRank() : -1;
-        _expected_child_ranks = IntPair(leftRank, rightRank);
-        _received_child_elems = std::pair<bool, bool>(false, false);
+        if (_tree.hasLeftChild()) _expected_child_ranks.push_back(_tree.getLeftChildNodeRank());
+        if (_tree.hasRightChild()) _expected_child_ranks.push_back(_tree.getRightChildNodeRank());
+        resetSegments();
+    }
+
+    // Pipeline this all-reduction: Each element (including the neutral element) is
+    // split into numSegments segments via the splitter. Segments are aggregated one
+    // at a time in increasing order, and each aggregated segment is sent upwards
+    // (or broadcast, at the root) right away. As such, the reduction of a segment
+    // overlaps with the reduction and the broadcast of its predecessors across the
+    // levels of the tree. The aggregator must be applicable to each segment on its
+    // own, and any transformation at the root is applied to each segment. 
+    // The final segments are combined via the joiner.
+    // Must be called before producing or receiving any elements.
+    void setPipelining(int numSegments, Splitter splitter, Joiner joiner) {
+        assert(!_has_producer);
+        assert(numSegments >= 1);
+        _num_segments = numSegments;
+        _splitter = splitter;
+        _joiner = joiner;
+        resetSegments();
+    }
+
+    // Announce that the structure of this all-reduction will be set via setTopology.
+    // Until then, incoming elements are deferred and nothing is aggregated.
+    void awaitTopology() {
+        _topology_pending = true;
+    }
+
+    // Perform this all-reduction along the given tree instead of the job tree.
+    // parentRank is -1 for the root.
+    void setTopology(int parentRank, std::vector<int>&& childRanks) {
+        _custom_topology = true;
+        _topology_pending = false;
+        _custom_parent_rank = parentRank;
+        _expected_child_ranks = std::move(childRanks);
+        _num_expected_child_elems = _expected_child_ranks.size();
+        for (auto& received : _received_child_elems) received.assign(_expected_child_ranks.size(), false);
+
+        // Process elements which arrived in the meantime
+        auto deferred = std::move(_deferred_child_elems);
+        _deferred_child_elems.clear();
+        for (auto& [source, elem] : deferred) acceptChildElem(source, std::move(elem));
+        advance();
     }
 
     // Set the function to compute the local contribution for the all-reduction.
@@ -53,7 +115,8 @@ public:
     void produce(std::function<AllReduceElement()> localProducer) {
         assert(!_has_producer);
         _has_producer = true;
-        _local_elem = localProducer();
+        _local_segments = split(localProducer());
+        _has_local_elem = true;
     }
 
     void setTransformationOfElementAtRoot(std::function<AllReduceElement(const AllReduceElement&)> transformation) {
@@ -74,24 +137,22 @@ public:
 
         if (tag == MSG_JOB_TREE_REDUCTION) {
 
-            if (_aggregating || _future_aggregate.valid() || _reduction_locally_done) 
-                return false; // already internally aggregating elements (or already done)!
-
-            // check if this message comes from a child which didn't already send something
-            bool fromLeftChild = !_received_child_elems.first && source == _expected_child_ranks.first;
-            bool fromRightChild = !_received_child_elems.second && source == _expected_child_ranks.second;
-            accept &= fromLeftChild || fromRightChild;
-            if (!accept) return false;
-            
-            // message accepted: store and check off
-            _child_elems.push_back(std::move(msg.payload));
-            if (fromLeftChild) _received_child_elems.first = true;
-            if (fromRightChild) _received_child_elems.second = true;
-            LOG_ADD_SRC(V5_DEBG, "CS got %i/%i elems", source, _child_elems.size(), _num_expected_child_elems);
+            if (_reduction_locally_done) 
+                return false; // already done!
+
+            if (_topology_pending) {
+                // The children of this node are not known yet
+                _deferred_child_elems.emplace_back(source, std::move(msg.payload));
+                return true;
+            }
+
+            if (!acceptChildElem(source, std::move(msg.payload))) return false;
             advance();
         }
         if (tag == MSG_JOB_TREE_BROADCAST) {
-            receiveAndForwardFinalElem(std::move(msg.payload));
+            int segment = 0;
+            if (!popSegmentIndex(msg.payload, segment)) return false;
+            receiveAndForwardFinalSegment(segment, std::move(msg.payload));
         }
         return true;
     }
@@ -100,38 +161,44 @@ public:
     // or the aggregation function finished. No-op if getResult() was already called.
     void advance() {
 
-        if (_finished) return;
+        if (_finished || _topology_pending) return;
 
-        if (_child_elems.size() == _num_expected_child_elems && _local_elem.has_value()) {
-             
-            _child_elems.push_front(std::move(_local_elem.value()));
-            _local_elem.reset();
-
-            assert(!_future_aggregate.valid());
-            _aggregating = true;
-            _future_aggregate = ProcessWideThreadPool::get().addTask([&]() {
-                _aggregated_elem = _aggregator(_child_elems);
-                _aggregating = false;
-            });
-        }
+        while (true) {
+
+            const int segment = _num_aggregated_segments;
+            if (!_future_aggregate.valid() && segment < _num_segments && _has_local_elem
+                    && _child_elems[segment].size() == _num_expected_child_elems) {
+                
+                _child_elems[segment].push_front(std::move(_local_segments[segment]));
+
+                _aggregating = true;
+                _future_aggregate = ProcessWideThreadPool::get().addTask([&, segment]() {
+                    _aggregated_elem = _aggregator(_child_elems[segment]);
+                    _aggregating = false;
+                });
+            }
+
+            if (_aggregating || !_future_aggregate.valid()) break;
 
-        if (!_aggregating && _future_aggregate.valid()) {
             // Aggregation done
             _future_aggregate.get();
-            _reduction_locally_done = true;
-            
-            if (_tree.isRoot()) {
+            _child_elems[segment].clear();
+            _num_aggregated_segments++;
+            _reduction_locally_done = _num_aggregated_segments == _num_segments;
+
+            if (isRoot()) {
                 // Transform reduced element at root
                 if (_has_transformation_at_root) {
                     _aggregated_elem.emplace(_transformation_at_root(_aggregated_elem.value()));
                 }
                 // Begin broadcast
-                receiveAndForwardFinalElem(std::move(_aggregated_elem.value()));
+                receiveAndForwardFinalSegment(segment, std::move(_aggregated_elem.value()));
             } else {
                 // Send to parent
-                _base_msg.payload = std::move(_aggregated_elem.value());
-                MyMpi::isend(_tree.getParentNodeRank(), MSG_JOB_TREE_REDUCTION, _base_msg);
+                sendUpwards(segment, std::move(_aggregated_elem.value()));
             }
+            _aggregated_elem.reset();
+            // Proceed with the next segment, if possible
         }
     }
 
@@ -139,16 +206,37 @@ public:
 
         if (_finished) return;
 
-        if (!_reduction_locally_done) {
-            // Aggregation upwards was not performed yet: Send neutral element upwards
-            _base_msg.payload = _neutral_elem;
-            MyMpi::isend(_tree.getParentNodeRank(), MSG_JOB_TREE_REDUCTION, _base_msg);
+        if (!_reduction_locally_done && !_topology_pending && getParentRank() >= 0) {
+            // Aggregation upwards was not performed yet: Send neutral element
+            // (or each neutral segment not sent yet) upwards
+            auto neutralSegments = split(AllReduceElement(_neutral_elem));
+            for (int segment = _num_aggregated_segments; segment < _num_segments; segment++) {
+                sendUpwards(segment, std::move(neutralSegments[segment]));
+            }
         }
         // finished but not valid
         _finished = true;
         _valid = false;
     }
 
+    // Account for a child which will not contribute anything (e.g., since it left the job).
+    bool receiveNeutralElement(int source) {
+        bool accepted = false;
+        auto neutralSegments = split(AllReduceElement(_neutral_elem));
+        for (int segment = 0; segment < _num_segments; segment++) {
+            JobMessage msg = _base_msg;
+            msg.payload = std::move(neutralSegments[segment]);
+            if (_num_segments > 1) msg.payload.push_back(segment);
+            accepted |= receive(source, MSG_JOB_TREE_REDUCTION, msg);
+        }
+        return accepted;
+    }
+
+    bool isRoot() const {
+        return _custom_topology ? _custom_parent_rank < 0 : _tree.isRoot();
+    }
+    size_t getNumChildren() const {return _expected_child_ranks.size();}
+
     bool hasProducer() const {return _has_producer;}
     bool isValid() const {return _valid;}
 
@@ -160,7 +248,8 @@ public:
     AllReduceElement extractResult() {
         assert(hasResult());
         _valid = false;
-        return std::move(_base_msg.payload);
+        if (_num_segments == 1) return std::move(_final_segments.front());
+        return _joiner(std::move(_final_segments));
     }
 
     // Whether this object can be destructed at this point in time 
@@ -179,13 +268,78 @@ public:
     }
 
 private:
-    void receiveAndForwardFinalElem(AllReduceElement&& elem) {
-        _finished = true;
+    int getParentRank() const {
+        return _custom_topology ? _custom_parent_rank : _tree.getParentNodeRank();
+    }
+
+    void resetSegments() {
+        _child_elems.assign(_num_segments, std::list<AllReduceElement>());
+        _received_child_elems.assign(_num_segments, std::vector<bool>(_expected_child_ranks.size(), false));
+        _final_segments.assign(_num_segments, AllReduceElement());
+        _received_final_segments.assign(_num_segments, false);
+    }
+
+    std::vector<AllReduceElement> split(AllReduceElement&& elem) {
+        if (_num_segments == 1) {
+            std::vector<AllReduceElement> segments;
+            segments.push_back(std::move(elem));
+            return segments;
+        }
+        auto segments = _splitter(std::move(elem));
+        assert(segments.size() == (size_t) _num_segments);
+        return segments;
+    }
+
+    // In pipelined mode, each message carries the index of its segment as the last integer.
+    bool popSegmentIndex(AllReduceElement& payload, int& segment) const {
+        segment = 0;
+        if (_num_segments == 1) return true;
+        if (payload.empty()) return false;
+        segment = payload.back();
+        payload.pop_back();
+        return segment >= 0 && segment < _num_segments;
+    }
+
+    void sendUpwards(int segment, AllReduceElement&& elem) {
+        _base_msg.payload = std::move(elem);
+        if (_num_segments > 1) _base_msg.payload.push_back(segment);
+        MyMpi::isend(getParentRank(), MSG_JOB_TREE_REDUCTION, _base_msg);
+        _base_msg.payload.clear();
+    }
+
+    bool acceptChildElem(int source, AllReduceElement&& elem) {
+        int segment;
+        if (!popSegmentIndex(elem, segment)) return false;
+        // already internally aggregating this segment (or already done)?
+        if (segment < _num_aggregated_segments 
+            || (segment == _num_aggregated_segments && _future_aggregate.valid()))
+            return false;
+        // check if this element comes from a child which didn't already send something
+        auto& received = _received_child_elems[segment];
+        for (size_t i = 0; i < _expected_child_ranks.size(); i++) {
+            if (received[i] || _expected_child_ranks[i] != source) continue;
+            // element accepted: store and check off
+            _child_elems[segment].push_back(std::move(elem));
+            received[i] = true;
+            LOG_ADD_SRC(V5_DEBG, "CS got %i/%i elems (segment %i)", source, 
+                _child_elems[segment].size(), _num_expected_child_elems, segment);
+            return true;
+        }
+        return false;
+    }
+
+    void receiveAndForwardFinalSegment(int segment, AllReduceElement&& elem) {
+        if (_received_final_segments[segment]) return;
         _base_msg.payload = std::move(elem);
-        if (_expected_child_ranks.first >= 0) 
-            MyMpi::isend(_expected_child_ranks.first, MSG_JOB_TREE_BROADCAST, _base_msg);
-        if (_expected_child_ranks.second >= 0) 
-            MyMpi::isend(_expected_child_ranks.second, MSG_JOB_TREE_BROADCAST, _base_msg);
+        if (_num_segments > 1) _base_msg.payload.push_back(segment);
+        for (int childRank : _expected_child_ranks)
+            MyMpi::isend(childRank, MSG_JOB_TREE_BROADCAST, _base_msg);
+        if (_num_segments > 1) _base_msg.payload.pop_back();
+        _final_segments[segment] = std::move(_base_msg.payload);
+        _base_msg.payload.clear();
+        _received_final_segments[segment] = true;
+        _num_final_segments++;
+        if (_num_final_segments == _num_segments) _finished = true;
     }
 
 };
@@ -0,0 +1,77 @@
+
+#include "comm/message_metrics.hpp"
+
+#include <algorithm>
+
+#include "comm/mpi_base.hpp"
+#include "comm/host_comm.hpp"
+#include "util/json.hpp"
+#include "util/sys/timer.hpp"
+
+void MessageMetrics::init() {
+    MPI_Comm_rank(MPI_COMM_WORLD, &_my_rank);
+    int size;
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    // Identify each host by the lowest world rank residing on it
+    std::vector<int> hostRanks;
+    MPI_Comm hostComm = HostComm::splitBySharedMemory(MPI_COMM_WORLD, hostRanks);
+    MPI_Comm_free(&hostComm);
+    int hostId = hostRanks.front();
+    _host_of_rank.resize(size);
+    MPI_Allgather(&hostId, 1, MPI_INT, _host_of_rank.data(), 1, MPI_INT, MPI_COMM_WORLD);
+
+    _period_start = Timer::elapsedSeconds();
+}
+
+std::string MessageMetrics::toJsonLine() const {
+
+    auto countersToJson = [](const Counters* counters) {
+        nlohmann::json j;
+        for (int p = 0; p < NUM_PEER_CLASSES; p++) {
+            j["msgs"].push_back(counters[p].numMessages);
+            j["bytes"].push_back(counters[p].numBytes);
+            j["frags"].push_back(counters[p].numFragments);
+        }
+        return j;
+    };
+    auto histogramToJson = [](const LatencyHistogram& hist) {
+        nlohmann::json j;
+        j["n"] = hist.getNumEntries();
+        j["sum"] = hist.getSum();
+        j["max"] = hist.getMax();
+        j["hist_log2_us"] = hist.getBuckets();
+        return j;
+    };
+
+    std::vector<int> tags;
+    for (auto& [tag, m] : _metrics) tags.push_back(tag);
+    std::sort(tags.begin(), tags.end());
+
+    float time = Timer::elapsedSeconds();
+    nlohmann::json out;
+    out["rank"] = _my_rank;
+    out["time"] = time;
+    out["period"] = time - _period_start;
+    out["peer_classes"] = {"self", "host", "remote"};
+    out["tags"] = nlohmann::json::array();
+    for (int tag : tags) {
+        const auto& m = _metrics.at(tag);
+        nlohmann::json j;
+        j["tag"] = tag;
+        j["sent"] = countersToJson(m.sent);
+        j["received"] = countersToJson(m.received);
+        j["send_latency"] = histogramToJson(m.sendLatency);
+        j["callback_time"] = histogramToJson(m.callbackTime);
+        out["tags"].push_back(std::move(j));
+    }
+    return out.dump();
+}
+
+void MessageMetrics::reset() {
+    _metrics.clear();
+    _num_messages = 0;
+    _num_bytes = 0;
+    _callback_time = 0;
+    _period_start = Timer::elapsedSeconds();
+}
@@ -0,0 +1,87 @@
+
+#ifndef DOMPASCH_MALLOB_MESSAGE_METRICS_HPP
+#define DOMPASCH_MALLOB_MESSAGE_METRICS_HPP
+
+#include <string>
+#include <vector>
+
+#include "util/hashing.hpp"
+#include "util/latency_histogram.hpp"
+
+// Live counters of the message traffic of this process per message tag
+// and per class of peer (this process itself, a process on the same host,
+// or a process on another host), along with the latency until each send
+// completes and the time spent in the callback of each received message.
+// All methods are meant to be called from the main thread.
+class MessageMetrics {
+
+public:
+    enum PeerClass {PEER_SELF, PEER_HOST, PEER_REMOTE, NUM_PEER_CLASSES};
+
+    struct Counters {
+        unsigned long numMessages {0};
+        unsigned long numBytes {0};
+        unsigned long numFragments {0};
+    };
+    struct TagMetrics {
+        Counters sent[NUM_PEER_CLASSES];
+        Counters received[NUM_PEER_CLASSES];
+        LatencyHistogram sendLatency;
+        LatencyHistogram callbackTime;
+    };
+
+private:
+    int _my_rank {0};
+    std::vector<int> _host_of_rank;
+    robin_hood::unordered_map<int, TagMetrics> _metrics;
+    float _period_start {0};
+
+    // Totals since the last reset
+    unsigned long _num_messages {0};
+    unsigned long _num_bytes {0};
+    double _callback_time {0};
+
+public:
+    // Collective operation over MPI_COMM_WORLD: finds out which ranks share a host.
+    void init();
+
+    PeerClass getPeerClass(int rank) const {
+        if (rank == _my_rank) return PEER_SELF;
+        if ((size_t) rank < _host_of_rank.size() && _host_of_rank[rank] == _host_of_rank[_my_rank]) return PEER_HOST;
+        return PEER_REMOTE;
+    }
+
+    void addSent(int tag, int dest, size_t numBytes, int numFragments = 0) {
+        auto& c = _metrics[tag].sent[getPeerClass(dest)];
+        c.numMessages++;
+        c.numBytes += numBytes;
+        c.numFragments += numFragments;
+        _num_messages++;
+        _num_bytes += numBytes;
+    }
+    void addReceived(int tag, int source, size_t numBytes, int numFragments = 0) {
+        auto& c = _metrics[tag].received[getPeerClass(source)];
+        c.numMessages++;
+        c.numBytes += numBytes;
+        c.numFragments += numFragments;
+        _num_messages++;
+        _num_bytes += numBytes;
+    }
+    void addSendLatency(int tag, double seconds) {
+        _metrics[tag].sendLatency.add(seconds);
+    }
+    void addCallbackTime(int tag, double seconds) {
+        _metrics[tag].callbackTime.add(seconds);
+        _callback_time += seconds;
+    }
+
+    unsigned long getNumMessages() const {return _num_messages;}
+    unsigned long getNumBytes() const {return _num_bytes;}
+    double getCallbackTime() const {return _callback_time;}
+
+    // One line of JSON with all metrics since the last reset.
+    std::string toJsonLine() const;
+    void reset();
+};
+
+#endif
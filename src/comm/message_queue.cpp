@@ -12,21 +12,49 @@
 #include "util/sys/background_worker.hpp"
 #include "util/logger.hpp"
 #include "comm/msgtags.h"
+#include "util/sys/timer.hpp"
 
-MessageQueue::MessageQueue(int maxMsgSize) : _max_msg_size(maxMsgSize) {
+MessageQueue::MessageQueue(int maxMsgSize, int numReceiveSlots) : _max_msg_size(maxMsgSize), 
+        _recv_buffer_size(maxMsgSize+20), _min_handover_size(_recv_buffer_size - _recv_buffer_size/4) {
     
     MPI_Comm_rank(MPI_COMM_WORLD, &_my_rank);
-    _recv_data = (uint8_t*) malloc(maxMsgSize+20);
 
     _current_recv_tag = &_default_tag_var;
     _current_send_tag = &_default_tag_var;
 
-    resetReceiveHandle();
+    // Pre-post all receives
+    _recv_slots.resize(numReceiveSlots);
+    _recv_requests.resize(numReceiveSlots, MPI_REQUEST_NULL);
+    _completed_indices.resize(numReceiveSlots);
+    _completed_statuses.resize(numReceiveSlots);
+    for (size_t i = 0; i < _recv_slots.size(); i++) {
+        _recv_slots[i].data.resize(_recv_buffer_size);
+        postReceive(i);
+        _recycled_buffers.emplace_back(_recv_buffer_size);
+    }
+    _recv_stats.startTime = Timer::elapsedSeconds();
+
+    // Separate communicator for the fragments of large messages
+    // so that they are never matched by the above receives
+    MPI_Comm_dup(MPI_COMM_WORLD, &_fragment_comm);
+    int* tagUpperBound; int flag;
+    MPI_Comm_get_attr(_fragment_comm, MPI_TAG_UB, &tagUpperBound, &flag);
+    _max_fragment_tag = flag ? *tagUpperBound : 32767;
+
+    _metrics.init();
+
+    // Small scheduling messages are prioritized
+    for (int tag : {MSG_REQUEST_NODE, MSG_REQUEST_NODE_ONESHOT, MSG_REJECT_ONESHOT, 
+            MSG_OFFER_ADOPTION, MSG_OFFER_ADOPTION_OF_ROOT, MSG_ANSWER_ADOPTION_OFFER, 
+            MSG_QUERY_VOLUME, MSG_NOTIFY_VOLUME_UPDATE, MSG_REQUEST_WORK, 
+            MSG_COLLECTIVE_OPERATION, MSG_REDUCE_DATA, MSG_BROADCAST_DATA, 
+            MSG_SCHED_INITIALIZE_CHILD_WITH_NODES, MSG_SCHED_RETURN_NODES, 
+            MSG_SCHED_RELEASE_FROM_WAITING, MSG_SCHED_NODE_FREED, 
+            MSG_NOTIFY_NEIGHBOR_STATUS, MSG_NOTIFY_NEIGHBOR_IDLE_DISTANCE, 
+            MSG_REQUEST_IDLE_NODE_BFS, MSG_ANSWER_IDLE_NODE_BFS, MSG_NOTIFY_ASSIGNMENT_UPDATE}) {
+        setTagPriority(tag, PRIORITY_CONTROL);
+    }
 
-    _batch_assembler.run([&]() {
-        Proc::nameThisThread("MsgAssembler");
-        runFragmentedMessageAssembler();
-    });
     _gc.run([&]() {
         Proc::nameThisThread("MsgGarbColl");
         runGarbageCollector();
@@ -34,9 +62,8 @@ MessageQueue::MessageQueue(int maxMsgSize) : _max_msg_size(maxMsgSize) {
 }
 
 MessageQueue::~MessageQueue() {
-    _batch_assembler.stop();
+    stopProgressThread();
     _gc.stop();
-    free(_recv_data);
 }
 
 void MessageQueue::registerCallback(int tag, const MsgCallback& cb) {
@@ -65,8 +92,11 @@ int MessageQueue::send(DataPtr data, int dest, int tag) {
     *_current_send_tag = tag;
 
     // Initialize send handle
+    int id = _running_send_id++;
     {
-        SendHandle handle(_running_send_id++, dest, tag, data, _max_msg_size);
+        SendHandle handle(id, dest, tag, data, _max_msg_size, _fragment_comm, id % (_max_fragment_tag+1));
+        handle.creationTime = Timer::elapsedSeconds();
+        _metrics.addSent(tag, dest, data->size(), handle.isBatched() ? handle.totalNumBatches : 0);
 
         int msglen = handle.data->size();
         LOG(V5_DEBG, "MQ SEND n=%i d=[%i] t=%i c=(%i,...,%i,%i,%i)\n", handle.data->size(), dest, tag, 
@@ -81,100 +111,221 @@ int MessageQueue::send(DataPtr data, int dest, int tag) {
             return _self_recv_queue.back().id;
         }
 
-        _send_queue.push_back(std::move(handle));
+        if (_progress_thread_active.load(std::memory_order_relaxed)) {
+            // Leave the message to the progress thread
+            OutgoingRequest req {new SendHandle(std::move(handle)), -1};
+            while (!_outbox.tryPush(std::move(req))) usleep(10);
+        } else {
+            enqueueSend(std::move(handle));
+        }
     }
 
-    SendHandle& h = _send_queue.back();
-    if (_num_concurrent_sends < _max_concurrent_sends) {
-        h.sendNext();
-        _num_concurrent_sends++;
+    *_current_send_tag = 0;
+    return id;
+}
+
+void MessageQueue::enqueueSend(SendHandle&& handle) {
+
+    handle.priority = getPriority(handle);
+
+    if (usesSharedMemory(handle)) {
+        auto it = _shmem_backlog.find(handle.dest);
+        bool backlogged = it != _shmem_backlog.end() && !it->second.empty();
+        if (!backlogged && _shmem.trySend(handle.dest, handle.tag, *handle.data)) {
+            _shmem_sent.push_back(std::move(handle));
+        } else {
+            // Keep the order of messages to this destination
+            // (the message may have been written partially already)
+            _shmem_backlog[handle.dest].push_back(std::move(handle));
+            _num_shmem_backlog++;
+        }
+        return;
     }
 
-    *_current_send_tag = 0;
-    return h.id;
+    auto& queue = _send_queues[handle.priority];
+    queue.push_back(std::move(handle));
+
+    SendHandle& h = queue.back();
+    if (canInitiate(h)) {
+        initiate(h);
+    } else if (h.priority == PRIORITY_DEFAULT) {
+        _num_queued_default_sends[h.dest]++;
+    }
 }
 
 void MessageQueue::cancelSend(int sendId) {
 
-    for (auto& h : _send_queue) {
+    if (_progress_thread_active.load(std::memory_order_relaxed)) {
+        OutgoingRequest req {nullptr, sendId};
+        while (!_outbox.tryPush(std::move(req))) usleep(10);
+    } else {
+        cancelQueuedSend(sendId);
+    }
+}
+
+void MessageQueue::cancelQueuedSend(int sendId) {
+
+    for (auto& queue : _send_queues) for (auto& h : queue) {
         if (h.id != sendId) continue;
 
         // Found fitting handle
         h.cancel();
-        break;
+        return;
     }
 }
 
 void MessageQueue::advance() {
     //log(V5_DEBG, "BEGADV\n");
     _iteration++;
+    if (_progress_thread_active.load(std::memory_order_acquire)) {
+        // All MPI operations are performed by the progress thread:
+        // only execute the callbacks of what it has delivered
+        processInbox();
+        processSelfReceived();
+        return;
+    }
+    // Take over anything a previous progress thread left behind
+    flushInboxOverflow();
+    collectReturnedBuffers();
+    processInbox();
+    processOutbox();
     processReceived();
     processSelfReceived();
-    processAssembledReceived();
+    processFragmentedReceived();
     processSent();
+    processSharedMemory();
     //log(V5_DEBG, "ENDADV\n");
 }
 
-void MessageQueue::runFragmentedMessageAssembler() {
+void MessageQueue::enableSharedMemoryTransport(size_t ringBytes) {
+    assert(!_progress_thread_active);
+    // Larger messages are streamed through the rings, but each ring should be able
+    // to hold many small messages at once
+    _shmem.init(std::max(ringBytes, (size_t) (1<<16)));
+}
 
-    while (_batch_assembler.continueRunning()) {
+bool MessageQueue::usesSharedMemory(const SendHandle& h) {
+    // All control and default messages to a reachable destination take the same ring
+    // (regardless of their size) so that they cannot be overtaken by MPI messages
+    return _shmem.isEnabled() && h.priority != PRIORITY_BULK && _shmem.canReach(h.dest);
+}
 
-        _fragmented_cond_var.wait(_fragmented_mutex, [&]() {return !_fragmented_queue.empty();});
+void MessageQueue::processSharedMemory() {
 
-        ReceiveFragment data;
-        {
-            if (!_fragmented_mutex.tryLock()) continue;
-            if (_fragmented_queue.empty()) {
-                _fragmented_mutex.unlock();
-                continue;
-            }
-            data = std::move(_fragmented_queue.front());
-            _fragmented_queue.pop_front();
-            _fragmented_mutex.unlock();
-        }
-        if (data.dataFragments.empty()) continue;
-
-        if (data.isCancelled()) {
-            // Receive message was cancelled in between batches: 
-            // concurrently clean up any fragments already received
-            auto lock = _garbage_mutex.getLock();
-            int numFragments = 0;
-            for (auto& frag : data.dataFragments) if (frag != nullptr) {
-                std::vector<uint8_t>* ptr = frag.release();
-                _garbage_queue.push_back(DataPtr(ptr));
-                atomics::incrementRelaxed(_num_garbage);
-                numFragments++;
-            }
-            LOG(V4_VVER, "MSG id=%i cancelled (%i fragments)\n", data.id, numFragments);
-            continue;
+    if (!_shmem.isEnabled()) return;
+
+    // Retry writing messages which did not fit into their ring
+    if (_num_shmem_backlog > 0) for (auto& [dest, backlog] : _shmem_backlog) {
+        while (!backlog.empty()) {
+            auto& h = backlog.front();
+            if (!_shmem.trySend(h.dest, h.tag, *h.data)) break;
+            _shmem_sent.splice(_shmem_sent.end(), backlog, backlog.begin());
+            _num_shmem_backlog--;
         }
+    }
 
-        // Assemble fragments
+    // Report written messages as sent
+    // (moved out first since callbacks may send further messages)
+    auto sent = std::move(_shmem_sent);
+    _shmem_sent.clear();
+    for (auto& h : sent) completeSend(h);
+
+    // Receive messages (up to x in order to stay responsive)
+    _shmem.receive(_num_receives_per_loop, [&](int source, int tag, std::vector<uint8_t>&& data) {
+        LOG(V5_DEBG, "MQ RECV SHM n=%i s=[%i] t=%i\n", data.size(), source, tag);
+        _recv_stats.numMessages++;
+        _recv_stats.numBytes += data.size();
+        _recv_stats.numShmem++;
         MessageHandle h;
-        h.source = data.source;
-        h.tag = data.tag;
-        size_t sumOfSizes = 0;
-        for (size_t i = 0; i < data.dataFragments.size(); i++) {
-            const auto& frag = data.dataFragments[i];
-            assert(frag || LOG_RETURN_FALSE("No valid fragment %i found!\n", i));
-            sumOfSizes += frag->size();
+        h.tag = tag;
+        h.source = source;
+        h.setReceive(std::move(data));
+        deliverReceived(std::move(h), 0);
+    });
+}
+
+void MessageQueue::startProgressThread(int sleepMicros) {
+    if (_progress_thread_active) return;
+    _progress_thread_active = true;
+    _progress_thread.run([&, sleepMicros]() {
+        Proc::nameThisThread("MsgProgress");
+        runProgressThread(sleepMicros);
+    });
+    LOG(V3_VERB, "MQ progress thread started\n");
+}
+
+void MessageQueue::stopProgressThread() {
+    if (!_progress_thread_active) return;
+    _progress_thread_active = false;
+    _progress_thread.stop();
+}
+
+void MessageQueue::runProgressThread(int sleepMicros) {
+
+    while (_progress_thread_active.load(std::memory_order_relaxed)) {
+        unsigned long numEventsBefore = _num_progress_events;
+        bool outboxEmpty;
+        {
+            auto lock = _progress_mutex.getLock();
+            flushInboxOverflow();
+            collectReturnedBuffers();
+            outboxEmpty = _outbox.empty();
+            processOutbox();
+            processReceived();
+            processFragmentedReceived();
+            processSent();
+            processSharedMemory();
         }
-        std::vector<uint8_t> outData(sumOfSizes);
-        size_t offset = 0;
-        for (const auto& frag : data.dataFragments) {
-            memcpy(outData.data()+offset, frag->data(), frag->size());
-            offset += frag->size();
+        // Only back off if nothing happened in this iteration
+        if (outboxEmpty && _num_progress_events == numEventsBefore) usleep(sleepMicros);
+    }
+}
+
+void MessageQueue::processOutbox() {
+    OutgoingRequest req;
+    while (_outbox.tryPop(req)) {
+        if (req.handle) {
+            enqueueSend(std::move(*req.handle));
+            delete req.handle;
+        } else {
+            cancelQueuedSend(req.cancelId);
         }
-        h.setReceive(std::move(outData));
-        // Put into finished queue
-        {
-            auto lock = _fused_mutex.getLock();
-            _fused_queue.push_back(std::move(h));
-            atomics::incrementRelaxed(_num_fused);
+    }
+}
+
+void MessageQueue::processInbox() {
+    // Up to x events per call in order to stay responsive
+    IncomingEvent ev;
+    for (int i = 0; i < 1000 && _inbox.tryPop(ev); i++) {
+        if (ev.msg) {
+            handleReceived(*ev.msg, ev.numFragments);
+            // Return a handed-over buffer to the progress thread
+            // (unless the callback kept its data)
+            if (ev.numFragments == 0 && ev.msg->getRecvData().capacity() >= _recv_buffer_size)
+                _returned_buffers.tryPush(ev.msg->moveRecvData());
+            delete ev.msg;
+        } else {
+            _metrics.addSendLatency(ev.tag, Timer::elapsedSeconds() - ev.creationTime);
+            signalCompletion(ev.tag, ev.sendId);
         }
     }
 }
 
+void MessageQueue::pushToInbox(IncomingEvent&& ev) {
+    _num_progress_events++;
+    // Do not wait for the main thread to make space: keep the event for later
+    if (_inbox_overflow.empty() && _inbox.tryPush(std::move(ev))) return;
+    _inbox_overflow.push_back(std::move(ev));
+}
+
+void MessageQueue::flushInboxOverflow() {
+    while (!_inbox_overflow.empty()) {
+        IncomingEvent ev = _inbox_overflow.front();
+        if (!_inbox.tryPush(std::move(ev))) break;
+        _inbox_overflow.pop_front();
+    }
+}
+
 void MessageQueue::runGarbageCollector() {
 
     while (_gc.continueRunning()) {
@@ -199,56 +350,67 @@ void MessageQueue::processReceived() {
 
     int k = 0;
     while (k < _num_receives_per_loop) {
-        k++;
 
-        // Test receive
-        //log(V5_DEBG, "MQ TEST\n");
-        int flag = false;
-        MPI_Status status;
-        MPI_Test(&_recv_request, &flag, &status);
-        if (!flag) {
+        // Test receives if the earliest posted receive is not known to be completed
+        if (!_recv_slots[_next_recv_slot].completed) testReceiveSlots();
+        auto& slot = _recv_slots[_next_recv_slot];
+        if (!slot.completed) {
             // Handle is not finished:
             // reset #receives per loop
             _num_receives_per_loop = _base_num_receives_per_loop;
             return;
         }
+        k++;
 
         // Message finished
-        const int source = status.MPI_SOURCE;
-        int tag = status.MPI_TAG;
+        const int source = slot.status.MPI_SOURCE;
+        int tag = slot.status.MPI_TAG;
         int msglen;
-        MPI_Get_count(&status, MPI_BYTE, &msglen);
+        MPI_Get_count(&slot.status, MPI_BYTE, &msglen);
+        uint8_t* recvData = slot.data.data();
         LOG(V5_DEBG, "MQ RECV n=%i s=[%i] t=%i c=(%i,...,%i,%i,%i)\n", msglen, source, tag, 
-                msglen>=1*sizeof(int) ? *(int*)(_recv_data) : 0, 
-                msglen>=3*sizeof(int) ? *(int*)(_recv_data+msglen - 3*sizeof(int)) : 0, 
-                msglen>=2*sizeof(int) ? *(int*)(_recv_data+msglen - 2*sizeof(int)) : 0, 
-                msglen>=1*sizeof(int) ? *(int*)(_recv_data+msglen - 1*sizeof(int)) : 0);
+                msglen>=1*sizeof(int) ? *(int*)(recvData) : 0, 
+                msglen>=3*sizeof(int) ? *(int*)(recvData+msglen - 3*sizeof(int)) : 0, 
+                msglen>=2*sizeof(int) ? *(int*)(recvData+msglen - 2*sizeof(int)) : 0, 
+                msglen>=1*sizeof(int) ? *(int*)(recvData+msglen - 1*sizeof(int)) : 0);
+        _recv_stats.numMessages++;
+        _recv_stats.numBytes += msglen;
+
+        // Free the slot: it is re-posted before any callback is executed
+        size_t slotIdx = _next_recv_slot;
+        _next_recv_slot = (_next_recv_slot+1) % _recv_slots.size();
+        _num_completed_slots--;
+        slot.completed = false;
 
         if (tag >= MSG_OFFSET_BATCHED) {
             // Fragment of a message
 
+            // Header of a fragmented message
             tag -= MSG_OFFSET_BATCHED;
-            int id = ReceiveFragment::readId(_recv_data, msglen);
-            auto key = std::pair<int, int>(source, id);
-            
-            if (!_fragmented_messages.count(key)) {
-                _fragmented_messages.emplace(key, ReceiveFragment(source, id, tag));
-            }
-            auto& fragment = _fragmented_messages[key];
-
-            fragment.receiveNext(source, tag, _recv_data, msglen);
-
-            resetReceiveHandle();
-
-            if (fragment.isCancelled() || fragment.isFinished()) {
-                {
-                    auto lock = _fragmented_mutex.getLock();
-                    _fragmented_queue.push_back(std::move(fragment));
-                    _fragmented_messages.erase(key);
+            assert(msglen == sizeof(FragmentHeader));
+            FragmentHeader header;
+            memcpy(&header, recvData, sizeof(FragmentHeader));
+            postReceive(slotIdx);
+            auto key = std::pair<int, int>(source, header.id);
+
+            if (header.numFragments == 0) {
+                // Message was cancelled: withdraw any receives for unsent fragments
+                // and drop the message once the sent fragments have arrived
+                auto it = _fragmented_messages.find(key);
+                if (it != _fragmented_messages.end()) {
+                    LOG(V4_VVER, "MSG id=%i cancelled (%i/%i fragments)\n", header.id, 
+                        header.numSentFragments, it->second.requests.size());
+                    it->second.cancel(header.numSentFragments);
+                    if (it->second.testNext()) _fragmented_messages.erase(it);
                 }
-                _fragmented_cond_var.notify();
+                continue;
             }
 
+            // Allocate the final buffer once and receive each fragment directly at its offset
+            assert(!_fragmented_messages.count(key));
+            auto& fragment = _fragmented_messages.emplace(key, ReceiveFragment(source, tag, header)).first->second;
+            fragment.postReceives(header, _fragment_comm, header.id % (_max_fragment_tag+1));
+
             // Receive next message
             continue;
         }
@@ -256,16 +418,25 @@ void MessageQueue::processReceived() {
         // Single message
         //log(V5_DEBG, "MQ singlerecv\n");
         MessageHandle h;
-        h.setReceive(std::vector<uint8_t>(_recv_data, _recv_data+msglen));
         h.tag = tag;
         h.source = source;
-
-        resetReceiveHandle();
+        if ((size_t) msglen >= _min_handover_size && !_recycled_buffers.empty()) {
+            // Hand the received buffer over to the message handle
+            // and re-post the receive with a spare buffer
+            slot.data.resize(msglen);
+            h.setReceive(std::move(slot.data));
+            slot.data = std::move(_recycled_buffers.back());
+            _recycled_buffers.pop_back();
+            _recv_stats.numZeroCopy++;
+        } else {
+            // Copy the message into a buffer of fitting size
+            // in order not to hand out (and possibly retain) a large buffer
+            h.setReceive(std::vector<uint8_t>(recvData, recvData+msglen));
+        }
+        postReceive(slotIdx);
 
         // Process message according to its tag-specific callback
-        *_current_recv_tag = h.tag;
-        _callbacks.at(h.tag)(h);
-        *_current_recv_tag = 0;
+        deliverReceived(std::move(h), 0);
     }
 
     // Increase #receives per loop for the next time, if necessary
@@ -274,11 +445,66 @@ void MessageQueue::processReceived() {
     }
 }
 
-void MessageQueue::resetReceiveHandle() {
-    // Reset recv handle
+void MessageQueue::testReceiveSlots() {
+    int numCompleted = 0;
+    MPI_Testsome(_recv_requests.size(), _recv_requests.data(), &numCompleted, 
+        _completed_indices.data(), _completed_statuses.data());
+    if (numCompleted == MPI_UNDEFINED || numCompleted == 0) return;
+    for (int i = 0; i < numCompleted; i++) {
+        auto& slot = _recv_slots[_completed_indices[i]];
+        slot.status = _completed_statuses[i];
+        slot.completed = true;
+    }
+    _num_completed_slots += numCompleted;
+    // Record the backlog of completed, unprocessed receives
+    _recv_stats.numBacklogSamples++;
+    _recv_stats.sumBacklog += _num_completed_slots;
+    _recv_stats.maxBacklog = std::max(_recv_stats.maxBacklog, _num_completed_slots);
+}
+
+void MessageQueue::postReceive(size_t slotIdx) {
     //log(V5_DEBG, "MQ MPI_Irecv\n");
-    MPI_Irecv(_recv_data, _max_msg_size+20, MPI_BYTE, MPI_ANY_SOURCE, 
-        MPI_ANY_TAG, MPI_COMM_WORLD, &_recv_request);
+    auto& slot = _recv_slots[slotIdx];
+    assert(slot.data.size() == _recv_buffer_size);
+    MPI_Irecv(slot.data.data(), _recv_buffer_size, MPI_BYTE, MPI_ANY_SOURCE, 
+        MPI_ANY_TAG, MPI_COMM_WORLD, &_recv_requests[slotIdx]);
+}
+
+void MessageQueue::recycleReceiveBuffer(std::vector<uint8_t>&& buffer) {
+    // Only keep buffers which were not moved out by a callback
+    if (buffer.capacity() < _recv_buffer_size) return;
+    if (_recycled_buffers.size() >= _recv_slots.size()) return;
+    // Handed-over buffers are nearly full: only a small tail is initialized here
+    buffer.resize(_recv_buffer_size);
+    _recycled_buffers.push_back(std::move(buffer));
+}
+
+void MessageQueue::collectReturnedBuffers() {
+    std::vector<uint8_t> buffer;
+    while (_returned_buffers.tryPop(buffer)) recycleReceiveBuffer(std::move(buffer));
+}
+
+std::string MessageQueue::getReceiveStatsReport() {
+    auto lock = _progress_mutex.getLock();
+    float time = Timer::elapsedSeconds();
+    float elapsed = std::max(0.001f, time - _recv_stats.startTime);
+    char out[256];
+    snprintf(out, 256, "msgs=%lu rate=%.1f/s MB/s=%.3f zerocopy=%lu shmem=%lu backlog_avg=%.2f backlog_max=%i/%lu", 
+        _recv_stats.numMessages, _recv_stats.numMessages / elapsed, 
+        _recv_stats.numBytes / elapsed / 1024 / 1024, _recv_stats.numZeroCopy, _recv_stats.numShmem, 
+        _recv_stats.numBacklogSamples == 0 ? 0.f : (float)_recv_stats.sumBacklog / _recv_stats.numBacklogSamples,
+        _recv_stats.maxBacklog, _recv_slots.size());
+    _recv_stats = ReceiveStats();
+    _recv_stats.startTime = time;
+    return std::string(out);
+}
+
+void MessageQueue::runCallback(MessageHandle& h) {
+    *_current_recv_tag = h.tag;
+    float time = Timer::elapsedSeconds();
+    _callbacks.at(h.tag)(h);
+    _metrics.addCallbackTime(h.tag, Timer::elapsedSeconds() - time);
+    *_current_recv_tag = 0;
 }
 
 void MessageQueue::signalCompletion(int tag, int id) {
@@ -303,99 +529,136 @@ void MessageQueue::processSelfReceived() {
         h.tag = sh.tag;
         h.source = sh.dest;
         h.setReceive(std::move(*sh.data));
-        *_current_recv_tag = h.tag;
-        _callbacks.at(h.tag)(h);
+        _metrics.addReceived(h.tag, _my_rank, h.getRecvData().size());
+        runCallback(h);
+        _metrics.addSendLatency(h.tag, Timer::elapsedSeconds() - sh.creationTime);
         signalCompletion(h.tag, sh.id);
-        *_current_recv_tag = 0;
     }
 }
 
-void MessageQueue::processAssembledReceived() {
+void MessageQueue::processFragmentedReceived() {
 
-    int numFused = _num_fused.load(std::memory_order_relaxed);
-    if (numFused > 0 && _fused_mutex.tryLock()) {
+    if (_fragmented_messages.empty()) return;
 
-        int consumed = 0;
-        while (!_fused_queue.empty() && consumed < 4) {
-
-            auto& h = _fused_queue.front();
-            LOG(V5_DEBG, "MQ FUSED t=%i\n", h.tag);
-            
-            *_current_recv_tag = h.tag;
-            _callbacks.at(h.tag)(h);
-            *_current_recv_tag = 0;
-            
-            if (h.getRecvData().size() > _max_msg_size) {
-                // Concurrent deallocation of large chunk of data
-                auto lock = _garbage_mutex.getLock();
-                _garbage_queue.push_back(
-                    DataPtr(
-                        new std::vector<uint8_t>(
-                            h.moveRecvData()
-                        )
-                    )
-                );
-                atomics::incrementRelaxed(_num_garbage);
-            }
-            _fused_queue.pop_front();
-            atomics::decrementRelaxed(_num_fused);
+    // Find up to x completed messages in order to stay responsive
+    std::vector<std::pair<int, int>> completedKeys;
+    for (auto& [key, fragment] : _fragmented_messages) {
+        if (fragment.testNext()) completedKeys.push_back(key);
+        if (completedKeys.size() >= 4) break;
+    }
 
-            consumed++;
-            if (consumed >= 4) break;
+    for (auto& key : completedKeys) {
+        if (_fragmented_messages.at(key).cancelled) {
+            // All fragments sent before the cancellation have arrived
+            _fragmented_messages.erase(key);
+            continue;
+        }
+        MessageHandle h;
+        int numFragments;
+        {
+            auto& fragment = _fragmented_messages.at(key);
+            h.source = fragment.source;
+            h.tag = fragment.tag;
+            h.setReceive(std::move(fragment.data));
+            _recv_stats.numBytes += h.getRecvData().size();
+            _recv_stats.numZeroCopy += fragment.requests.size();
+            numFragments = fragment.requests.size();
+            _fragmented_messages.erase(key);
         }
+        LOG(V5_DEBG, "MQ FUSED t=%i\n", h.tag);
+
+        deliverReceived(std::move(h), numFragments);
+    }
+}
 
-        _fused_mutex.unlock();
+void MessageQueue::deliverReceived(MessageHandle&& h, int numFragments) {
+    if (!_progress_thread_active.load(std::memory_order_relaxed)) {
+        handleReceived(h, numFragments);
+        // Take back a handed-over buffer if the callback left it in the handle
+        if (numFragments == 0) recycleReceiveBuffer(h.moveRecvData());
+        return;
+    }
+    // Hand the message over to the main thread
+    IncomingEvent ev;
+    ev.msg = new MessageHandle(std::move(h));
+    ev.numFragments = numFragments;
+    pushToInbox(std::move(ev));
+}
+
+void MessageQueue::handleReceived(MessageHandle& h, int numFragments) {
+
+    _metrics.addReceived(h.tag, h.source, h.getRecvData().size(), numFragments);
+    runCallback(h);
+
+    if (numFragments > 0 && h.getRecvData().size() > _max_msg_size) {
+        // Concurrent deallocation of large chunk of data
+        auto lock = _garbage_mutex.getLock();
+        _garbage_queue.push_back(
+            DataPtr(
+                new std::vector<uint8_t>(
+                    h.moveRecvData()
+                )
+            )
+        );
+        atomics::incrementRelaxed(_num_garbage);
     }
 }
 
 void MessageQueue::processSent() {
 
-    auto it = _send_queue.begin();
     bool uninitiatedHandlesPresent = false;
 
-    // Test each send handle
-    while (it != _send_queue.end()) {
-        
-        SendHandle& h = *it;
+    for (int prio = 0; prio < NUM_PRIORITIES; prio++) {
+        auto& queue = _send_queues[prio];
+        std::list<SendHandle> rotatedHandles;
 
-        if (!h.isInitiated()) {
-            // Message has not been sent yet
-            uninitiatedHandlesPresent = true;
-            ++it; // go to next handle
-            continue;
-        }
+        // Test each send handle
+        auto it = queue.begin();
+        while (it != queue.end()) {
+            
+            SendHandle& h = *it;
 
-        if (!h.test()) {
-            ++it; // go to next handle
-            continue;
-        }
-        
-        // Sent!
-        //log(V5_DEBG, "MQ SENT n=%i d=[%i] t=%i\n", h.data->size(), h.dest, h.tag);
-        bool completed = true;
-
-        // Batched?
-        if (h.isBatched()) {
-            // Batch of a large message sent
-            LOG(V5_DEBG, "MQ SENT id=%i %i/%i n=%i d=[%i] t=%i c=(%i,...,%i,%i,%i)\n", h.id, h.sentBatches, 
-                h.totalNumBatches, h.data->size(), h.dest, h.tag, 
-                *(int*)(h.tempStorage.data()), 
-                *(int*)(h.tempStorage.data()+h.tempStorage.size()-3*sizeof(int)), 
-                *(int*)(h.tempStorage.data()+h.tempStorage.size()-2*sizeof(int)),
-                *(int*)(h.tempStorage.data()+h.tempStorage.size()-1*sizeof(int)));
+            if (!h.isInitiated()) {
+                // Message has not been sent yet
+                uninitiatedHandlesPresent = true;
+                ++it; // go to next handle
+                continue;
+            }
+
+            if (!h.test()) {
+                ++it; // go to next handle
+                continue;
+            }
+            
+            // Sent!
+            //log(V5_DEBG, "MQ SENT n=%i d=[%i] t=%i\n", h.data->size(), h.dest, h.tag);
+            releaseSendSlot(h);
+
+            // Batched?
+            if (h.isBatched()) {
+                // Batch of a large message sent
+                LOG(V5_DEBG, "MQ SENT id=%i %i/%i n=%i d=[%i] t=%i\n", h.id, h.sentBatches, 
+                    h.totalNumBatches+1, h.data->size(), h.dest, h.tag);
+            }
 
             // More batches yet to send?
             if (!h.isFinished()) {
-                // Send next batch
-                h.sendNext();
-                completed = false;
+                if (h.priority == PRIORITY_BULK) {
+                    // Let other bulk messages take their turn first
+                    uninitiatedHandlesPresent = true;
+                    auto next = std::next(it);
+                    rotatedHandles.splice(rotatedHandles.end(), queue, it);
+                    it = next;
+                } else {
+                    // Send next batch
+                    initiate(h);
+                    ++it;
+                }
+                continue;
             }
-        }
 
-        if (completed) {
             // Notify completion
-            signalCompletion(h.tag, h.id);
-            _num_concurrent_sends--;
+            completeSend(h);
 
             if (h.data->size() > _max_msg_size) {
                 // Concurrent deallocation of SendHandle's large chunk of data
@@ -408,23 +671,86 @@ void MessageQueue::processSent() {
             }
             
             // Remove handle
-            it = _send_queue.erase(it); // go to next handle
-        } else {
-            ++it; // go to next handle
+            it = queue.erase(it); // go to next handle
         }
+
+        queue.splice(queue.end(), rotatedHandles);
     }
 
     if (!uninitiatedHandlesPresent) return;
 
     // Initiate sending messages which have not been initiated yet
     // as long as there is a "send slot" available to do so
-    it = _send_queue.begin();
-    while (_num_concurrent_sends < _max_concurrent_sends && it != _send_queue.end()) {
-        SendHandle& h = *it;
-        if (!h.isInitiated()) {
-            h.sendNext();
-            _num_concurrent_sends++;
+    for (auto& queue : _send_queues) for (auto& h : queue) {
+        if (h.isInitiated() || !canInitiate(h)) continue;
+        if (h.priority == PRIORITY_DEFAULT) {
+            auto it = _num_queued_default_sends.find(h.dest);
+            if (--it->second == 0) _num_queued_default_sends.erase(it);
         }
-        ++it;
+        initiate(h);
+    }
+}
+
+void MessageQueue::completeSend(const SendHandle& h) {
+    if (!_progress_thread_active.load(std::memory_order_relaxed)) {
+        _metrics.addSendLatency(h.tag, Timer::elapsedSeconds() - h.creationTime);
+        signalCompletion(h.tag, h.id);
+        return;
+    }
+    // Let the main thread execute the completion callback
+    IncomingEvent ev;
+    ev.tag = h.tag;
+    ev.sendId = h.id;
+    ev.creationTime = h.creationTime;
+    pushToInbox(std::move(ev));
+}
+
+MessageQueue::SendPriority MessageQueue::getPriority(const SendHandle& h) {
+    // Only fragmented messages are bulk messages, so that all single messages
+    // to a destination keep their order (except for control messages)
+    if (h.isBatched()) return PRIORITY_BULK;
+    auto it = _tag_priorities.find(h.tag);
+    if (it == _tag_priorities.end()) return PRIORITY_DEFAULT;
+    if (it->second == PRIORITY_CONTROL && _num_queued_default_sends.count(h.dest)) {
+        // Control messages may not overtake default messages to the same destination
+        return PRIORITY_DEFAULT;
+    }
+    return it->second;
+}
+
+bool MessageQueue::canInitiate(const SendHandle& h) {
+    if (h.priority == PRIORITY_CONTROL) return true;
+    int numActive = _num_active_sends[PRIORITY_DEFAULT] + _num_active_sends[PRIORITY_BULK];
+    if (numActive >= _max_concurrent_sends) return false;
+    if (h.priority == PRIORITY_DEFAULT) return true;
+    return _num_active_sends[PRIORITY_BULK] < _max_concurrent_bulk_sends 
+        && !_bulk_dests_in_flight.count(h.dest);
+}
+
+void MessageQueue::initiate(SendHandle& h) {
+    if (h.sentBatches == 0) {
+        _send_delays[h.tag].add(Timer::elapsedSeconds() - h.creationTime);
+    }
+    h.sendNext();
+    _num_active_sends[h.priority]++;
+    if (h.priority == PRIORITY_BULK) _bulk_dests_in_flight.insert(h.dest);
+}
+
+void MessageQueue::releaseSendSlot(const SendHandle& h) {
+    _num_active_sends[h.priority]--;
+    if (h.priority == PRIORITY_BULK) _bulk_dests_in_flight.erase(h.dest);
+}
+
+std::vector<std::string> MessageQueue::getSendDelayReports() {
+    auto lock = _progress_mutex.getLock();
+    std::vector<int> tags;
+    for (auto& [tag, hist] : _send_delays) if (hist.getNumEntries() > 0) tags.push_back(tag);
+    std::sort(tags.begin(), tags.end());
+    std::vector<std::string> reports;
+    for (int tag : tags) {
+        auto& hist = _send_delays[tag];
+        reports.push_back("tag:" + std::to_string(tag) + " " + hist.getReport());
+        hist.reset();
     }
+    return reports;
 }
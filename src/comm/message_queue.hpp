@@ -14,101 +14,91 @@
 #include "util/logger.hpp"
 #include "comm/msgtags.h"
 #include "util/sys/atomics.hpp"
+#include "util/latency_histogram.hpp"
+#include "comm/message_metrics.hpp"
+#include "util/sys/spsc_queue.hpp"
+#include "comm/shmem_transport.hpp"
 
 typedef std::shared_ptr<std::vector<uint8_t>> DataPtr;
 typedef std::unique_ptr<std::vector<uint8_t>> UniqueDataPtr;
 typedef std::shared_ptr<const std::vector<uint8_t>> ConstDataPtr; 
 
 class MessageQueue {
+
+public:
+    // Priority classes of outgoing messages. Control messages (scheduling messages,
+    // by tag) are initiated right away, regardless of the number of active sends.
+    // Bulk messages (fragmented messages) may only occupy a part of the send slots,
+    // and bulk messages to the same destination take turns fragment by fragment.
+    // Single messages to the same destination arrive in the order they were sent:
+    // control messages never overtake queued default messages to that destination.
+    enum SendPriority {PRIORITY_CONTROL, PRIORITY_DEFAULT, PRIORITY_BULK, NUM_PRIORITIES};
     
 private:
+    // Announcement of a fragmented message, sent ahead of its fragments
+    // (or instead of its remaining fragments if the message is cancelled).
+    // The fragments themselves are sent without any meta data via a separate
+    // communicator, tagged with the message ID, directly from the send buffer.
+    struct FragmentHeader {
+        int id;
+        int numFragments; // 0: message was cancelled
+        int sizePerFragment;
+        int numSentFragments; // if cancelled: # fragments sent before the cancellation
+        size_t totalSize;
+    };
+
     struct ReceiveFragment {
         
         int source = -1;
         int id = -1;
         int tag = -1;
-        int receivedFragments = 0;
-        std::vector<UniqueDataPtr> dataFragments;
+        // Final message buffer: each fragment is received at its offset
+        std::vector<uint8_t> data;
+        std::vector<MPI_Request> requests;
+        size_t receivedFragments = 0;
         bool cancelled = false;
         
         ReceiveFragment() = default;
-        ReceiveFragment(int source, int id, int tag) : source(source), id(id), tag(tag) {}
-
-        ReceiveFragment(ReceiveFragment&& moved) {
-            source = moved.source;
-            id = moved.id;
-            tag = moved.tag;
-            receivedFragments = moved.receivedFragments;
-            dataFragments = std::move(moved.dataFragments);
-            cancelled = moved.cancelled;
-            moved.id = -1;
-        }
-        ReceiveFragment& operator=(ReceiveFragment&& moved) {
-            source = moved.source;
-            id = moved.id;
-            tag = moved.tag;
-            receivedFragments = moved.receivedFragments;
-            dataFragments = std::move(moved.dataFragments);
-            cancelled = moved.cancelled;
-            moved.id = -1;
-            return *this;
-        }
-
-        bool valid() const {return id != -1;}
-        bool isCancelled() const {return cancelled;}
-
-        static int readId(uint8_t* data, int msglen) {
-            return * (int*) (data+msglen - 3*sizeof(int));
-        }
-
-        void receiveNext(int source, int tag, uint8_t* data, int msglen) {
-            assert(this->source >= 0);
-            assert(valid());
-
-            int id, sentBatch, totalNumBatches;
-            // Read meta data from end of message
-            memcpy(&id,              data+msglen - 3*sizeof(int), sizeof(int));
-            memcpy(&sentBatch,       data+msglen - 2*sizeof(int), sizeof(int));
-            memcpy(&totalNumBatches, data+msglen - 1*sizeof(int), sizeof(int));
-            msglen -= 3*sizeof(int);
-            
-            if (msglen == 0 && sentBatch == 0 && totalNumBatches == 0) {
-                // Message was cancelled!
-                cancelled = true;
-                return;
+        ReceiveFragment(int source, int tag, const FragmentHeader& header) : 
+            source(source), id(header.id), tag(tag), data(header.totalSize) {}
+
+        void postReceives(const FragmentHeader& header, MPI_Comm comm, int dataTag) {
+            requests.resize(header.numFragments, MPI_REQUEST_NULL);
+            for (size_t i = 0; i < requests.size(); i++) {
+                size_t begin = i * header.sizePerFragment;
+                size_t end = std::min(data.size(), begin + header.sizePerFragment);
+                assert(end > begin);
+                MPI_Irecv(data.data()+begin, end-begin, MPI_BYTE, source, dataTag, comm, &requests[i]);
             }
+        }
 
-            if (sentBatch == 0 || sentBatch+1 == totalNumBatches) {
-                LOG(V4_VVER, "RECVB %i %i/%i %i\n", id, sentBatch+1, totalNumBatches, source);
-            } else {
-                LOG(V5_DEBG, "RECVB %i %i/%i %i\n", id, sentBatch+1, totalNumBatches, source);
+        // Fragments arrive in order, so only the first pending receive is tested.
+        // Returns true iff all fragments have been received.
+        bool testNext() {
+            while (receivedFragments < requests.size()) {
+                int flag = false;
+                MPI_Test(&requests[receivedFragments], &flag, MPI_STATUS_IGNORE);
+                if (!flag) return false;
+                receivedFragments++;
+                if (receivedFragments == 1 || receivedFragments == requests.size()) {
+                    LOG(V4_VVER, "RECVB %i %i/%i %i\n", id, receivedFragments, requests.size(), source);
+                } else {
+                    LOG(V5_DEBG, "RECVB %i %i/%i %i\n", id, receivedFragments, requests.size(), source);
+                }
             }
-
-            // Store data in fragments structure
-            
-            //log(V5_DEBG, "MQ STORE (%i,%i) %i/%i\n", source, id, sentBatch, totalNumBatches);
-
-            assert(this->source == source);
-            assert(this->id == id || LOG_RETURN_FALSE("%i != %i\n", this->id, id));
-            assert(this->tag == tag);
-            assert(sentBatch < totalNumBatches || LOG_RETURN_FALSE("Invalid batch %i/%i!\n", sentBatch, totalNumBatches));
-            if (totalNumBatches > dataFragments.size()) dataFragments.resize(totalNumBatches);
-            assert(receivedFragments >= 0 || LOG_RETURN_FALSE("Batched message was already completed!\n"));
-
-            //log(V5_DEBG, "MQ STORE alloc\n");
-            assert(dataFragments[sentBatch] == nullptr || LOG_RETURN_FALSE("Batch %i/%i already present!\n", sentBatch, totalNumBatches));
-            dataFragments[sentBatch].reset(new std::vector<uint8_t>(data, data+msglen));
-            
-            //log(V5_DEBG, "MQ STORE produce\n");
-            // All fragments of the message received?
-            receivedFragments++;
-            if (receivedFragments == totalNumBatches)
-                receivedFragments = -1;
+            return true;
         }
 
-        bool isFinished() {
-            assert(valid());
-            return receivedFragments == -1;
+        // Withdraws the receives of all fragments which were never sent.
+        // Fragments which were sent still need to be received (see testNext)
+        // so that they cannot match a later message with the same data tag.
+        void cancel(size_t numSentFragments) {
+            cancelled = true;
+            for (size_t i = std::max(receivedFragments, numSentFragments); i < requests.size(); i++) {
+                MPI_Cancel(&requests[i]);
+                MPI_Wait(&requests[i], MPI_STATUS_IGNORE);
+            }
+            requests.resize(std::max(receivedFragments, numSentFragments));
         }
     };
 
@@ -122,10 +112,15 @@ private:
         int sentBatches = -1;
         int totalNumBatches;
         int sizePerBatch;
-        std::vector<uint8_t> tempStorage;
+        bool cancelled = false;
+        SendPriority priority = PRIORITY_DEFAULT;
+        float creationTime = 0;
+        MPI_Comm dataComm;
+        int dataTag;
+        FragmentHeader header;
         
-        SendHandle(int id, int dest, int tag, DataPtr data, int maxMsgSize) 
-            : id(id), dest(dest), tag(tag), data(data) {
+        SendHandle(int id, int dest, int tag, DataPtr data, int maxMsgSize, MPI_Comm dataComm, int dataTag) 
+            : id(id), dest(dest), tag(tag), data(data), dataComm(dataComm), dataTag(dataTag) {
 
             sizePerBatch = maxMsgSize;
             sentBatches = 0;
@@ -136,20 +131,7 @@ private:
         bool valid() {return id != -1;}
         
         SendHandle(SendHandle&& moved) {
-            assert(moved.valid());
-            id = moved.id;
-            dest = moved.dest;
-            tag = moved.tag;
-            request = moved.request;
-            data = std::move(moved.data);
-            sentBatches = moved.sentBatches;
-            totalNumBatches = moved.totalNumBatches;
-            sizePerBatch = moved.sizePerBatch;
-            tempStorage = std::move(moved.tempStorage);
-            
-            moved.id = -1;
-            moved.data = DataPtr();
-            moved.request = MPI_REQUEST_NULL;
+            *this = std::move(moved);
         }
         SendHandle& operator=(SendHandle&& moved) {
             assert(moved.valid());
@@ -161,7 +143,12 @@ private:
             sentBatches = moved.sentBatches;
             totalNumBatches = moved.totalNumBatches;
             sizePerBatch = moved.sizePerBatch;
-            tempStorage = std::move(moved.tempStorage);
+            cancelled = moved.cancelled;
+            priority = moved.priority;
+            creationTime = moved.creationTime;
+            dataComm = moved.dataComm;
+            dataTag = moved.dataTag;
+            header = moved.header;
             
             moved.id = -1;
             moved.data = DataPtr();
@@ -181,7 +168,8 @@ private:
             return flag;
         }
 
-        bool isFinished() const {return sentBatches == totalNumBatches;}
+        // A batched message is sent as a header followed by its fragments.
+        bool isFinished() const {return sentBatches == (isBatched() ? totalNumBatches+1 : 1);}
 
         void sendNext() {
             assert(valid());
@@ -195,49 +183,41 @@ private:
                 return;
             }
 
-            if (isCancelled()) {
-                int zero = 0;
-                if (tempStorage.size() < 3*sizeof(int)) tempStorage.resize(3*sizeof(int));
-                memcpy(tempStorage.data(), &id, sizeof(int));
-                memcpy(tempStorage.data()+sizeof(int), &zero, sizeof(int));
-                memcpy(tempStorage.data()+2*sizeof(int), &zero, sizeof(int));
-                MPI_Isend(tempStorage.data(), 3*sizeof(int), MPI_BYTE, 
+            if (isCancelled() || sentBatches == 0) {
+                // Announce the message (or its cancellation)
+                header.id = id;
+                header.numFragments = isCancelled() ? 0 : totalNumBatches;
+                header.sizePerFragment = sizePerBatch;
+                header.numSentFragments = std::max(0, sentBatches-1);
+                header.totalSize = data->size();
+                MPI_Isend(&header, sizeof(FragmentHeader), MPI_BYTE, 
                     dest, tag+MSG_OFFSET_BATCHED, MPI_COMM_WORLD, &request);
-                sentBatches = totalNumBatches; // mark as finished
+                // Cancellation marks the handle as finished
+                sentBatches = isCancelled() ? totalNumBatches+1 : 1;
                 return;
             }
 
-            size_t begin = sentBatches*sizePerBatch;
-            size_t end = std::min(data->size(), (size_t)(sentBatches+1)*sizePerBatch);
+            // Send next fragment directly from the original buffer
+            int fragmentIdx = sentBatches-1;
+            size_t begin = (size_t)fragmentIdx*sizePerBatch;
+            size_t end = std::min(data->size(), (size_t)(fragmentIdx+1)*sizePerBatch);
             assert(end>begin || LOG_RETURN_FALSE("%ld <= %ld\n", end, begin));
-            size_t msglen = (end-begin)+3*sizeof(int);
-            if (msglen > tempStorage.size()) tempStorage.resize(msglen);
-
-            // Copy actual data
-            memcpy(tempStorage.data(), data->data()+begin, end-begin);
-            // Copy meta data at insertion point
-            memcpy(tempStorage.data()+(end-begin), &id, sizeof(int));
-            memcpy(tempStorage.data()+(end-begin)+sizeof(int), &sentBatches, sizeof(int));
-            memcpy(tempStorage.data()+(end-begin)+2*sizeof(int), &totalNumBatches, sizeof(int));
-
-            MPI_Isend(tempStorage.data(), msglen, MPI_BYTE, dest, 
-                    tag+MSG_OFFSET_BATCHED, MPI_COMM_WORLD, &request);
+            MPI_Isend(data->data()+begin, end-begin, MPI_BYTE, dest, dataTag, dataComm, &request);
 
             sentBatches++;
-            if (sentBatches == 1 || sentBatches == totalNumBatches) {
-                LOG(V4_VVER, "SENDB %i %i/%i %i\n", id, sentBatches, totalNumBatches, dest);
+            if (fragmentIdx == 0 || fragmentIdx+1 == totalNumBatches) {
+                LOG(V4_VVER, "SENDB %i %i/%i %i\n", id, fragmentIdx+1, totalNumBatches, dest);
             } else {
-                LOG(V5_DEBG, "SENDB %i %i/%i %i\n", id, sentBatches, totalNumBatches, dest);
+                LOG(V5_DEBG, "SENDB %i %i/%i %i\n", id, fragmentIdx+1, totalNumBatches, dest);
             }
-            //log(V5_DEBG, "MQ SEND BATCHED id=%i %i/%i\n", id, sentBatches, totalNumBatches);
         }
 
         void cancel() {
-            sizePerBatch = -1;
+            cancelled = true;
         }
 
         bool isBatched() const {return totalNumBatches > 1;}
-        bool isCancelled() const {return sizePerBatch == -1;}
+        bool isCancelled() const {return cancelled;}
         size_t getTotalNumBatches() const {assert(isBatched()); return totalNumBatches;}
     };
 
@@ -245,27 +225,59 @@ private:
     int _my_rank;
     unsigned long long _iteration = 0;
 
-    // Basic receive stuff
-    MPI_Request _recv_request;
-    uint8_t* _recv_data;
+    // Basic receive stuff: a ring of pre-posted receives which are
+    // processed in the order of their posting (to preserve message order)
+    struct ReceiveSlot {
+        std::vector<uint8_t> data;
+        MPI_Status status;
+        bool completed = false;
+    };
+    std::vector<ReceiveSlot> _recv_slots;
+    std::vector<MPI_Request> _recv_requests; // parallel to _recv_slots
+    std::vector<int> _completed_indices;
+    std::vector<MPI_Status> _completed_statuses;
+    size_t _next_recv_slot = 0;
+    int _num_completed_slots = 0;
+    size_t _recv_buffer_size;
+    // A received buffer is only handed over to its message handle if the message
+    // (nearly) fills it; smaller messages are copied into a buffer of fitting size
+    size_t _min_handover_size;
+    // Spare receive buffers, allocated once: a received buffer is handed over
+    // only if a spare buffer can take its place, and the buffer is taken back
+    // as a spare after the callback unless the callback kept its data
+    std::vector<std::vector<uint8_t>> _recycled_buffers;
     std::list<SendHandle> _self_recv_queue;
     int _base_num_receives_per_loop = 10;
     int _num_receives_per_loop = _base_num_receives_per_loop;
 
     // Fragmented messages stuff
+    MPI_Comm _fragment_comm;
+    int _max_fragment_tag;
     robin_hood::unordered_node_map<std::pair<int, int>, ReceiveFragment, IntPairHasher> _fragmented_messages;
-    Mutex _fragmented_mutex;
-    ConditionVariable _fragmented_cond_var;
-    std::list<ReceiveFragment> _fragmented_queue;
-    std::atomic_int _num_fused = 0;
-    Mutex _fused_mutex;
-    std::list<MessageHandle> _fused_queue;
 
     // Send stuff
-    std::list<SendHandle> _send_queue;
+    std::list<SendHandle> _send_queues[NUM_PRIORITIES];
     int _running_send_id = 1;
-    int _num_concurrent_sends = 0;
-    int _max_concurrent_sends = 16;
+    int _num_active_sends[NUM_PRIORITIES] = {0, 0, 0};
+    int _max_concurrent_sends = 16; // default and bulk messages
+    int _max_concurrent_bulk_sends = 8;
+    robin_hood::unordered_map<int, SendPriority> _tag_priorities;
+    robin_hood::unordered_set<int> _bulk_dests_in_flight;
+    // # default messages per destination which have not been initiated yet
+    // (control messages may not overtake them)
+    robin_hood::unordered_map<int, int> _num_queued_default_sends;
+    // Time from enqueueing each message until its initiation, per tag
+    robin_hood::unordered_map<int, LatencyHistogram> _send_delays;
+
+    // Optional transport of all control and default messages to processes on the
+    // same host via shared memory, one ordered stream per destination. Bulk messages
+    // to these processes are still sent via MPI, so the above order guarantees hold.
+    ShmemTransport _shmem;
+    // Messages which did not fit into their ring (completely) yet, per destination
+    robin_hood::unordered_map<int, std::list<SendHandle>> _shmem_backlog;
+    int _num_shmem_backlog = 0;
+    // Messages written into a ring which were not reported as sent yet
+    std::list<SendHandle> _shmem_sent;
 
     // Garbage collection
     std::atomic_int _num_garbage = 0;
@@ -281,11 +293,50 @@ private:
     int* _current_recv_tag = nullptr;
     int* _current_send_tag = nullptr;
 
-    BackgroundWorker _batch_assembler;
     BackgroundWorker _gc;
 
+    // Optional progress thread which performs all MPI operations of this queue
+    // while the main thread only executes callbacks. Communication with the
+    // main thread is done via lock-free queues.
+    struct OutgoingRequest {
+        SendHandle* handle = nullptr; // new message to send
+        int cancelId = -1; // ID of message to cancel
+    };
+    struct IncomingEvent {
+        MessageHandle* msg = nullptr; // received message (if any)
+        int numFragments = 0;
+        int tag; // completed send (if no message)
+        int sendId;
+        float creationTime;
+    };
+    BackgroundWorker _progress_thread;
+    std::atomic_bool _progress_thread_active {false};
+    SPSCQueue<OutgoingRequest> _outbox {16384};
+    SPSCQueue<IncomingEvent> _inbox {16384};
+    // Handed-over receive buffers which the main thread returns for reuse
+    SPSCQueue<std::vector<uint8_t>> _returned_buffers {64};
+    // Events which did not fit into the inbox yet (only accessed by the progress
+    // thread, which must never wait for the main thread while holding the mutex)
+    std::list<IncomingEvent> _inbox_overflow;
+    unsigned long _num_progress_events = 0;
+    // Held by the progress thread while it operates on the queue's internals
+    Mutex _progress_mutex;
+
+    // Receive statistics since the last report
+    struct ReceiveStats {
+        unsigned long numMessages = 0;
+        unsigned long numBytes = 0;
+        unsigned long numZeroCopy = 0;
+        unsigned long numShmem = 0;
+        unsigned long numBacklogSamples = 0;
+        unsigned long sumBacklog = 0;
+        int maxBacklog = 0;
+        float startTime = 0;
+    } _recv_stats;
+    MessageMetrics _metrics;
+
 public:
-    MessageQueue(int maxMsgSize);
+    MessageQueue(int maxMsgSize, int numReceiveSlots = 4);
     ~MessageQueue();
 
     void registerCallback(int tag, const MsgCallback& cb);
@@ -296,20 +347,62 @@ public:
         _current_send_tag = sendTag;
     }
 
+    void setTagPriority(int tag, SendPriority priority) {
+        _tag_priorities[tag] = priority;
+    }
+
     int send(DataPtr data, int dest, int tag);
     void cancelSend(int sendId);
     void advance();
 
+    // From now on, let a separate thread perform all MPI operations of this queue
+    // (requires MPI_THREAD_MULTIPLE). Tag priorities must be set beforehand.
+    void startProgressThread(int sleepMicros);
+    void stopProgressThread();
+
+    // Collective operation over MPI_COMM_WORLD: From now on, send all control and default
+    // messages to processes on the same host via shared memory ring buffers (of at least 
+    // the given size each) instead of MPI. Must be called before starting a progress thread.
+    void enableSharedMemoryTransport(size_t ringBytes);
+
+    // Returns (and resets) statistics on received messages: throughput and 
+    // backlog, i.e., the number of completed receives found at once.
+    std::string getReceiveStatsReport();
+    // Returns (and resets) a report on the queueing delay of sent messages for each tag.
+    std::vector<std::string> getSendDelayReports();
+    MessageMetrics& getMetrics() {return _metrics;}
+
 private:
-    void runFragmentedMessageAssembler();
     void runGarbageCollector();
 
     void processReceived();
     void processSelfReceived();
-    void processAssembledReceived();
+    void processFragmentedReceived();
     void processSent();
-
-    void resetReceiveHandle();
+    void processSharedMemory();
+    bool usesSharedMemory(const SendHandle& h);
+
+    void runProgressThread(int sleepMicros);
+    void processOutbox();
+    void processInbox();
+    void pushToInbox(IncomingEvent&& ev);
+    void flushInboxOverflow();
+    void enqueueSend(SendHandle&& handle);
+    void cancelQueuedSend(int sendId);
+    void deliverReceived(MessageHandle&& h, int numFragments);
+    void handleReceived(MessageHandle& h, int numFragments);
+    void completeSend(const SendHandle& h);
+
+    SendPriority getPriority(const SendHandle& h);
+    bool canInitiate(const SendHandle& h);
+    void initiate(SendHandle& h);
+    void releaseSendSlot(const SendHandle& h);
+
+    void testReceiveSlots();
+    void postReceive(size_t slotIdx);
+    void recycleReceiveBuffer(std::vector<uint8_t>&& buffer);
+    void collectReturnedBuffers();
+    void runCallback(MessageHandle& h);
     void signalCompletion(int tag, int id);
 };
 
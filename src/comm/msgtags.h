@@ -143,6 +143,23 @@ const int MSG_NOTIFY_ASSIGNMENT_UPDATE = 40;
 
 const int MSG_NOTIFY_CLIENT_JOB_ABORTING = 41;
 const int MSG_OFFER_ADOPTION_OF_ROOT = 42;
+/*
+The sender informs the receiver (on the same host) that the queried job description
+revision can be fetched from the host description store.
+Data type: [jobId, revision]
+*/
+const int MSG_NOTIFY_JOB_DESCRIPTION_IN_HOST_STORE = 43;
+/*
+The sender transfers a chunk of a job description revision to the receiver
+which may forward it right away to further processes waiting for the revision.
+Data type: ChunkedDescription::ChunkHeader followed by the chunk's bytes
+*/
+const int MSG_SEND_JOB_DESCRIPTION_CHUNK = 44;
+/*
+The sender gossips its estimate of the number of idle workers on each host.
+Data type: [version, #idle workers] for each host
+*/
+const int MSG_NOTIFY_IDLE_REGION_SUMMARY = 45;
 
 const int MSG_SCHED_INITIALIZE_CHILD_WITH_NODES = 51; // downwards
 const int MSG_SCHED_RETURN_NODES = 52; // upwards
@@ -160,6 +177,8 @@ const int MSG_ALLREDUCE_CLAUSES = 417;
 const int MSG_ALLREDUCE_FILTER = 418;
 const int MSG_AGGREGATE_RANKLIST = 419;
 const int MSG_BROADCAST_RANKLIST = 420; // blaze it
+const int MSG_ALLREDUCE_MEMBERS = 421;
+const int MSG_NOTIFY_ABSENT_MEMBERS = 422;
 
 
 
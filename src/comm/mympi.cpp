@@ -16,11 +16,12 @@
 
 MessageQueue* MyMpi::_msg_queue;
 
-void MyMpi::init() {
+void MyMpi::init(bool threadMultiple) {
+    int required = threadMultiple ? MPI_THREAD_MULTIPLE : MPI_THREAD_FUNNELED;
     int provided = -1;
-    MPICALL(MPI_Init_thread(nullptr, nullptr, MPI_THREAD_FUNNELED, &provided), std::string("init"))
-    if (provided != MPI_THREAD_FUNNELED) {
-        std::cout << "[ERROR] MPI: wanted id=" << MPI_THREAD_FUNNELED 
+    MPICALL(MPI_Init_thread(nullptr, nullptr, required, &provided), std::string("init"))
+    if (provided < required) {
+        std::cout << "[ERROR] MPI: wanted id=" << required 
                 << ", got id=" << provided << std::endl;
         Process::doExit(1);
     }
@@ -37,7 +38,10 @@ size_t MyMpi::getBinaryTreeBufferLimit(int numWorkers, int baseSize, float disco
 
 void MyMpi::setOptions(const Parameters& params) {
     int verb = MyMpi::rank(MPI_COMM_WORLD) == 0 ? V2_INFO : V4_VVER;
-    _msg_queue = new MessageQueue(params.messageBatchingThreshold());
+    _msg_queue = new MessageQueue(params.messageBatchingThreshold(), params.numReceiveSlots());
+    if (params.sharedMemoryTransportKb() > 0) 
+        _msg_queue->enableSharedMemoryTransport(1024UL * params.sharedMemoryTransportKb());
+    if (params.mpiProgressThread()) _msg_queue->startProgressThread(params.sleepMicrosecs());
 }
 
 int MyMpi::isend(int recvRank, int tag, const Serializable& object) {
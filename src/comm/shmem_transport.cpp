@@ -0,0 +1,64 @@
+
+#include "shmem_transport.hpp"
+
+#include <new>
+#include <sys/mman.h>
+
+#include "comm/mpi_base.hpp"
+#include "comm/host_comm.hpp"
+#include "util/sys/shared_memory.hpp"
+#include "util/logger.hpp"
+
+ShmemTransport::~ShmemTransport() {
+    for (auto& channel : _incoming) munmap((void*) channel.ring, _segment_size);
+    for (auto& [peer, channel] : _outgoing) munmap((void*) channel.ring, _segment_size);
+}
+
+void ShmemTransport::init(size_t ringCapacity) {
+
+    _ring_capacity = (ringCapacity + 63) & ~((size_t) 63);
+    _segment_size = sizeof(Ring) + _ring_capacity;
+
+    int myRank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &myRank);
+    std::string prefix = HostComm::getSharedMemoryPrefix(MPI_COMM_WORLD, "mq");
+    auto getSpecifier = [&](int source, int dest) {
+        return prefix + std::to_string(source) + "." + std::to_string(dest);
+    };
+
+    // Find all processes which can share memory with this process
+    std::vector<int> hostRanks;
+    MPI_Comm hostComm = HostComm::splitBySharedMemory(MPI_COMM_WORLD, hostRanks);
+
+    // Each process creates the rings it receives from ...
+    for (int peer : hostRanks) {
+        if (peer == myRank) continue;
+        std::string specifier = getSpecifier(peer, myRank);
+        void* mem = SharedMemory::create(specifier, _segment_size);
+        Ring* ring = new (mem) Ring();
+        ring->capacity = _ring_capacity;
+        _incoming.push_back(Channel{peer, specifier, ring});
+    }
+    MPI_Barrier(hostComm);
+
+    // ... and then attaches to the rings it sends to
+    for (int peer : hostRanks) {
+        if (peer == myRank) continue;
+        std::string specifier = getSpecifier(myRank, peer);
+        void* mem = SharedMemory::access(specifier, _segment_size);
+        if (mem == nullptr) {
+            LOG(V1_WARN, "[WARN] Cannot access shared memory ring to [%i]\n", peer);
+            continue;
+        }
+        _outgoing[peer] = Channel{peer, specifier, (Ring*) mem};
+    }
+    MPI_Barrier(hostComm);
+
+    // All rings are mapped: no need to keep the files around
+    for (auto& channel : _incoming) shm_unlink(channel.specifier.c_str());
+    MPI_Comm_free(&hostComm);
+
+    _enabled = true;
+    LOG(V3_VERB, "Shared memory transport to %i local processes (%lu bytes per ring)\n",
+        _outgoing.size(), _ring_capacity);
+}
@@ -0,0 +1,151 @@
+
+#ifndef DOMPASCH_MALLOB_SHMEM_TRANSPORT_HPP
+#define DOMPASCH_MALLOB_SHMEM_TRANSPORT_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "util/hashing.hpp"
+
+// Transport of messages between processes on the same host via one single-producer,
+// single-consumer ring buffer in shared memory per ordered pair of processes.
+// Each record consists of a small header (message size and tag) followed by the
+// message itself, padded to a multiple of eight bytes; records may wrap around
+// the end of the ring. A record which does not fit into the ring's free space
+// is written and read piece by piece, so messages of any size can be sent.
+// Messages of each pair are received in the order they are sent.
+class ShmemTransport {
+
+private:
+    struct Ring {
+        alignas(64) std::atomic<uint64_t> head {0}; // only written by the consumer
+        alignas(64) std::atomic<uint64_t> tail {0}; // only written by the producer
+        alignas(64) uint64_t capacity {0};
+        // The ring's data follows directly after this struct
+        uint8_t* data() {return ((uint8_t*) this) + sizeof(Ring);}
+    };
+    struct RecordHeader {
+        uint64_t size;
+        int32_t tag;
+        int32_t padding;
+    };
+    struct Channel {
+        int peer;
+        std::string specifier;
+        Ring* ring;
+        // Number of bytes of the current record written (or read) so far
+        size_t numTransferred {0};
+        // Incoming channels: the current record
+        RecordHeader header {};
+        std::vector<uint8_t> data {};
+    };
+
+    bool _enabled = false;
+    size_t _ring_capacity = 0;
+    size_t _segment_size = 0;
+    std::vector<Channel> _incoming;
+    robin_hood::unordered_map<int, Channel> _outgoing;
+    size_t _next_incoming = 0;
+
+public:
+    ~ShmemTransport();
+
+    // Collective operation over MPI_COMM_WORLD: sets up the rings between
+    // all pairs of processes which can share memory.
+    void init(size_t ringCapacity);
+
+    bool isEnabled() const {return _enabled;}
+    bool canReach(int rank) const {return _outgoing.count(rank);}
+    int getNumPeers() const {return _outgoing.size();}
+
+    // Writes as much of the message into the ring to the destination as fits.
+    // Returns true iff the message has been written completely. Otherwise, the call
+    // must be repeated with the same message (before any other message to this
+    // destination) until it returns true.
+    bool trySend(int dest, int tag, const std::vector<uint8_t>& data) {
+        auto& channel = _outgoing.at(dest);
+        auto& ring = *channel.ring;
+        uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+        const uint64_t head = ring.head.load(std::memory_order_acquire);
+        size_t space = ring.capacity - (tail - head);
+        if (channel.numTransferred == 0) {
+            // Begin the record with its header
+            if (space < sizeof(RecordHeader)) return false;
+            RecordHeader header {data.size(), tag, 0};
+            copyIn(ring, tail, (const uint8_t*) &header, sizeof(RecordHeader));
+            tail += sizeof(RecordHeader);
+            space -= sizeof(RecordHeader);
+            channel.numTransferred = sizeof(RecordHeader);
+        }
+        const size_t offset = channel.numTransferred - sizeof(RecordHeader);
+        const size_t size = std::min(space, padded(data.size()) - offset);
+        if (offset < data.size()) 
+            copyIn(ring, tail, data.data() + offset, std::min(size, data.size() - offset));
+        ring.tail.store(tail + size, std::memory_order_release);
+        channel.numTransferred += size;
+        if (channel.numTransferred < sizeof(RecordHeader) + padded(data.size())) return false;
+        channel.numTransferred = 0;
+        return true;
+    }
+
+    // Calls f(int source, int tag, std::vector<uint8_t>&& data) for up to maxMessages
+    // received messages, visiting the incoming rings in a round robin fashion.
+    // Returns the number of received messages.
+    template <typename F>
+    int receive(int maxMessages, F f) {
+        int numReceived = 0;
+        for (size_t i = 0; i < _incoming.size() && numReceived < maxMessages; i++) {
+            auto& channel = _incoming[(_next_incoming + i) % _incoming.size()];
+            auto& ring = *channel.ring;
+            uint64_t head = ring.head.load(std::memory_order_relaxed);
+            const uint64_t tail = ring.tail.load(std::memory_order_acquire);
+            while (numReceived < maxMessages) {
+                if (channel.numTransferred == 0) {
+                    // Begin a new record with its header
+                    if (tail - head < sizeof(RecordHeader)) break;
+                    copyOut(ring, head, (uint8_t*) &channel.header, sizeof(RecordHeader));
+                    channel.data.resize(channel.header.size);
+                    head += sizeof(RecordHeader);
+                    channel.numTransferred = sizeof(RecordHeader);
+                }
+                const size_t offset = channel.numTransferred - sizeof(RecordHeader);
+                const size_t size = std::min((size_t) (tail - head), padded(channel.header.size) - offset);
+                if (offset < channel.header.size) 
+                    copyOut(ring, head, channel.data.data() + offset, std::min(size, channel.header.size - offset));
+                head += size;
+                channel.numTransferred += size;
+                // Free the space before processing the message
+                ring.head.store(head, std::memory_order_release);
+                if (channel.numTransferred < sizeof(RecordHeader) + padded(channel.header.size)) break;
+                channel.numTransferred = 0;
+                f(channel.peer, (int) channel.header.tag, std::move(channel.data));
+                channel.data = std::vector<uint8_t>();
+                numReceived++;
+            }
+        }
+        if (!_incoming.empty()) _next_incoming = (_next_incoming+1) % _incoming.size();
+        return numReceived;
+    }
+
+private:
+    static size_t padded(size_t size) {return (size + 7) & ~((size_t) 7);}
+
+    static void copyIn(Ring& ring, uint64_t pos, const uint8_t* src, size_t size) {
+        size_t offset = pos % ring.capacity;
+        size_t firstPart = std::min(size, ring.capacity - offset);
+        memcpy(ring.data() + offset, src, firstPart);
+        memcpy(ring.data(), src + firstPart, size - firstPart);
+    }
+    static void copyOut(Ring& ring, uint64_t pos, uint8_t* dest, size_t size) {
+        size_t offset = pos % ring.capacity;
+        size_t firstPart = std::min(size, ring.capacity - offset);
+        memcpy(dest, ring.data() + offset, firstPart);
+        memcpy(dest + firstPart, ring.data(), size - firstPart);
+    }
+};
+
+#endif
@@ -0,0 +1,72 @@
+
+#include "chunked_description.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "util/assert.hpp"
+
+bool ChunkedDescription::isChunk(const std::vector<uint8_t>& msg) {
+    if (msg.size() < sizeof(ChunkHeader)) return false;
+    ChunkHeader header = readHeader(msg);
+    if (header.chunkSize == 0 || header.numChunks != getNumChunks(header.totalSize, header.chunkSize))
+        return false;
+    if (header.chunkIdx < 0 || header.chunkIdx >= header.numChunks) return false;
+    size_t begin = header.chunkIdx * header.chunkSize;
+    size_t end = std::min(header.totalSize, begin + header.chunkSize);
+    return msg.size() == sizeof(ChunkHeader) + (end-begin);
+}
+
+ChunkedDescription::ChunkHeader ChunkedDescription::readHeader(const std::vector<uint8_t>& msg) {
+    assert(msg.size() >= sizeof(ChunkHeader));
+    ChunkHeader header;
+    memcpy(&header, msg.data(), sizeof(ChunkHeader));
+    return header;
+}
+
+std::shared_ptr<std::vector<uint8_t>> ChunkedDescription::createChunk(int jobId, int revision,
+        const std::vector<uint8_t>& serialized, size_t chunkSize, int chunkIdx) {
+
+    ChunkHeader header {jobId, revision, chunkIdx, getNumChunks(serialized.size(), chunkSize),
+        serialized.size(), chunkSize};
+    assert(chunkIdx >= 0 && chunkIdx < header.numChunks);
+    size_t begin = chunkIdx * chunkSize;
+    size_t end = std::min(serialized.size(), begin + chunkSize);
+
+    auto msg = std::make_shared<std::vector<uint8_t>>(sizeof(ChunkHeader) + (end-begin));
+    memcpy(msg->data(), &header, sizeof(ChunkHeader));
+    memcpy(msg->data() + sizeof(ChunkHeader), serialized.data() + begin, end-begin);
+    return msg;
+}
+
+ChunkedDescription::ChunkedDescription(const ChunkHeader& header) : _header(header),
+    _data(new std::vector<uint8_t>(header.totalSize)), _received(header.numChunks, false) {}
+
+bool ChunkedDescription::insert(const std::vector<uint8_t>& msg) {
+    if (!isChunk(msg)) return false;
+    ChunkHeader header = readHeader(msg);
+    if (header.jobId != _header.jobId || header.revision != _header.revision
+        || header.totalSize != _header.totalSize || header.chunkSize != _header.chunkSize)
+        return false;
+    if (_received[header.chunkIdx]) return false;
+
+    size_t begin = header.chunkIdx * header.chunkSize;
+    memcpy(_data->data() + begin, msg.data() + sizeof(ChunkHeader), msg.size() - sizeof(ChunkHeader));
+    _received[header.chunkIdx] = true;
+    _num_received++;
+    return true;
+}
+
+std::vector<std::shared_ptr<std::vector<uint8_t>>> ChunkedDescription::getReceivedChunks() const {
+    std::vector<std::shared_ptr<std::vector<uint8_t>>> chunks;
+    for (int i = 0; i < _header.numChunks; i++) {
+        if (!_received[i]) continue;
+        chunks.push_back(createChunk(_header.jobId, _header.revision, *_data, _header.chunkSize, i));
+    }
+    return chunks;
+}
+
+std::shared_ptr<std::vector<uint8_t>> ChunkedDescription::extract() {
+    assert(isComplete());
+    return std::move(_data);
+}
@@ -0,0 +1,71 @@
+
+#ifndef DOMPASCH_MALLOB_CHUNKED_DESCRIPTION_HPP
+#define DOMPASCH_MALLOB_CHUNKED_DESCRIPTION_HPP
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+// A serialized job description revision which is transferred as a sequence of chunks.
+// Each chunk message is self-contained (job ID, revision, position within the revision),
+// so a process can forward every chunk down the job tree as soon as it arrives
+// while it is still assembling the revision for itself. Chunks may arrive in any order
+// and more than once.
+class ChunkedDescription {
+
+public:
+    struct ChunkHeader {
+        int jobId;
+        int revision;
+        int chunkIdx;
+        int numChunks;
+        size_t totalSize;
+        size_t chunkSize; // size of each chunk except for the last one
+    };
+
+private:
+    ChunkHeader _header;
+    std::shared_ptr<std::vector<uint8_t>> _data;
+    std::vector<bool> _received;
+    int _num_received = 0;
+    std::vector<int> _forward_dests;
+
+public:
+    static int getNumChunks(size_t totalSize, size_t chunkSize) {
+        return (totalSize + chunkSize - 1) / chunkSize;
+    }
+    static bool isChunk(const std::vector<uint8_t>& msg);
+    static ChunkHeader readHeader(const std::vector<uint8_t>& msg);
+    // Creates the message for the chunk at the given index of the provided serialized revision.
+    static std::shared_ptr<std::vector<uint8_t>> createChunk(int jobId, int revision,
+        const std::vector<uint8_t>& serialized, size_t chunkSize, int chunkIdx);
+
+    ChunkedDescription(const ChunkHeader& header);
+
+    // Copies the chunk into the revision. Returns false if the chunk does not
+    // belong to this revision or has been received before.
+    bool insert(const std::vector<uint8_t>& msg);
+
+    bool isComplete() const {return _num_received == _header.numChunks;}
+    bool hasChunk(int chunkIdx) const {return _received[chunkIdx];}
+    int getNumChunks() const {return _header.numChunks;}
+    int getNumReceivedChunks() const {return _num_received;}
+    size_t getTotalSize() const {return _header.totalSize;}
+    size_t getChunkSize() const {return _header.chunkSize;}
+
+    // The revision as assembled so far: only the received chunks are valid.
+    const std::shared_ptr<std::vector<uint8_t>>& getData() const {return _data;}
+
+    // Messages for all chunks received so far, e.g., for a process
+    // which starts to wait for this revision only now.
+    std::vector<std::shared_ptr<std::vector<uint8_t>>> getReceivedChunks() const;
+
+    // Processes to forward each further incoming chunk to.
+    void addForwardDestination(int rank) {_forward_dests.push_back(rank);}
+    const std::vector<int>& getForwardDestinations() const {return _forward_dests;}
+
+    // Returns the complete serialized revision.
+    std::shared_ptr<std::vector<uint8_t>> extract();
+};
+
+#endif
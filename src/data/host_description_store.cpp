@@ -0,0 +1,160 @@
+
+#include "host_description_store.hpp"
+
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "comm/mpi_base.hpp"
+#include "comm/host_comm.hpp"
+#include "util/logger.hpp"
+
+void HostDescriptionStore::init() {
+    _prefix = HostComm::getSharedMemoryPrefix(MPI_COMM_WORLD, "desc");
+    _enabled = true;
+}
+
+JobDescription::SerializationView HostDescriptionStore::publish(int jobId, int revision, 
+        const Checksum& checksum, const std::vector<uint8_t>& data) {
+    if (!_enabled) return JobDescription::SerializationView();
+    auto it = _segments.find({jobId, revision});
+    if (it != _segments.end()) return it->second.view;
+
+    std::string name = getSegmentName(jobId, revision);
+    size_t mappedSize = sizeof(Header) + data.size();
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+    if (fd == -1) {
+        // Present already (or just being written): try to share it
+        const Segment* segment = errno == EEXIST ? attach(jobId, revision, &checksum) : nullptr;
+        return segment ? segment->view : JobDescription::SerializationView();
+    }
+    if (ftruncate(fd, mappedSize) == -1) {
+        LOG(V1_WARN, "[WARN] Cannot allocate %lu bytes for #%i rev. %i in host description store\n",
+            mappedSize, jobId, revision);
+        close(fd);
+        shm_unlink(name.c_str());
+        return JobDescription::SerializationView();
+    }
+    void* mem = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        return JobDescription::SerializationView();
+    }
+
+    Header* header = new (mem) Header();
+    header->refCount.store(1, std::memory_order_relaxed);
+    header->size = data.size();
+    header->checksum = checksum;
+    memcpy(((uint8_t*) mem) + sizeof(Header), data.data(), data.size());
+    header->complete.store(true, std::memory_order_release);
+    LOG(V5_DEBG, "Published #%i rev. %i (%lu bytes) to host description store\n", jobId, revision, data.size());
+    return insert(jobId, revision, header, mappedSize)->view;
+}
+
+JobDescription::SerializationView HostDescriptionStore::fetch(int jobId, int revision, const Checksum* expectedChecksum) {
+    const Segment* segment = attach(jobId, revision, expectedChecksum);
+    return segment ? segment->view : JobDescription::SerializationView();
+}
+
+HostDescriptionStore::Reference HostDescriptionStore::getReference(int jobId, int revision,
+        size_t formulaOffset, size_t assumptionsOffset) {
+    const auto& segment = _segments.at({jobId, revision});
+    Reference ref;
+    memset(&ref, 0, sizeof(Reference));
+    std::string name = getSegmentName(jobId, revision);
+    strncpy(ref.segmentName, name.c_str(), sizeof(ref.segmentName)-1);
+    ref.segmentSize = segment.mappedSize;
+    ref.formulaOffset = formulaOffset;
+    ref.assumptionsOffset = assumptionsOffset;
+    return ref;
+}
+
+void HostDescriptionStore::release(int jobId) {
+    if (!_enabled) return;
+    for (auto it = _segments.begin(); it != _segments.end(); ) {
+        if (it->first.first == jobId) it = _segments.erase(it);
+        else ++it;
+    }
+}
+
+void HostDescriptionStore::releaseAll() {
+    _segments.clear();
+}
+
+const uint8_t* HostDescriptionStore::mapReadOnly(const Reference& ref) {
+    int fd = shm_open(ref.segmentName, O_RDONLY, 0);
+    if (fd == -1) return nullptr;
+    void* mem = mmap(nullptr, ref.segmentSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED) return nullptr;
+    return getData((const Header*) mem);
+}
+
+const HostDescriptionStore::Segment* HostDescriptionStore::attach(int jobId, int revision, const Checksum* expectedChecksum) {
+    if (!_enabled) return nullptr;
+
+    auto it = _segments.find({jobId, revision});
+    if (it != _segments.end()) return &it->second;
+
+    std::string name = getSegmentName(jobId, revision);
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd == -1) return nullptr;
+    struct stat st;
+    if (fstat(fd, &st) == -1 || st.st_size < (off_t) sizeof(Header)) {
+        close(fd);
+        return nullptr;
+    }
+    size_t mappedSize = st.st_size;
+    void* mem = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED) return nullptr;
+
+    Header* header = (Header*) mem;
+    bool valid = header->complete.load(std::memory_order_acquire)
+        && sizeof(Header) + header->size == mappedSize
+        && (expectedChecksum == nullptr || (header->checksum.get() == expectedChecksum->get()
+            && header->checksum.count() == expectedChecksum->count()));
+    if (!valid || !acquire(header)) {
+        // Incomplete, mismatching, or just being removed
+        munmap(mem, mappedSize);
+        return nullptr;
+    }
+    LOG(V5_DEBG, "Attached to #%i rev. %i (%lu bytes) in host description store\n", jobId, revision, header->size);
+    return insert(jobId, revision, header, mappedSize);
+}
+
+const HostDescriptionStore::Segment* HostDescriptionStore::insert(int jobId, int revision, 
+        Header* header, size_t mappedSize) {
+    // The mapping and this process' reference are released as soon as neither the store
+    // nor any other holder of the view need the revision any more. This may happen
+    // in another thread: the deleter must not access the store's state.
+    std::string name = getSegmentName(jobId, revision);
+    JobDescription::SerializationView view;
+    view.data = std::shared_ptr<const uint8_t>(getData(header), [name, header, mappedSize](const uint8_t*) {
+        releaseSegment(name, header, mappedSize);
+    });
+    view.size = header->size;
+    return &(_segments[{jobId, revision}] = Segment{std::move(view), mappedSize});
+}
+
+bool HostDescriptionStore::acquire(Header* header) {
+    int count = header->refCount.load(std::memory_order_relaxed);
+    while (count > 0) {
+        if (header->refCount.compare_exchange_weak(count, count+1, std::memory_order_acq_rel))
+            return true;
+    }
+    return false;
+}
+
+void HostDescriptionStore::releaseSegment(const std::string& name, Header* header, size_t mappedSize) {
+    if (header->refCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        // Last reference on this host: remove the segment
+        shm_unlink(name.c_str());
+        LOG(V5_DEBG, "Removed %s from host description store\n", name.c_str());
+    }
+    munmap((void*) header, mappedSize);
+}
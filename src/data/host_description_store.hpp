@@ -0,0 +1,96 @@
+
+#ifndef DOMPASCH_MALLOB_HOST_DESCRIPTION_STORE_HPP
+#define DOMPASCH_MALLOB_HOST_DESCRIPTION_STORE_HPP
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "data/checksum.hpp"
+#include "data/job_description.hpp"
+#include "util/hashing.hpp"
+
+// Process-wide access to a per-host store of serialized job description revisions
+// in shared memory. Each revision is kept in one segment identified by (job ID, revision)
+// which also holds the revision's checksum. All processes of this program run on the
+// same host can publish and fetch revisions, and solver subprocesses can map them
+// read-only. Segments are reference-counted across processes: a process holds a
+// reference for each revision it published or fetched until it released the job
+// and all views of the revision are gone, and the last process to release a revision
+// removes the segment.
+class HostDescriptionStore {
+
+public:
+    // Location of a revision's payload, handed to solver subprocesses
+    struct Reference {
+        char segmentName[64];
+        size_t segmentSize;
+        size_t formulaOffset;
+        size_t assumptionsOffset;
+    };
+
+private:
+    struct Header {
+        std::atomic_int refCount {0};
+        std::atomic_bool complete {false};
+        size_t size {0};
+        Checksum checksum;
+    };
+    struct Segment {
+        JobDescription::SerializationView view;
+        size_t mappedSize;
+    };
+
+    static inline bool _enabled = false;
+    static inline std::string _prefix;
+    static inline robin_hood::unordered_map<std::pair<int, int>, Segment, IntPairHasher> _segments;
+
+public:
+    // Collective operation over MPI_COMM_WORLD.
+    static void init();
+    static bool isEnabled() {return _enabled;}
+
+    // Publishes a serialized revision unless it is present already. In either case,
+    // this process holds a reference to the revision afterwards and a read-only view
+    // of the shared revision is returned, which can replace the provided data.
+    // Returns an empty view if the revision cannot be shared.
+    static JobDescription::SerializationView publish(int jobId, int revision, 
+        const Checksum& checksum, const std::vector<uint8_t>& data);
+
+    // Returns a read-only view of the revision if some process on this host published it
+    // (and its checksum matches, if provided), otherwise an empty view.
+    // On success, this process holds a reference to the revision afterwards.
+    static JobDescription::SerializationView fetch(int jobId, int revision, const Checksum* expectedChecksum = nullptr);
+
+    // Whether this process holds a reference to the revision.
+    static bool holds(int jobId, int revision) {return _enabled && _segments.count({jobId, revision});}
+
+    // Location of the revision's payload (which must be held by this process)
+    // at the given offsets of the serialized revision.
+    static Reference getReference(int jobId, int revision, size_t formulaOffset, size_t assumptionsOffset);
+
+    // Releases all revisions of the job held by this process.
+    // Views of these revisions remain valid until they are destructed.
+    static void release(int jobId);
+    // Releases all revisions held by this process.
+    static void releaseAll();
+
+    // For solver subprocesses: maps the referenced segment read-only
+    // and returns the beginning of the serialized revision, or nullptr.
+    static const uint8_t* mapReadOnly(const Reference& ref);
+
+private:
+    static std::string getSegmentName(int jobId, int revision) {
+        return _prefix + std::to_string(jobId) + "." + std::to_string(revision);
+    }
+    static const uint8_t* getData(const Header* header) {
+        return ((const uint8_t*) header) + sizeof(Header);
+    }
+    static const Segment* attach(int jobId, int revision, const Checksum* expectedChecksum);
+    static const Segment* insert(int jobId, int revision, Header* header, size_t mappedSize);
+    static bool acquire(Header* header);
+    static void releaseSegment(const std::string& name, Header* header, size_t mappedSize);
+};
+
+#endif
@@ -17,6 +17,7 @@
 #include "util/sys/watchdog.hpp"
 #include "util/sys/proc.hpp"
 #include "util/data_statistics.hpp"
+#include "data/host_description_store.hpp"
 
 JobDatabase::JobDatabase(Parameters& params, MPI_Comm& comm, WorkerSysState& sysstate):
         _params(params), _comm(comm), _sys_state(sysstate) {
@@ -58,26 +59,70 @@ Job& JobDatabase::createJob(int commSize, int worldRank, int jobId, JobDescripti
 
 bool JobDatabase::appendRevision(int jobId, const std::shared_ptr<std::vector<uint8_t>>& description, int source) {
 
+    int rev = JobDescription::readRevisionIndex(*description);
+    if (!canAppendRevision(jobId, rev, description->size())) return false;
+
+    // Push revision description, only keeping the host's shared copy if possible
+    auto view = publishRevision(jobId, rev, description);
+    if (view) get(jobId).pushRevision(view);
+    else get(jobId).pushRevision(description);
+    return true;
+}
+
+bool JobDatabase::appendRevision(int jobId, const JobDescription::SerializationView& description, int source) {
+
+    int rev = JobDescription::readRevisionIndex(description.data.get(), description.size);
+    if (!canAppendRevision(jobId, rev, description.size)) return false;
+
+    // Push revision description
+    get(jobId).pushRevision(description);
+    return true;
+}
+
+bool JobDatabase::appendIncompleteRevision(int jobId, const std::shared_ptr<std::vector<uint8_t>>& description, int source) {
+
+    if (!canAppendRevision(jobId, 0, description->size())) return false;
+
+    // Push the revision's meta data; the payload is still being received
+    get(jobId).pushIncompleteRevision(description);
+    return true;
+}
+
+void JobDatabase::completeRevision(int jobId, const std::shared_ptr<std::vector<uint8_t>>& description) {
+
+    auto& job = get(jobId);
+    assert(job.hasIncompleteDescription());
+    auto view = publishRevision(jobId, 0, description);
+    if (view) job.completeRevision(view);
+    else job.completeRevision(description);
+}
+
+JobDescription::SerializationView JobDatabase::publishRevision(int jobId, int rev, 
+        const std::shared_ptr<std::vector<uint8_t>>& description) {
+
+    // Offer the revision to other processes on this host
+    if (!HostDescriptionStore::isEnabled()) return JobDescription::SerializationView();
+    return HostDescriptionStore::publish(jobId, rev, JobDescription::readChecksum(*description), *description);
+}
+
+bool JobDatabase::canAppendRevision(int jobId, int rev, size_t size) {
+
     if (!has(jobId)) {
-        LOG(V1_WARN, "[WARN] Unknown job #%i : discard desc. of size %i\n", jobId, description->size());
+        LOG(V1_WARN, "[WARN] Unknown job #%i : discard desc. of size %i\n", jobId, size);
         return false;
     }
     auto& job = get(jobId);
-    int rev = JobDescription::readRevisionIndex(*description);
     if (job.hasDescription()) {
         if (rev != job.getMaxConsecutiveRevision()+1) {
             // Revision data would cause a "hole" in the list of job revision data
             LOG(V1_WARN, "[WARN] #%i rev. %i inconsistent w/ max. consecutive rev. %i : discard desc. of size %i\n", 
-                jobId, rev, job.getMaxConsecutiveRevision(), description->size());
+                jobId, rev, job.getMaxConsecutiveRevision(), size);
             return false;
         }
     } else if (rev != 0) {
-        LOG(V1_WARN, "[WARN] #%i invalid \"first\" rev. %i : discard desc. of size %i\n", jobId, rev, description->size());
+        LOG(V1_WARN, "[WARN] #%i invalid \"first\" rev. %i : discard desc. of size %i\n", jobId, rev, size);
             return false;
     }
-
-    // Push revision description
-    job.pushRevision(description);
     return true;
 }
 
@@ -453,6 +498,9 @@ void JobDatabase::forgetOldJobs() {
         Job* job = *it;
         if (job->isDestructible()) {
             LOG(V4_VVER, "%s : order deletion\n", job->toStr());
+            // Only now, no subprocess of the job can still be mapping its description
+            // (unless the job has been re-created, which keeps using this process' references)
+            if (!has(job->getId())) HostDescriptionStore::release(job->getId());
             // Move pointer to "free" queue emptied by janitor thread
             {
                 auto lock = _janitor_mutex.getLock();
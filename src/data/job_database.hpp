@@ -73,6 +73,9 @@ public:
 
     Job& createJob(int commSize, int worldRank, int jobId, JobDescription::Application application);
     bool appendRevision(int jobId, const std::shared_ptr<std::vector<uint8_t>>& description, int source);
+    bool appendRevision(int jobId, const JobDescription::SerializationView& description, int source);
+    bool appendIncompleteRevision(int jobId, const std::shared_ptr<std::vector<uint8_t>>& description, int source);
+    void completeRevision(int jobId, const std::shared_ptr<std::vector<uint8_t>>& description);
     void execute(int jobId, int source);
 
     bool checkComputationLimits(int jobId);
@@ -146,6 +149,8 @@ public:
     std::string toStr(int j, int idx) const;
 
 private:
+    bool canAppendRevision(int jobId, int rev, size_t size);
+    JobDescription::SerializationView publishRevision(int jobId, int rev, const std::shared_ptr<std::vector<uint8_t>>& description);
     void runJanitor();
     
 };
@@ -1,5 +1,6 @@
 
 #include "util/assert.hpp"
+#include <algorithm>
 
 #include "job_description.hpp"
 #include "util/logger.hpp"
@@ -8,6 +9,8 @@
 void JobDescription::beginInitialization(int revision) {
     _revision = revision;
     while (_revision >= _data_per_revision.size()) _data_per_revision.emplace_back();
+    while ((size_t) _revision >= _view_per_revision.size()) _view_per_revision.emplace_back();
+    _view_per_revision[_revision] = SerializationView();
     _data_per_revision[_revision].reset(new std::vector<uint8_t>(
         getMetadataSize()
     ));
@@ -65,30 +68,38 @@ std::shared_ptr<std::vector<uint8_t>>& JobDescription::getRevisionData(int revis
     return _data_per_revision.at(revision);
 }
 
+const uint8_t* JobDescription::getSerializationBegin(int revision) const {
+    assert(revision >= 0 && (size_t) revision < _view_per_revision.size());
+    const auto& view = _view_per_revision[revision];
+    return view ? view.data.get() : getRevisionData(revision)->data();
+}
+
 size_t JobDescription::getFormulaPayloadSize(int revision) const {
     size_t fSize;
-    memcpy(&fSize, getRevisionData(revision)->data()+3*sizeof(int), sizeof(size_t));
+    memcpy(&fSize, getSerializationBegin(revision)+3*sizeof(int), sizeof(size_t));
     return fSize;
 }
 
 size_t JobDescription::getAssumptionsSize(int revision) const {
     size_t aSize;
-    memcpy(&aSize, getRevisionData(revision)->data()+3*sizeof(int)+sizeof(size_t), sizeof(size_t));
+    memcpy(&aSize, getSerializationBegin(revision)+3*sizeof(int)+sizeof(size_t), sizeof(size_t));
     return aSize;
 }
 
 const int* JobDescription::getFormulaPayload(int revision) const {
     size_t pos = getMetadataSize();
-    return (const int*) (getRevisionData(revision)->data()+pos);
+    return (const int*) (getSerializationBegin(revision)+pos);
 }
 
 const int* JobDescription::getAssumptionsPayload(int revision) const {
     size_t pos = getMetadataSize() + sizeof(int)*getFormulaPayloadSize(revision);
-    return (const int*) (getRevisionData(revision)->data()+pos);
+    return (const int*) (getSerializationBegin(revision)+pos);
 }
 
 size_t JobDescription::getTransferSize(int revision) const {
-    return getRevisionData(revision)->size();
+    assert(revision >= 0 && (size_t) revision < _view_per_revision.size());
+    const auto& view = _view_per_revision[revision];
+    return view ? view.size : getRevisionData(revision)->size();
 }
 
 
@@ -105,81 +116,117 @@ int JobDescription::getMetadataSize() const {
 
 
 int JobDescription::readRevisionIndex(const std::vector<uint8_t>& serialized) {
-    assert(serialized.size() >= 3*sizeof(int)+2*sizeof(size_t));
+    return readRevisionIndex(serialized.data(), serialized.size());
+}
+
+int JobDescription::readRevisionIndex(const uint8_t* serialized, [[maybe_unused]] size_t size) {
+    assert(size >= 3*sizeof(int)+2*sizeof(size_t));
     int revision;
-    memcpy(&revision, serialized.data()+sizeof(int), sizeof(int));
+    memcpy(&revision, serialized+sizeof(int), sizeof(int));
     assert(revision >= 0);
     return revision;
 }
 
-int JobDescription::prepareRevision(const std::vector<uint8_t>& packed) {
-    int revision = JobDescription::readRevisionIndex(packed);
+Checksum JobDescription::readChecksum(const std::vector<uint8_t>& serialized) {
+    size_t pos = 6*sizeof(int) + 3*sizeof(float) + 2*sizeof(size_t) + sizeof(Application);
+    assert(serialized.size() >= pos+sizeof(Checksum));
+    Checksum checksum;
+    memcpy(&checksum, serialized.data()+pos, sizeof(Checksum));
+    return checksum;
+}
+
+bool JobDescription::isMetadataContained(const std::vector<uint8_t>& serialized, size_t numBytes) {
+    size_t pos = 6*sizeof(int) + 3*sizeof(float) + 2*sizeof(size_t) + sizeof(Checksum) + sizeof(Application);
+    numBytes = std::min(numBytes, serialized.size());
+    if (numBytes < pos+sizeof(int)) return false;
+    int configSize;
+    memcpy(&configSize, serialized.data()+pos, sizeof(int));
+    return configSize >= 0 && numBytes >= pos+sizeof(int)+configSize;
+}
+
+int JobDescription::prepareRevision(const uint8_t* packed, size_t size) {
+    int revision = JobDescription::readRevisionIndex(packed, size);
     while (revision >= _data_per_revision.size()) _data_per_revision.emplace_back();
+    while ((size_t) revision >= _view_per_revision.size()) _view_per_revision.emplace_back();
+    _view_per_revision[revision] = SerializationView();
     return revision;
 }
 
 JobDescription& JobDescription::deserialize(std::vector<uint8_t>&& packed) {
-    int revision = prepareRevision(packed);
+    int revision = prepareRevision(packed.data(), packed.size());
     _data_per_revision[revision].reset(new std::vector<uint8_t>(std::move(packed)));
     deserialize();
     return *this;
 }
 
 JobDescription& JobDescription::deserialize(const std::vector<uint8_t>& packed) {
-    int revision = prepareRevision(packed);
+    int revision = prepareRevision(packed.data(), packed.size());
     _data_per_revision[revision].reset(new std::vector<uint8_t>(packed));
     deserialize();
     return *this;
 }
 
 JobDescription& JobDescription::deserialize(const std::shared_ptr<std::vector<uint8_t>>& packed) {
-    int revision = prepareRevision(*packed.get());
+    int revision = prepareRevision(packed->data(), packed->size());
     _data_per_revision[revision] = packed;
     deserialize();
     return *this;
 }
 
+JobDescription& JobDescription::deserialize(const SerializationView& view) {
+    int revision = prepareRevision(view.data.get(), view.size);
+    _data_per_revision[revision].reset();
+    _view_per_revision[revision] = view;
+    deserialize();
+    return *this;
+}
+
 void JobDescription::deserialize() {
     size_t i = 0, n;
 
     // Basic data
     // TODO gracefully handle "holes" in data: go to max. revision r such that [0, r] is valid range.
-    auto& latestData = _data_per_revision.back();
-    n = sizeof(int);         memcpy(&_id, latestData->data()+i, n);              i += n;
-    n = sizeof(int);         memcpy(&_revision, latestData->data()+i, n);        i += n;
-    n = sizeof(int);         memcpy(&_client_rank, latestData->data()+i, n);     i += n;
-    n = sizeof(size_t);      memcpy(&_f_size, latestData->data()+i, n);          i += n;
-    n = sizeof(size_t);      memcpy(&_a_size, latestData->data()+i, n);          i += n;
-    n = sizeof(int);         memcpy(&_root_rank, latestData->data()+i, n);       i += n;
-    n = sizeof(float);       memcpy(&_priority, latestData->data()+i, n);        i += n;
-    n = sizeof(int);         memcpy(&_num_vars, latestData->data()+i, n);        i += n;
-    n = sizeof(float);       memcpy(&_wallclock_limit, latestData->data()+i, n); i += n;
-    n = sizeof(float);       memcpy(&_cpu_limit, latestData->data()+i, n);       i += n;
-    n = sizeof(int);         memcpy(&_max_demand, latestData->data()+i, n);      i += n;
-    n = sizeof(Application); memcpy(&_application, latestData->data()+i, n);     i += n;
-    n = sizeof(Checksum);    memcpy(&_checksum, latestData->data()+i, n);        i += n;
+    const uint8_t* latestData = getSerializationBegin(_data_per_revision.size()-1);
+    n = sizeof(int);         memcpy(&_id, latestData+i, n);              i += n;
+    n = sizeof(int);         memcpy(&_revision, latestData+i, n);        i += n;
+    n = sizeof(int);         memcpy(&_client_rank, latestData+i, n);     i += n;
+    n = sizeof(size_t);      memcpy(&_f_size, latestData+i, n);          i += n;
+    n = sizeof(size_t);      memcpy(&_a_size, latestData+i, n);          i += n;
+    n = sizeof(int);         memcpy(&_root_rank, latestData+i, n);       i += n;
+    n = sizeof(float);       memcpy(&_priority, latestData+i, n);        i += n;
+    n = sizeof(int);         memcpy(&_num_vars, latestData+i, n);        i += n;
+    n = sizeof(float);       memcpy(&_wallclock_limit, latestData+i, n); i += n;
+    n = sizeof(float);       memcpy(&_cpu_limit, latestData+i, n);       i += n;
+    n = sizeof(int);         memcpy(&_max_demand, latestData+i, n);      i += n;
+    n = sizeof(Application); memcpy(&_application, latestData+i, n);     i += n;
+    n = sizeof(Checksum);    memcpy(&_checksum, latestData+i, n);        i += n;
     // size of config
-    memcpy(&n, latestData->data()+i, sizeof(int)); i += sizeof(int);
+    memcpy(&n, latestData+i, sizeof(int)); i += sizeof(int);
     // bytes of config
-    std::string configSerialized = std::string((const char*) (latestData->data()+i), n);
+    std::string configSerialized = std::string((const char*) (latestData+i), n);
     _app_config.deserialize(configSerialized);
 }
 
 std::vector<uint8_t> JobDescription::serialize() const {
-    return *_data_per_revision[0];
+    return *getSerialization(0);
 }
 
-const std::shared_ptr<std::vector<uint8_t>>& JobDescription::getSerialization(int revision) const {
-    return getRevisionData(revision);
+std::shared_ptr<std::vector<uint8_t>> JobDescription::getSerialization(int revision) const {
+    assert(revision >= 0 && (size_t) revision < _view_per_revision.size());
+    const auto& view = _view_per_revision[revision];
+    if (!view) return getRevisionData(revision);
+    return std::shared_ptr<std::vector<uint8_t>>(
+        new std::vector<uint8_t>(view.data.get(), view.data.get()+view.size));
 }
 
 void JobDescription::clearPayload(int revision) {
     getRevisionData(revision).reset();
+    _view_per_revision[revision] = SerializationView();
 }
 
 int JobDescription::getMaxConsecutiveRevision() const {
     for (int r = 0; r < _data_per_revision.size(); r++) {
-        if (!_data_per_revision[r]) return r-1;
+        if (!_data_per_revision[r] && !_view_per_revision[r]) return r-1;
     }
     return _data_per_revision.size()-1;
 }
@@ -33,6 +33,15 @@ public:
         float latencyOf1stVolumeUpdate;
     };
 
+    // Read-only serialization of a revision which is held elsewhere (e.g., mapped from
+    // the host description store). The memory remains valid as long as a copy of the
+    // pointer is alive; its deleter releases the underlying memory.
+    struct SerializationView {
+        std::shared_ptr<const uint8_t> data;
+        size_t size {0};
+        explicit operator bool() const {return (bool) data;}
+    };
+
 private:
 
     // Global meta data
@@ -63,6 +72,8 @@ private:
     // For each revision, the shared_ptr contains the full serialization
     // of this revision including all meta data of this object.
     std::vector<std::shared_ptr<std::vector<uint8_t>>> _data_per_revision;
+    // Revisions which are not held as a vector of their own but as a view instead.
+    std::vector<SerializationView> _view_per_revision;
     
     // Stores the position (in bytes) and size (in integers) of each revision's payload.
     struct RevisionInfo {
@@ -96,6 +107,7 @@ public:
         if (_stats != nullptr) delete _stats;
         for (auto& data : _data_per_revision)
             data.reset();
+        _view_per_revision.clear();
     }
 
     // Moving job descriptions is okay
@@ -116,11 +128,13 @@ public:
         _f_size = std::move(other._f_size);
         _a_size = std::move(other._a_size);
         _data_per_revision = std::move(other._data_per_revision);
+        _view_per_revision = std::move(other._view_per_revision);
         _preloaded_literals = std::move(other._preloaded_literals);
         _preloaded_assumptions = std::move(other._preloaded_assumptions);
         _stats = std::move(other._stats);
         other._id = -1;
         other._data_per_revision.clear();
+        other._view_per_revision.clear();
         other._stats = nullptr;
         return *this;
     }
@@ -165,6 +179,7 @@ public:
     JobDescription& deserialize(const std::vector<uint8_t>& packed) override;
     JobDescription& deserialize(std::vector<uint8_t>&& packed);
     JobDescription& deserialize(const std::shared_ptr<std::vector<uint8_t>>& packed);
+    JobDescription& deserialize(const SerializationView& view);
     void deserialize();
 
     int getId() const {return _id;}
@@ -182,7 +197,7 @@ public:
     bool isIncremental() const {return isApplicationIncremental(_application);}
     int getMetadataSize() const;
     
-    size_t getFullNonincrementalTransferSize() const {return _data_per_revision[0]->size();}
+    size_t getFullNonincrementalTransferSize() const {return getTransferSize(0);}
     int getNumVars() {return _num_vars;}
 
     void setRootRank(int rootRank) {_root_rank = rootRank;}
@@ -202,7 +217,9 @@ public:
     void setChecksum(const Checksum& checksum) {_checksum = checksum;}
 
     std::vector<uint8_t> serialize() const override;
-    const std::shared_ptr<std::vector<uint8_t>>& getSerialization(int revision) const;
+    // Returns the revision's serialization, which is a copy if the revision is held as a view.
+    std::shared_ptr<std::vector<uint8_t>> getSerialization(int revision) const;
+    const uint8_t* getSerializationBegin(int revision) const;
     void clearPayload(int revision);
 
     int getMaxConsecutiveRevision() const;
@@ -218,6 +235,10 @@ public:
     size_t getTransferSize(int revision) const;
     
     static int readRevisionIndex(const std::vector<uint8_t>& serialized);
+    static int readRevisionIndex(const uint8_t* serialized, size_t size);
+    static Checksum readChecksum(const std::vector<uint8_t>& serialized);
+    // Whether the first numBytes bytes of the serialized revision contain all of its meta data.
+    static bool isMetadataContained(const std::vector<uint8_t>& serialized, size_t numBytes);
 
     Statistics& getStatistics() {
         if (_stats == nullptr) _stats = new Statistics();
@@ -227,7 +248,7 @@ public:
 private:
     std::shared_ptr<std::vector<uint8_t>>& getRevisionData(int revision);
     const std::shared_ptr<std::vector<uint8_t>>& getRevisionData(int revision) const;
-    int prepareRevision(const std::vector<uint8_t>& packed);
+    int prepareRevision(const uint8_t* packed, size_t size);
     
 };
 
@@ -12,5 +12,8 @@
 #define SYSSTATE_NUMDESIRES 6
 #define SYSSTATE_NUMFULFILLEDDESIRES 7
 #define SYSSTATE_SUMDESIRELATENCIES 8
+#define SYSSTATE_NUMMESSAGES 9
+#define SYSSTATE_MESSAGEBYTES 10
+#define SYSSTATE_CALLBACKTIME 11
 
-typedef SysState<9> WorkerSysState;
+typedef SysState<12> WorkerSysState;
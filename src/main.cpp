@@ -17,6 +17,7 @@
 #include "util/sys/thread_pool.hpp"
 #include "interface/api/job_streamer.hpp"
 #include "comm/host_comm.hpp"
+#include "data/host_description_store.hpp"
 #include "data/job_transfer.hpp"
 
 #ifndef MALLOB_VERSION
@@ -111,6 +112,9 @@ void doMainProgram(MPI_Comm& commWorkers, MPI_Comm& commClients, Parameters& par
     hostComm.create();
     if (isWorker) worker->setHostComm(hostComm);
 
+    // Set up the per-host store of job descriptions (collective operation)
+    if (params.hostDescriptionStore()) HostDescriptionStore::init();
+
     // If mono solving mode is enabled, introduce the singular job to solve
     if (params.monoFilename.isSet() && isClient && MyMpi::rank(commClients) == 0)
         introduceMonoJob(params, *client);
@@ -131,6 +135,9 @@ void doMainProgram(MPI_Comm& commWorkers, MPI_Comm& commClients, Parameters& par
         // Advance message queue and run callbacks for done messages
         MyMpi::getMessageQueue().advance();
 
+        // Send the volume updates of this cycle, including those triggered by the above callbacks
+        if (isWorker) worker->flushVolumeUpdates();
+
         // Check termination, sleep, and/or yield thread
         if (doTerminate(params, myRank)) 
             break;
@@ -155,8 +162,12 @@ void longStartupWarnMsg(int rank, const char* msg) {
 
 int main(int argc, char *argv[]) {
     
-    MyMpi::init();
+    // Parse parameters first since they determine the required MPI thread support
     Timer::init();
+    Parameters params;
+    params.init(argc, argv);
+
+    MyMpi::init(params.mpiProgressThread());
     Proc::nameThisThread("MainThread");
 
     int numNodes = MyMpi::size(MPI_COMM_WORLD);
@@ -164,8 +175,6 @@ int main(int argc, char *argv[]) {
 
     longStartupWarnMsg(rank, "Init'd MPI");
 
-    Parameters params;
-    params.init(argc, argv);
     if (rank == 0) params.printBanner();
 
     longStartupWarnMsg(rank, "Init'd params");
@@ -202,6 +211,7 @@ int main(int argc, char *argv[]) {
         if (rank == 0) {
             params.printUsage();
         }
+        MyMpi::getMessageQueue().stopProgressThread();
         MPI_Finalize();
         Process::doExit(0);
     }
@@ -268,6 +278,7 @@ int main(int argc, char *argv[]) {
     }
 
     // Exit properly
+    MyMpi::getMessageQueue().stopProgressThread();
     MPI_Barrier(MPI_COMM_WORLD);
     MPI_Finalize();
     LOG(V2_INFO, "Exiting happily\n");
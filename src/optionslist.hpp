@@ -14,28 +14,36 @@ OptMap _map;
 //  TYPE  member name                    option ID (short, long)                      default (, min, max)     description
 
 OPT_BOOL(abortNonincrementalSubprocess,  "ans", "abort-noninc-subproc",               false,                   "Abort (hence restart) each sub-process which works (partially) non-incrementally upon the arrival of a new revision")
+OPT_BOOL(adaptiveSharingVolume,          "asv", "adaptive-sharing-volume",            false,                   "Adapt each job's clause sharing volume per epoch based on admitted clauses, buffer fill and sharing latency")
 OPT_BOOL(collectClauseHistory,           "ch", "collect-clause-history",              false,                   "Employ clause history collection mechanism")
 OPT_BOOL(coloredOutput,                  "colors", "",                                false,                   "Colored terminal output based on messages' verbosity")
+OPT_BOOL(compressClauseBuffers,          "cbc", "compress-clause-buffers",            false,                   "Send clause buffers in a compressed (delta + varint) format during clause sharing")
 OPT_BOOL(continuousGrowth,               "cg", "continuous-growth",                   true,                    "Continuous growth of job demands")
 OPT_BOOL(distributedDuplicateDetection,  "ddd", "",                                   false,                   "Distributed duplicate detection for clauses")
 OPT_BOOL(delayMonkey,                    "delaymonkey", "",                           false,                   "Small chance for each MPI call to block for some random amount of time")
 OPT_BOOL(derandomize,                    "derandomize", "",                           true,                    "Derandomize job bouncing and build a <bounce-alternatives>-regular message graph instead")
+OPT_BOOL(dumpMessageMetrics,             "dmm", "dump-message-metrics",               false,                   "Write each worker's message metrics per tag (traffic, send latency, callback time) to <log-dir>/<rank>/msgmetrics.jsonl (or ./msgmetrics.<rank>.jsonl) after each system state aggregation")
 OPT_BOOL(useDormantChildren,             "dc", "dormant-children",                    false,                   "Simple strategy of maintaining local set of dormant child job contexts which the parent tries to reactivate")
 OPT_BOOL(explicitVolumeUpdates,          "evu", "explicit-volume-updates",            false,                   "Broadcast volume updates through job tree instead of letting each PE compute it itself")
 OPT_BOOL(groupClausesByLengthLbdSum,     "gclls", "group-by-length-lbd-sum",          false,                   "Group and prioritize clauses in buffers by the sum of clause length and LBD score")
+OPT_BOOL(hierarchicalClauseSharing,      "hcs", "hierarchical-clause-sharing",        false,                   "Aggregate shared clauses on each host first such that only one job node per host takes part in the inter-host all-reduction (costs an additional small round trip per epoch)")
 OPT_BOOL(help,                           "h", "help",                                 false,                   "Print help and exit")
+OPT_BOOL(hostDescriptionStore,           "hds", "host-description-store",             false,                   "Keep a single copy of each job description revision per host in shared memory, used by all co-located ranks and their solver subprocesses")
 OPT_BOOL(immediateFileFlush,             "iff", "immediate-file-flush",               false,                   "Flush log files after each line instead of buffering")
 OPT_BOOL(inotify,                        "inotify", "",                               true,                    "Use inotify for filesystem interface (otherwise, use naive directory polling)")
 OPT_BOOL(useFilesystemInterface,         "interface-fs", "",                          true,                    "Use filesystem interface (.api/{in,out}/*.json)")
 OPT_BOOL(useIPCSocketInterface,          "interface-ipc", "",                         false,                   "Use IPC socket interface (.mallob.<pid>.sk)")
 OPT_BOOL(jitterJobPriorities,            "jjp", "jitter-job-priorities",              false,                   "Jitter job priorities to break ties during rebalancing")
 OPT_BOOL(latencyMonkey,                  "latencymonkey", "",                         false,                   "Block all MPI_Isend operations by a small randomized amount of time")
+OPT_BOOL(localityPreservingPlacement,    "lpp", "locality-preserving-placement",      false,                   "Place each subtree of a job tree which fits onto a host on the host of its top node by default (pseudorandom placement otherwise and for busy processes)")
 OPT_BOOL(monitorMpi,                     "mmpi", "monitor-mpi",                       false,                   "Launch an additional thread per process checking when the main thread is inside an MPI call")
+OPT_BOOL(mpiProgressThread,              "mpt", "mpi-progress-thread",                false,                   "Perform all message passing in a dedicated thread per process (requires MPI_THREAD_MULTIPLE); the main thread only executes message callbacks")
 OPT_BOOL(omitSolution,                   "os", "omit-solution",                       false,                   "Do not output solution in mono mode of operation")
 OPT_BOOL(phaseDiversification,           "phasediv", "",                              true,                    "Diversify solvers based on phase in addition to native diversification")
 OPT_BOOL(pipeLargeSolutions,             "pls", "pipe-large-solutions",               false,                   "Provide large solutions over a named pipe instead of directly writing them into the response JSON")
 OPT_BOOL(quiet,                          "q", "quiet",                                false,                   "Do not log to stdout besides critical information")
 OPT_BOOL(reactivationScheduling,         "rs", "use-reactivation-scheduling",         true,                    "Perform reactivation-based scheduling")
+OPT_BOOL(regionRouting,                  "rr", "region-routing",                      false,                   "Route job requests towards hosts with idle workers (estimated via gossip), preferring the host of the requesting worker")
 OPT_BOOL(regularProcessDistribution,     "rpa", "regular-process-allocation",         false,                   "Signal that processes have been allocated regularly, i.e., the i-th machine hosts ranks c*i through c*i + c-1")
 OPT_BOOL(reshareImprovedLbd,             "ril", "reshare-improved-lbd",               false,                   "Reshare clauses (regardless of their last sharing epoch) if their LBD improved")
 OPT_BOOL(shuffleJobDescriptions,         "sjd", "shuffle-job-descriptions",           false,                   "Shuffle job descriptions given via -job-desc-template option")
@@ -51,6 +59,11 @@ OPT_INT(bufferedImportedClsGenerations,  "bicg", "buffered-imported-cls-generati
 OPT_INT(clauseBufferBaseSize,            "cbbs", "clause-buffer-base-size",           1500,      0, MAX_INT,   "Clause buffer base size in integers")
 OPT_INT(clauseHistoryAggregationFactor,  "chaf", "clause-history-aggregation",        5,         1, LARGE_INT, "Aggregate historic clause batches by this factor")
 OPT_INT(clauseHistoryShortTermMemSize,   "chstms", "clause-history-shortterm-size",   10,        1, LARGE_INT, "Save this many \"full\" aggregated epochs until reducing them")
+OPT_INT(descriptionChunkSize,            "dcs", "desc-chunk-size",                    0,    0, MAX_INT,        "Transfer job descriptions larger than this many bytes in chunks of this size, forwarded down the job tree while still being received (0: no chunking)")
+OPT_INT(distributedFilterGenerations,    "dfg", "distributed-filter-generations",     4,    1, 64,             "Number of generations of the approximate filter for distributed duplicate detection (memory is split among them)")
+OPT_INT(distributedFilterHashFunctions,  "dfh", "distributed-filter-hash-functions",  4,    1, 16,             "Number of hash functions of the approximate filter for distributed duplicate detection")
+OPT_INT(distributedFilterMemoryKb,       "dfm", "distributed-filter-memory",          0,    0, LARGE_INT,      "Memory (KiB) per PE of the approximate filter for distributed duplicate detection (0: exact filter)")
+OPT_INT(exportRingSize,                  "ers", "export-ring-size",                   65536, 256, MAX_INT,     "Capacity (in integers) of each solver's lock-free backlog of produced clauses waiting for the clause filter (raised to fit at least one clause of maximum length)")
 OPT_INT(firstApiIndex,                   "fapii", "first-api-index",                  0,    0, LARGE_INT,      "1st API index: with c clients, uses .api/jobs.{<index>..<index>+c-1}/ as directories")
 OPT_INT(hopsBetweenBfs,                  "hbbfs", "hops-between-bfs",                 10,   0, MAX_INT,        "After a job request hopped this many times after unsuccessful \"hill climbing\" BFS, perform another BFS")
 OPT_INT(hopsUntilBfs,                    "hubfs", "hops-until-bfs",                   LARGE_INT, 0, MAX_INT,   "After a job request hopped this many times, perform a \"hill climbing\" BFS")
@@ -64,16 +77,22 @@ OPT_INT(maxJobsPerStreamer,              "mjps", "max-jobs-per-streamer",
 OPT_INT(maxLbdPartitioningSize,          "mlbdps", "max-lbd-partition-size",          8,    1, LARGE_INT,      "Store clauses with up to this LBD in separate buckets")
 OPT_INT(messageBatchingThreshold,        "mbt", "message-batching-threshold",         1000000, 1000, MAX_INT,  "Employ batching of messages in batches of provided size")
 OPT_INT(minNumChunksForImportPerSolver,  "mcips", "min-import-chunks-per-solver",     10,   1, LARGE_INT,      "Min. number of cbbs-sized chunks for buffering produced clauses for export")
+OPT_INT(namedIdleRanks,                  "nir", "named-idle-ranks",                   8,    0, 1024,           "Number of idle PEs each PE names to its parent in collective assignment, so that requests can be sent to them directly")
 OPT_INT(numBounceAlternatives,           "ba", "bounce-alternatives",                 4,    1, LARGE_INT,      "Number of bounce alternatives per PE (only relevant if -derandomize)")
 OPT_INT(numChunksForExport,              "nce", "export-chunks",                      20,   1, LARGE_INT,      "Number of cbbs-sized chunks for buffering produced clauses for export")
+OPT_INT(numClauseSharingSegments,        "css", "clause-sharing-segments",            1,    1, 64,             "Split clause buffers into this many segments (by clause length) which are merged and forwarded in a pipelined fashion (1: no pipelining)")
 OPT_INT(numClients,                      "c", "clients",                              1,    -1, LARGE_INT,     "Number of client PEs to initialize (counting backwards from last rank), -1: all PEs are clients")
 OPT_INT(numJobs,                         "J", "jobs",                                 0,    0, LARGE_INT,      "Exit as soon as this number of jobs has been processed")
+OPT_INT(numMergeThreads,                 "mgt", "merge-threads",                      1,    1, LARGE_INT,      "Max. number of concurrent sub-merges when aggregating clause buffers (1: sequential merge)")
+OPT_INT(numReceiveSlots,                 "nrs", "receive-slots",                      4,    1, 64,             "Number of concurrently pre-posted receives of each process' message queue")
+OPT_INT(numSharingEpochsInFlight,        "sef", "sharing-epochs-in-flight",           1,    1, 8,              "Max. number of concurrent clause sharing epochs: a new epoch may begin while the previous epoch's filter is still in flight (1: no overlap)")
 OPT_INT(numThreadsPerProcess,            "t", "threads-per-process",                  1,    0, LARGE_INT,      "Number of worker threads per node")
 OPT_INT(maxLiteralsPerThread,            "mlpt", "max-lits-per-thread",               50000000, 0, MAX_INT,    "If formula is larger than threshold, reduce #threads per PE until #threads=1 or until limit is met \"on average\"")
 OPT_INT(processesPerHost,                "pph", "processes-per-host",                 0,    0, LARGE_INT,      "Tells Mallob how many MPI processes are executed on each physical host")
 OPT_INT(qualityClauseLengthLimit,        "qcll", "quality-clause-length-limit",       8,    0, LARGE_INT,      "Clauses up to this length are considered \"high quality\"")
 OPT_INT(qualityLbdLimit,                 "qlbdl", "quality-lbd-limit",                2,    0, LARGE_INT,      "Clauses with an LBD score up to this value are considered \"high quality\"")
 OPT_INT(seed,                            "seed", "",                                  0,    0, MAX_INT,        "Random seed")
+OPT_INT(sharedMemoryTransportKb,         "shmt", "shared-memory-transport-kb",        0,    0, LARGE_INT,      "Exchange all but fragmented messages among processes on the same host via shared memory rings of (at least) this many KB per pair of processes (0: always use MPI)")
 OPT_INT(sleepMicrosecs,                  "sleep", "",                                 100,  0, LARGE_INT,      "Sleep this many microseconds between loop cycles of worker main thread")
 OPT_INT(strictClauseLengthLimit,         "scll", "strict-clause-length-limit",        30,   0, LARGE_INT,      "Only clauses up to this length will be shared")
 OPT_INT(strictLbdLimit,                  "slbdl", "strict-lbd-limit",                 30,   0, LARGE_INT,      "Only clauses with an LBD score up to this value will be shared")
@@ -92,6 +111,7 @@ OPT_FLOAT(jobCommUpdatePeriod,           "jcup", "job-comm-update-period",
 OPT_FLOAT(jobCpuLimit,                   "jcl", "job-cpu-limit",                      0,    0, LARGE_INT,      "Timeout an instance after x cpu seconds")
 OPT_FLOAT(jobWallclockLimit,             "jwl", "job-wallclock-limit",                0,    0, LARGE_INT,      "Timeout an instance after x seconds wall clock time")
 OPT_FLOAT(loadFactor,                    "l", "load-factor",                          1,    0, 1,              "Load factor to be aimed at")
+OPT_FLOAT(maxSharingVolumeFactor,        "msvf", "max-sharing-volume-factor",         4,    1, LARGE_INT,      "Max. factor by which the adaptive sharing volume (-asv) may scale clause buffer limits")
 OPT_FLOAT(requestTimeout,                "rto", "request-timeout",                    0,    0, LARGE_INT,      "Request timeout: discard non-root job requests when older than this many seconds")
 OPT_FLOAT(sysstatePeriod,                "y", "sysstate-period",                      1,    0.1, 50,           "Period for aggregating and logging global system state")
 OPT_FLOAT(timeLimit,                     "T", "time-limit",                           0,    0, LARGE_INT,      "Run entire system for at most this many seconds")
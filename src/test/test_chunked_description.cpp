@@ -0,0 +1,160 @@
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "data/chunked_description.hpp"
+#include "data/job_description.hpp"
+#include "util/random.hpp"
+#include "util/sys/timer.hpp"
+#include "util/logger.hpp"
+#include "util/assert.hpp"
+
+// A revision of random clauses whose meta data contain a configuration entry
+// of the given length, so that the meta data may exceed the first chunk.
+std::shared_ptr<std::vector<uint8_t>> createRandomRevision(int jobId, int numLits, int configLength = 0) {
+    JobDescription desc(jobId, /*priority=*/1, JobDescription::Application::ONESHOT_SAT);
+    AppConfiguration config;
+    if (configLength > 0) config.map["padding"] = std::string(configLength, 'x');
+    desc.setAppConfiguration(std::move(config));
+    desc.beginInitialization(0);
+    std::mt19937 rng(jobId);
+    for (int i = 1; i < numLits; i++) desc.addLiteral(i % 5 == 0 ? 0 : (int) (rng() % 1000) + 1);
+    desc.addLiteral(0);
+    desc.endInitialization();
+    return desc.getSerialization(0);
+}
+
+// Chunks arrive shuffled and partially duplicated at a first receiver
+// which forwards each novel chunk to a second receiver joining halfway through.
+void testPipelinedForwarding() {
+
+    LOG(V2_INFO, "Forwarding shuffled chunks ...\n");
+
+    const int jobId = 3;
+    auto data = createRandomRevision(jobId, 100000);
+    const size_t chunkSize = 12345;
+    int numChunks = ChunkedDescription::getNumChunks(data->size(), chunkSize);
+    assert(numChunks > 10);
+
+    std::vector<std::shared_ptr<std::vector<uint8_t>>> chunks;
+    for (int i = 0; i < numChunks; i++)
+        chunks.push_back(ChunkedDescription::createChunk(jobId, 0, *data, chunkSize, i));
+    for (int i = 0; i < numChunks; i += 3) chunks.push_back(chunks[i]);
+    std::mt19937 rng(1);
+    std::shuffle(chunks.begin(), chunks.end(), rng);
+
+    std::unique_ptr<ChunkedDescription> first, second;
+    for (size_t i = 0; i < chunks.size(); i++) {
+        const auto& msg = *chunks[i];
+        assert(ChunkedDescription::isChunk(msg));
+        if (!first) first.reset(new ChunkedDescription(ChunkedDescription::readHeader(msg)));
+        bool novel = first->insert(msg);
+
+        if (i == chunks.size()/2) {
+            // Second receiver starts to wait: catch up with all chunks present so far
+            second.reset(new ChunkedDescription(ChunkedDescription::readHeader(msg)));
+            for (const auto& chunk : first->getReceivedChunks()) {
+                [[maybe_unused]] bool inserted = second->insert(*chunk);
+                assert(inserted);
+            }
+            first->addForwardDestination(1);
+        } else if (novel && second) {
+            // Forward novel chunks right away
+            [[maybe_unused]] bool inserted = second->insert(msg);
+            assert(inserted);
+        }
+    }
+
+    assert(first->isComplete());
+    assert(second->isComplete());
+    assert(first->getForwardDestinations().size() == 1);
+    assert(*first->extract() == *data);
+    auto assembled = second->extract();
+    assert(*assembled == *data);
+
+    JobDescription desc;
+    desc.deserialize(assembled);
+    assert(desc.getId() == jobId);
+    assert(desc.getRevision() == 0);
+}
+
+void testInvalidChunks() {
+
+    LOG(V2_INFO, "Rejecting foreign and malformed chunks ...\n");
+
+    auto data = createRandomRevision(1, 1000);
+    auto chunk = ChunkedDescription::createChunk(1, 0, *data, 1000, 0);
+    ChunkedDescription transfer(ChunkedDescription::readHeader(*chunk));
+
+    // Other revision of the same job
+    auto other = ChunkedDescription::createChunk(1, 1, *data, 1000, 1);
+    assert(!transfer.insert(*other));
+    // Truncated chunk
+    auto truncated = *chunk;
+    truncated.pop_back();
+    assert(!ChunkedDescription::isChunk(truncated));
+    assert(!transfer.insert(truncated));
+    // Too short for a header
+    assert(!ChunkedDescription::isChunk(std::vector<uint8_t>(4)));
+
+    assert(transfer.insert(*chunk));
+    assert(!transfer.insert(*chunk));
+    assert(transfer.getNumReceivedChunks() == 1);
+    assert(!transfer.isComplete());
+}
+
+// A receiver can read the meta data of a revision from its first chunk
+// and access the payload in the same memory once the remaining chunks arrived.
+void testMetadataInFirstChunk() {
+
+    LOG(V2_INFO, "Reading meta data from the first chunk ...\n");
+
+    const int jobId = 5;
+    const size_t chunkSize = 1000;
+    auto data = createRandomRevision(jobId, 10000, /*configLength=*/100);
+    int numChunks = ChunkedDescription::getNumChunks(data->size(), chunkSize);
+
+    auto firstChunk = ChunkedDescription::createChunk(jobId, 0, *data, chunkSize, 0);
+    ChunkedDescription transfer(ChunkedDescription::readHeader(*firstChunk));
+    assert(!transfer.hasChunk(0));
+    assert(!JobDescription::isMetadataContained(*transfer.getData(), 0));
+    for (int i = 1; i < numChunks; i += 2) {
+        [[maybe_unused]] bool inserted = transfer.insert(*ChunkedDescription::createChunk(jobId, 0, *data, chunkSize, i));
+        assert(inserted);
+    }
+    [[maybe_unused]] bool insertedFirst = transfer.insert(*firstChunk);
+    assert(insertedFirst && transfer.hasChunk(0) && !transfer.isComplete());
+    assert(JobDescription::isMetadataContained(*transfer.getData(), transfer.getChunkSize()));
+
+    JobDescription desc;
+    desc.deserialize(transfer.getData());
+    assert(desc.getId() == jobId);
+    assert(desc.getRevision() == 0);
+    assert(desc.getAppConfiguration().map.at("padding") == std::string(100, 'x'));
+    assert(desc.getFormulaPayloadSize(0) == 10000);
+    assert(desc.getTransferSize(0) == data->size());
+
+    for (int i = 2; i < numChunks; i += 2) {
+        [[maybe_unused]] bool inserted = transfer.insert(*ChunkedDescription::createChunk(jobId, 0, *data, chunkSize, i));
+        assert(inserted);
+    }
+    assert(transfer.isComplete());
+    assert(memcmp(desc.getFormulaPayload(0), data->data() + desc.getMetadataSize(), 
+        sizeof(int) * desc.getFormulaPayloadSize(0)) == 0);
+
+    // Meta data exceeding the first chunk
+    data = createRandomRevision(jobId, 10000, /*configLength=*/2*chunkSize);
+    assert(!JobDescription::isMetadataContained(*data, chunkSize));
+    assert(JobDescription::isMetadataContained(*data, data->size()));
+}
+
+int main() {
+    Timer::init();
+    Random::init(rand(), rand());
+    Logger::init(0, V5_DEBG);
+
+    testPipelinedForwarding();
+    testInvalidChunks();
+    testMetadataInFirstChunk();
+}
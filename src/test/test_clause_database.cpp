@@ -261,17 +261,330 @@ void testReduce() {
     //LOG(V2_INFO, "BUF: %s\n", out.c_str());
 }
 
+void testBenchmarkAddAndExport() {
+
+    LOG(V2_INFO, "Benchmark: concurrent clause addition and periodic export ...\n");
+
+    AdaptiveClauseDatabase::Setup setup;
+    setup.maxClauseLength = 60;
+    setup.maxLbdPartitionedSize = 5;
+    setup.numLiterals = 1500 * 20;
+    setup.slotsForSumOfLengthAndLbd = true;
+    const int numProducers = 4;
+    const int numClausesPerProducer = 1'000'000;
+    const int numEpochs = 50;
+
+    // Pre-generate a pool of realistic clauses (mostly short, few long ones)
+    std::vector<std::vector<int>> pool;
+    std::mt19937 rng(42);
+    std::geometric_distribution<int> lengthDist(0.12);
+    std::uniform_int_distribution<int> varDist(1, 1'000'000);
+    for (int i = 0; i < 100'000; i++) {
+        int len = std::min(setup.maxClauseLength, 1 + lengthDist(rng));
+        int lbd = len == 1 ? 1 : std::min(len, 2 + lengthDist(rng) / 2);
+        std::vector<int> lits(1, lbd);
+        for (int l = 0; l < len; l++) lits.push_back((rng() % 2 ? -1 : 1) * varDist(rng));
+        std::sort(lits.begin()+1, lits.end());
+        pool.push_back(std::move(lits));
+    }
+
+    AdaptiveClauseDatabase cdb(setup);
+    std::atomic_int numFinished {0};
+    std::atomic_long numAdded {0};
+    float time = Timer::elapsedSeconds();
+
+    std::vector<std::thread> threads(numProducers);
+    for (size_t i = 0; i < numProducers; i++) {
+        threads[i] = std::thread([&, i]() {
+            long added = 0;
+            for (int n = 0; n < numClausesPerProducer; n++) {
+                auto& cls = pool[(i * 7919 + n * 31) % pool.size()];
+                if (cdb.addClause(cls.data()+1, cls.size()-1, cls[0])) added++;
+            }
+            numAdded += added;
+            numFinished++;
+        });
+    }
+
+    long numExported = 0;
+    long exportedLits = 0;
+    int epoch = 0;
+    float exportTime = 0;
+    while (numFinished < numProducers || epoch < numEpochs) {
+        usleep(1000);
+        float t = Timer::elapsedSeconds();
+        int nbExp;
+        auto buf = cdb.exportBuffer(1500 * 10, nbExp);
+        exportTime += Timer::elapsedSeconds() - t;
+        numExported += nbExp;
+        exportedLits += buf.size();
+        epoch++;
+    }
+    for (auto& thread : threads) thread.join();
+    time = Timer::elapsedSeconds() - time;
+    cdb.checkTotalLiterals();
+
+    LOG(V2_INFO, "BENCHMARK %i producers: %i clauses offered, %ld admitted, %ld exported in %i epochs\n",
+        numProducers, numProducers*numClausesPerProducer, (long)numAdded, numExported, epoch);
+    LOG(V2_INFO, "BENCHMARK total %.4fs (%.3f Mcls/s offered), export %.6fs/epoch\n",
+        time, numProducers*numClausesPerProducer / time / 1e6, exportTime / epoch);
+}
+
+void testCompressedBuffers() {
+
+    LOG(V2_INFO, "Testing compressed clause buffers ...\n");
+
+    for (bool slotsForSum : {false, true}) {
+        AdaptiveClauseDatabase::Setup setup;
+        setup.maxClauseLength = 30;
+        setup.maxLbdPartitionedSize = 5;
+        setup.numLiterals = 100'000;
+        setup.slotsForSumOfLengthAndLbd = slotsForSum;
+
+        std::mt19937 rng(slotsForSum ? 1 : 2);
+        std::geometric_distribution<int> lengthDist(0.15);
+        std::uniform_int_distribution<int> varDist(1, 100'000);
+        std::vector<std::vector<int>> buffers;
+        for (int i = 0; i < 8; i++) {
+            AdaptiveClauseDatabase cdb(setup);
+            for (int j = 0; j < 20'000; j++) {
+                int len = std::min(setup.maxClauseLength, 1 + lengthDist(rng));
+                int lbd = len == 1 ? 1 : std::min(len, 2 + lengthDist(rng) / 2);
+                std::vector<int> lits;
+                for (int l = 0; l < len; l++) lits.push_back((rng() % 2 ? -1 : 1) * varDist(rng));
+                std::sort(lits.begin(), lits.end());
+                Clause c{lits.data(), len, lbd};
+                cdb.addClause(c);
+            }
+            int numExported;
+            buffers.push_back(cdb.exportBuffer(setup.numLiterals, numExported));
+        }
+
+        AdaptiveClauseDatabase cdb(setup);
+
+        // Round trip
+        std::vector<std::vector<int>> compressedBuffers;
+        size_t flatSize = 0, compressedSize = 0;
+        float encodeTime = 0, decodeTime = 0;
+        for (auto& buf : buffers) {
+            float time = Timer::elapsedSeconds();
+            auto compressed = cdb.compressBuffer(buf.data(), buf.size());
+            encodeTime += Timer::elapsedSeconds() - time;
+            time = Timer::elapsedSeconds();
+            auto decompressed = cdb.decompressBuffer(compressed.data(), compressed.size());
+            decodeTime += Timer::elapsedSeconds() - time;
+            assert(decompressed == buf);
+            flatSize += buf.size();
+            compressedSize += compressed.size();
+            compressedBuffers.push_back(std::move(compressed));
+        }
+        assert(cdb.compressBuffer(nullptr, 0).empty());
+        LOG(V2_INFO, "sum=%i : %lu ints -> %lu ints (%.3f), encode %.6fs, decode %.6fs\n", slotsForSum,
+            flatSize, compressedSize, (float)compressedSize/flatSize, encodeTime, decodeTime);
+        assert(compressedSize < flatSize);
+
+        // Reading a compressed buffer yields the same clauses as reading the flat buffer
+        for (size_t i = 0; i < buffers.size(); i++) {
+            auto flatReader = cdb.getBufferReader(buffers[i].data(), buffers[i].size());
+            auto compReader = cdb.getBufferReader(compressedBuffers[i].data(), compressedBuffers[i].size(), false, true);
+            while (true) {
+                Clause flat = flatReader.getNextIncomingClause();
+                [[maybe_unused]] Clause comp = compReader.getNextIncomingClause();
+                assert((flat.begin == nullptr) == (comp.begin == nullptr));
+                if (flat.begin == nullptr) break;
+                assert(flat.size == comp.size && flat.lbd == comp.lbd);
+                for (int l = 0; l < flat.size; l++) assert(flat.begin[l] == comp.begin[l]);
+            }
+        }
+
+        // Merging compressed buffers yields the same result as merging flat buffers
+        std::vector<int> mergedFlat, mergedComp, excessFlat, excessComp;
+        {
+            auto merger = cdb.getBufferMerger(100'000);
+            for (auto& buf : buffers) merger.add(cdb.getBufferReader(buf.data(), buf.size()));
+            mergedFlat = merger.merge(&excessFlat);
+        }
+        {
+            auto merger = cdb.getBufferMerger(100'000);
+            for (auto& buf : compressedBuffers) merger.add(cdb.getBufferReader(buf.data(), buf.size(), false, true));
+            // An empty (neutral) contribution
+            std::vector<int> empty;
+            merger.add(cdb.getBufferReader(empty.data(), empty.size(), false, true));
+            mergedComp = merger.merge(&excessComp);
+        }
+        assert(mergedFlat == mergedComp);
+        assert(excessFlat == excessComp);
+    }
+}
+
+void testSegmentedMerge() {
+
+    LOG(V2_INFO, "Testing segment-wise merging of clause buffers ...\n");
+
+    for (bool slotsForSum : {false, true}) {
+        AdaptiveClauseDatabase::Setup setup;
+        setup.maxClauseLength = 30;
+        setup.maxLbdPartitionedSize = 5;
+        setup.numLiterals = 100'000;
+        setup.slotsForSumOfLengthAndLbd = slotsForSum;
+
+        std::mt19937 rng(slotsForSum ? 3 : 4);
+        std::geometric_distribution<int> lengthDist(0.15);
+        std::uniform_int_distribution<int> varDist(1, 10'000);
+        std::vector<std::vector<int>> buffers;
+        for (int i = 0; i < 8; i++) {
+            AdaptiveClauseDatabase cdb(setup);
+            for (int j = 0; j < 10'000; j++) {
+                int len = std::min(setup.maxClauseLength, 1 + lengthDist(rng));
+                int lbd = len == 1 ? 1 : std::min(len, 2 + lengthDist(rng) / 2);
+                std::vector<int> lits;
+                for (int l = 0; l < len; l++) lits.push_back((rng() % 2 ? -1 : 1) * varDist(rng));
+                std::sort(lits.begin(), lits.end());
+                Clause c{lits.data(), len, lbd};
+                cdb.addClause(c);
+            }
+            int numExported;
+            buffers.push_back(cdb.exportBuffer(setup.numLiterals, numExported));
+        }
+
+        AdaptiveClauseDatabase cdb(setup);
+        for (int numSegments : {1, 3, 8}) {
+
+            // Splitting and re-joining a buffer is lossless
+            // (up to duplicate clauses, which are removed by any merge)
+            for (auto& buf : buffers) {
+                auto segments = cdb.splitBuffer(buf.data(), buf.size(), numSegments);
+                assert(segments.size() == (size_t) numSegments);
+                auto merger = cdb.getBufferMerger(-1);
+                for (auto& seg : segments) merger.add(cdb.getBufferReader(seg.data(), seg.size()));
+                auto reference = cdb.getBufferMerger(-1);
+                reference.add(cdb.getBufferReader(buf.data(), buf.size()));
+                assert(merger.merge() == reference.merge());
+            }
+
+            for (int sizeLimit : {50'000, 200'000, 1'000'000}) {
+                // Reference: merge all buffers at once
+                auto merger = cdb.getBufferMerger(sizeLimit);
+                for (auto& buf : buffers) merger.add(cdb.getBufferReader(buf.data(), buf.size()));
+                std::vector<int> excess;
+                auto merged = merger.merge(&excess);
+
+                // Merge segment by segment, sharing the size limit
+                std::vector<std::vector<std::vector<int>>> segmentsOfBuffers;
+                for (auto& buf : buffers) 
+                    segmentsOfBuffers.push_back(cdb.splitBuffer(buf.data(), buf.size(), numSegments));
+                std::vector<std::vector<int>> mergedSegments, excessSegments;
+                int budget = sizeLimit;
+                int excessBudget = sizeLimit;
+                for (int s = 0; s < numSegments; s++) {
+                    auto segmentMerger = cdb.getBufferMerger(budget);
+                    segmentMerger.setExcessSizeLimit(excessBudget);
+                    for (auto& segments : segmentsOfBuffers) 
+                        segmentMerger.add(cdb.getBufferReader(segments[s].data(), segments[s].size()));
+                    std::vector<int> segmentExcess;
+                    mergedSegments.push_back(segmentMerger.merge(&segmentExcess));
+                    excessSegments.push_back(std::move(segmentExcess));
+                    budget = segmentMerger.getNumExcessLiterals() > 0 ? 0 
+                        : budget - segmentMerger.getNumMergedLiterals();
+                    excessBudget -= segmentMerger.getNumExcessLiterals();
+                }
+
+                // Joining the merged segments yields the reference result
+                [[maybe_unused]] auto joinSegments = [&](std::vector<std::vector<int>>& segments) {
+                    auto joiner = cdb.getBufferMerger(-1);
+                    for (auto& seg : segments) joiner.add(cdb.getBufferReader(seg.data(), seg.size()));
+                    return joiner.merge();
+                };
+                assert(joinSegments(mergedSegments) == merged);
+                assert(joinSegments(excessSegments) == excess);
+            }
+        }
+    }
+}
+
+void testBenchmarkMerge() {
+
+    LOG(V2_INFO, "Benchmark: k-way merge of clause buffers ...\n");
+
+    AdaptiveClauseDatabase::Setup setup;
+    setup.maxClauseLength = 60;
+    setup.maxLbdPartitionedSize = 5;
+    setup.numLiterals = 100'000;
+    setup.slotsForSumOfLengthAndLbd = true;
+    const int maxNumBuffers = 64;
+    const int numRepetitions = 5;
+
+    // Draw the clauses of each buffer from a common pool to obtain duplicates
+    std::vector<std::vector<int>> pool;
+    std::mt19937 rng(42);
+    std::geometric_distribution<int> lengthDist(0.12);
+    std::uniform_int_distribution<int> varDist(1, 1'000'000);
+    for (int i = 0; i < 200'000; i++) {
+        int len = std::min(setup.maxClauseLength, 1 + lengthDist(rng));
+        int lbd = len == 1 ? 1 : std::min(len, 2 + lengthDist(rng) / 2);
+        std::vector<int> lits;
+        for (int l = 0; l < len; l++) lits.push_back((rng() % 2 ? -1 : 1) * varDist(rng));
+        std::sort(lits.begin(), lits.end());
+        lits.push_back(lbd);
+        pool.push_back(std::move(lits));
+    }
+    std::vector<std::vector<int>> buffers;
+    for (int i = 0; i < maxNumBuffers; i++) {
+        AdaptiveClauseDatabase cdb(setup);
+        for (int j = 0; j < 20'000; j++) {
+            auto& lits = pool[rng() % pool.size()];
+            Clause c{lits.data(), (int)lits.size()-1, lits.back()};
+            cdb.addClause(c);
+        }
+        int numExported;
+        buffers.push_back(cdb.exportBuffer(setup.numLiterals, numExported));
+    }
+
+    AdaptiveClauseDatabase cdb(setup);
+    for (int numBuffers = 2; numBuffers <= maxNumBuffers; numBuffers *= 2) {
+        const int sizeLimit = 30'000 * numBuffers;
+        std::vector<int> reference, referenceExcess;
+        for (int numSubmerges : {1, 4}) {
+            float time = 0;
+            for (int rep = 0; rep < numRepetitions; rep++) {
+                auto merger = cdb.getBufferMerger(sizeLimit);
+                merger.setNumParallelSubmerges(numSubmerges);
+                for (int i = 0; i < numBuffers; i++)
+                    merger.add(cdb.getBufferReader(buffers[i].data(), buffers[i].size()));
+                std::vector<int> excess;
+                float t = Timer::elapsedSeconds();
+                auto merged = merger.merge(&excess);
+                time += Timer::elapsedSeconds() - t;
+                // Parallel sub-merges must yield exactly the sequential result
+                if (reference.empty()) {
+                    reference = std::move(merged);
+                    referenceExcess = std::move(excess);
+                } else {
+                    assert(merged == reference);
+                    assert(excess == referenceExcess);
+                }
+            }
+            LOG(V2_INFO, "BENCHMARK merge %i buffers, %i sub-merges: %.6fs/merge, out size %lu, excess size %lu\n",
+                numBuffers, numSubmerges, time / numRepetitions, reference.size(), referenceExcess.size());
+        }
+    }
+}
+
 int main() {
     Timer::init();
     Random::init(rand(), rand());
     Logger::init(0, V5_DEBG);
     Process::init(0);
-    ProcessWideThreadPool::init(1);
+    ProcessWideThreadPool::init(4);
 
     testSumBucketLabel();
     testMinimal();
     testMerge();
     testReduce();
+    testCompressedBuffers();
+    testSegmentedMerge();
+    testBenchmarkAddAndExport();
+    testBenchmarkMerge();
 }
 
 
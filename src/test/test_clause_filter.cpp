@@ -1,5 +1,7 @@
 
 #include <bitset>
+#include <thread>
+#include <random>
 
 #include "util/sys/timer.hpp"
 #include "util/logger.hpp"
@@ -8,6 +10,8 @@
 #include "util/sys/process.hpp"
 
 #include "app/sat/sharing/filter/clause_filter.hpp"
+#include "app/sat/sharing/buffer/adaptive_clause_database.hpp"
+#include "app/sat/sharing/filter/produced_clause_filter.hpp"
 #include "util/atomic_bitset/atomic_wide_bitset.hpp"
 #include "util/atomic_bitset/atomic_bitset.hpp"
 
@@ -23,7 +27,7 @@ void test() {
         LOG(V2_INFO, "AtomicWideBitset initialization took %.5fs, RSS %.3f\n", time, info.residentSetSize);
         
         time = Timer::elapsedSeconds();
-        for (size_t i = 0; i < numSets; i++) {
+        for (int i = 0; i < numSets; i++) {
             filters.back()->set((int) (Random::rand()*NUM_BITS));
         }
         time = Timer::elapsedSeconds() - time;
@@ -44,7 +48,7 @@ void test() {
         auto info = Proc::getRuntimeInfo(Proc::getPid(), Proc::FLAT);
         LOG(V2_INFO, "atomicbitvector::atomic_bv_t initialization took %.5fs, RSS %.3f\n", time, info.residentSetSize);
         time = Timer::elapsedSeconds();
-        for (size_t i = 0; i < numSets; i++) {
+        for (int i = 0; i < numSets; i++) {
             filters.back()->set((int) (Random::rand()*NUM_BITS));
         }
         time = Timer::elapsedSeconds() - time;
@@ -65,7 +69,7 @@ void test() {
         auto info = Proc::getRuntimeInfo(Proc::getPid(), Proc::FLAT);
         LOG(V2_INFO, "std::bitset initialization took %.5fs, RSS %.3f\n", time, info.residentSetSize);
         time = Timer::elapsedSeconds();
-        for (size_t i = 0; i < numSets; i++) {
+        for (int i = 0; i < numSets; i++) {
             filters.back()->set((int) (Random::rand()*NUM_BITS));
         }
         time = Timer::elapsedSeconds() - time;
@@ -80,6 +84,84 @@ void test() {
     }
 }
 
+void testProducedClauseFilterSemantics() {
+    LOG(V2_INFO, "Testing produced clause filter semantics ...\n");
+
+    AdaptiveClauseDatabase::Setup setup;
+    setup.maxClauseLength = 10;
+    setup.numLiterals = 100'000;
+    AdaptiveClauseDatabase cdb(setup);
+    ProducedClauseFilter filter(/*epochHorizon=*/2, /*reshareImprovedLbd=*/false);
+
+    std::vector<int> lits = {3, -7, 12, 20};
+    std::vector<int> permutedLits = {20, 12, 3, -7};
+    [[maybe_unused]] auto result = filter.tryRegisterAndInsert(ProducedClauseCandidate(lits.data(), 4, 3, 0, 0), cdb);
+    assert(result == ProducedClauseFilter::ADMITTED);
+    // Same clause from another producer without improved LBD: filtered
+    result = filter.tryRegisterAndInsert(ProducedClauseCandidate(permutedLits.data(), 4, 3, 1, 0), cdb);
+    assert(result == ProducedClauseFilter::FILTERED);
+    // Improved LBD: admitted again
+    result = filter.tryRegisterAndInsert(ProducedClauseCandidate(lits.data(), 4, 2, 2, 0), cdb);
+    assert(result == ProducedClauseFilter::ADMITTED);
+
+    Mallob::Clause c(lits.data(), 4, 2);
+    assert(filter.getProducers(c, 0) == 0b111);
+    [[maybe_unused]] bool admitted = filter.admitSharing(c, 1);
+    assert(admitted);
+    admitted = filter.admitSharing(c, 2);
+    assert(!admitted);
+
+    // Clause is forgotten after the horizon has passed for all shards
+    for (int epoch = 2; epoch <= 5 + ProducedClauseFilter::NUM_SHARDS; epoch++) 
+        filter.clearExpiredEntries(epoch);
+    assert(filter.size() == 0);
+    assert(filter.getProducers(c, 10) == 0);
+}
+
+void benchmarkConcurrentProducedClauseFilter() {
+    LOG(V2_INFO, "Benchmark: concurrent insertions into produced clause filter ...\n");
+
+    // Realistic-ish stream of produced clauses with some duplicates
+    std::vector<std::vector<int>> clauses;
+    std::mt19937 rng(1);
+    std::geometric_distribution<int> lengthDist(0.15);
+    for (int i = 0; i < 400'000; i++) {
+        int len = std::min(30, 1 + lengthDist(rng));
+        std::vector<int> cls;
+        for (int l = 0; l < len; l++) cls.push_back((rng() % 2 ? -1 : 1) * (1 + (int) (rng() % 100'000)));
+        clauses.push_back(std::move(cls));
+    }
+
+    for (bool globalLock : {true, false}) {
+        for (int nbThreads : {1, 2, 4, 8, 16}) {
+            AdaptiveClauseDatabase::Setup setup;
+            setup.maxClauseLength = 30;
+            setup.numLiterals = 1'000'000;
+            AdaptiveClauseDatabase cdb(setup);
+            ProducedClauseFilter filter(20, false);
+            Mutex globalMutex; // emulates the former single filter lock
+
+            float time = Timer::elapsedSeconds();
+            std::vector<std::thread> threads;
+            for (int t = 0; t < nbThreads; t++) {
+                threads.emplace_back([&, t]() {
+                    for (size_t i = t; i < clauses.size(); i += nbThreads) {
+                        auto& cls = clauses[i];
+                        int lbd = cls.size() <= 2 ? cls.size() : 2;
+                        if (globalLock) globalMutex.lock();
+                        filter.tryRegisterAndInsert(ProducedClauseCandidate(
+                            cls.data(), cls.size(), lbd, t % 6, 0), cdb);
+                        if (globalLock) globalMutex.unlock();
+                    }
+                });
+            }
+            for (auto& thread : threads) thread.join();
+            time = Timer::elapsedSeconds() - time;
+            LOG(V2_INFO, "BENCHMARK %s %2i threads: %.3f Mcls/s\n", globalLock ? "single-lock" : "sharded    ", 
+                nbThreads, clauses.size() / time / 1e6);
+        }
+    }
+}
 
 int main() {
     Timer::init();
@@ -88,4 +170,6 @@ int main() {
     Process::init(0);
 
     test();
+    testProducedClauseFilterSemantics();
+    benchmarkConcurrentProducedClauseFilter();
 }
@@ -0,0 +1,159 @@
+
+#include <memory>
+#include <unistd.h>
+#include <vector>
+
+#include "app/sat/job/base_sat_job.hpp"
+#include "app/sat/job/anytime_sat_clause_communicator.hpp"
+#include "app/sat/sharing/buffer/adaptive_clause_database.hpp"
+#include "comm/mympi.hpp"
+#include "comm/msgtags.h"
+#include "util/params.hpp"
+#include "util/sys/thread_pool.hpp"
+#include "util/sys/process.hpp"
+#include "util/random.hpp"
+#include "util/sys/timer.hpp"
+#include "util/logger.hpp"
+#include "util/assert.hpp"
+
+// SAT job without solvers: each prepared clause buffer consists of a single unit clause
+// which identifies the buffer, and filtering a buffer takes several sharing periods
+// such that multiple sharing epochs are in flight at the same time.
+class EpochTrackingSatJob : public BaseSatJob {
+
+private:
+    const Parameters& _params;
+    std::unique_ptr<AnytimeSatClauseCommunicator> _clause_comm;
+    AdaptiveClauseDatabase _cdb;
+    JobResult _result;
+
+    int _num_prepared = 0;
+    bool _has_prepared = false;
+    float _filter_duration;
+    float _time_of_filter_done = -1;
+    int _filtered_buffer = 0;
+
+public:
+    int numApplied = 0;
+    int maxEpochsInFlight = 0;
+
+    EpochTrackingSatJob(const Parameters& params, float filterDuration) :
+        BaseSatJob(params, 1, 0, 1, JobDescription::Application::ONESHOT_SAT), _params(params),
+        _cdb([&]() {
+            AdaptiveClauseDatabase::Setup setup;
+            setup.maxClauseLength = params.strictClauseLengthLimit();
+            setup.maxLbdPartitionedSize = params.maxLbdPartitioningSize();
+            setup.slotsForSumOfLengthAndLbd = params.groupClausesByLengthLbdSum();
+            setup.numLiterals = 1000;
+            return setup;
+        }()), _filter_duration(filterDuration) {}
+
+    bool isInitialized() override {return true;}
+
+    void prepareSharing(int maxSize) override {_has_prepared = true;}
+    bool hasPreparedSharing() override {return _has_prepared;}
+    std::vector<int> getPreparedClauses(Checksum& checksum) override {
+        _has_prepared = false;
+        int lit = ++_num_prepared;
+        maxEpochsInFlight = std::max(maxEpochsInFlight, _num_prepared - numApplied);
+        _cdb.addClause(&lit, 1, 1);
+        int numExported;
+        return _cdb.exportBuffer(-1, numExported);
+    }
+    std::pair<int, int> getLastAdmittedClauseShare() override {return {0, 0};}
+
+    void filterSharing(std::vector<int>& clauses) override {
+        // Buffers must be imported one after the other, without gaps
+        assert(_time_of_filter_done < 0 || log_return_false("Filtering while buffer %i is not imported yet\n", _filtered_buffer));
+        int buffer = getUnit(clauses);
+        assert(buffer == numApplied+1 || log_return_false("Buffer %i filtered after buffer %i\n", buffer, numApplied));
+        _filtered_buffer = buffer;
+        _time_of_filter_done = Timer::elapsedSeconds() + _filter_duration;
+    }
+    bool hasFilteredSharing() override {
+        return _time_of_filter_done >= 0 && Timer::elapsedSeconds() >= _time_of_filter_done;
+    }
+    std::vector<int> getLocalFilter() override {return std::vector<int>(1, 0);}
+    void applyFilter(std::vector<int>& filter) override {
+        assert(_time_of_filter_done >= 0);
+        _time_of_filter_done = -1;
+        numApplied = _filtered_buffer;
+    }
+    void digestSharingWithoutFilter(std::vector<int>& clauses) override {}
+    void returnClauses(std::vector<int>& clauses) override {}
+
+    void appl_start() override {_clause_comm.reset(new AnytimeSatClauseCommunicator(_params, this));}
+    void appl_suspend() override {}
+    void appl_resume() override {}
+    void appl_terminate() override {}
+    int appl_solved() override {return -1;}
+    JobResult&& appl_getResult() override {return std::move(_result);}
+    void appl_communicate() override {_clause_comm->communicate();}
+    void appl_communicate(int source, int mpiTag, JobMessage& msg) override {
+        _clause_comm->handle(source, mpiTag, msg);
+    }
+    void appl_dumpStats() override {}
+    bool appl_isDestructible() override {return _clause_comm->isDestructible();}
+    void appl_memoryPanic() override {}
+
+private:
+    int getUnit(std::vector<int>& clauses) {
+        auto reader = _cdb.getBufferReader(clauses.data(), clauses.size());
+        auto clause = reader.getNextIncomingClause();
+        assert(clause.begin != nullptr && clause.size == 1);
+        return clause.begin[0];
+    }
+};
+
+void testEpochsInFlight(Parameters& params) {
+
+    LOG(V2_INFO, "Sharing with up to %i epochs in flight ...\n", params.numSharingEpochsInFlight());
+
+    EpochTrackingSatJob job(params, /*filterDuration=*/1.5f * params.appCommPeriod());
+    JobRequest req(1, JobDescription::Application::ONESHOT_SAT, 0, 0, 0, Timer::elapsedSeconds(), 0, 0);
+    job.commit(req);
+    job.start();
+
+    auto& q = MyMpi::getMessageQueue();
+    auto forward = [&](MessageHandle& h) {
+        JobMessage msg = Serializable::get<JobMessage>(h.getRecvData());
+        job.communicate(h.source, h.tag, msg);
+    };
+    q.registerCallback(MSG_SEND_APPLICATION_MESSAGE, forward);
+    q.registerCallback(MSG_JOB_TREE_REDUCTION, forward);
+    q.registerCallback(MSG_JOB_TREE_BROADCAST, forward);
+
+    float startTime = Timer::elapsedSeconds();
+    while (Timer::elapsedSeconds() - startTime < 40 * params.appCommPeriod()) {
+        job.communicate();
+        q.advance();
+        usleep(1000);
+    }
+    LOG(V2_INFO, "%i buffers imported, max. %i epochs in flight\n", job.numApplied, job.maxEpochsInFlight);
+    assert(job.numApplied >= 10);
+    assert(job.maxEpochsInFlight > 1);
+
+    job.terminate();
+    while (!job.isDestructible()) q.advance();
+    q.clearCallbacks();
+}
+
+int main(int argc, char *argv[]) {
+
+    MyMpi::init(/*threadMultiple=*/false);
+    Timer::init();
+    Process::init(0);
+    Random::init(1, 1);
+    Logger::init(0, V5_DEBG);
+    ProcessWideThreadPool::init(2);
+
+    Parameters params;
+    params.init(argc, argv);
+    params.appCommPeriod.set(0.02f);
+    params.numSharingEpochsInFlight.set(3);
+    MyMpi::setOptions(params);
+
+    testEpochsInFlight(params);
+
+    MPI_Finalize();
+}
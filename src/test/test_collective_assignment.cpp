@@ -0,0 +1,179 @@
+
+#include <vector>
+#include <algorithm>
+
+#include "balancing/collective_assignment.hpp"
+#include "util/permutation.hpp"
+#include "util/random.hpp"
+#include "util/sys/timer.hpp"
+#include "util/logger.hpp"
+#include "util/assert.hpp"
+
+// Simulation of collective assignment on the aggregation tree of an expander graph:
+// Job requests enter the tree at busy PEs and travel (up, then down) until they
+// arrive at an idle PE. Statuses are aggregated once; in "burst" mode, they are not
+// refreshed in between requests (as for requests arriving within the same round),
+// otherwise each adoption is propagated up the tree before the next request arrives.
+// A named idle PE which is handed out is claimed right away in either mode since
+// the claim is sent along with the request.
+struct Simulation {
+
+    int n;
+    int root;
+    int maxNamedIdleRanks;
+    bool burst = false;
+    long numClaimMessages = 0;
+    std::vector<int> parent;
+    std::vector<int> depth;
+    std::vector<bool> idle;
+    std::vector<robin_hood::unordered_map<int, CollectiveAssignment::Status>> childStatuses;
+
+    Simulation(int n, int degree, float idleRatio, int maxNamedIdleRanks) : n(n), root(0),
+            maxNamedIdleRanks(maxNamedIdleRanks), parent(n, -1), depth(n, -1), idle(n, false), childStatuses(n) {
+
+        // Tree towards the root: BFS over reverse edges of the expander graph
+        auto permutations = AdjustablePermutation::getPermutations(n, degree);
+        std::vector<std::vector<int>> predecessors(n);
+        for (auto& perm : permutations) for (int x = 0; x < n; x++) predecessors[perm[x]].push_back(x);
+        std::vector<int> order {root};
+        depth[root] = 0;
+        for (size_t i = 0; i < order.size(); i++) {
+            int x = order[i];
+            for (int pred : predecessors[x]) {
+                if (depth[pred] >= 0) continue;
+                depth[pred] = depth[x]+1;
+                parent[pred] = x;
+                order.push_back(pred);
+            }
+        }
+        assert(order.size() == (size_t) n);
+
+        for (int x = 0; x < n; x++) idle[x] = Random::rand() < idleRatio;
+
+        // Aggregate statuses from the leaves upwards
+        for (int i = n-1; i > 0; i--) {
+            int x = order[i];
+            childStatuses[parent[x]][x] = CollectiveAssignment::aggregate(x, idle[x],
+                childStatuses[x], maxNamedIdleRanks);
+        }
+    }
+
+    int getMaxDepth() const {return *std::max_element(depth.begin(), depth.end());}
+    int getNumIdle() const {return std::count(idle.begin(), idle.end(), true);}
+
+    void refresh(int x) {
+        for (; x != root; x = parent[x]) {
+            childStatuses[parent[x]][x] = CollectiveAssignment::aggregate(x, idle[x],
+                childStatuses[x], maxNamedIdleRanks);
+        }
+    }
+
+    // The PEs below x which name the claimed PE are told via claim messages,
+    // the PEs above x (and the PEs told) via their next status.
+    void claim(int x, int namingChild, int claimedRank) {
+        int y = x;
+        int child = namingChild;
+        while (child >= 0 && child != claimedRank) {
+            numClaimMessages++;
+            y = child;
+            child = CollectiveAssignment::claim(claimedRank, childStatuses[y]);
+        }
+        refresh(y);
+    }
+
+    // Returns the number of messages until the request is adopted, or -1 if it is not.
+    int route(int origin) {
+        int current = origin;
+        for (int hops = 0; hops <= 4*n; hops++) {
+            int namingChild = -1;
+            int dest = CollectiveAssignment::getDestination(current, idle[current], childStatuses[current], 
+                &namingChild);
+            if (namingChild >= 0) claim(current, namingChild, dest);
+            if (dest == current) {
+                idle[current] = false;
+                if (!burst) refresh(current);
+                return hops;
+            }
+            if (dest < 0) {
+                if (current == root) return -1;
+                dest = parent[current];
+            }
+            current = dest;
+        }
+        return -1;
+    }
+};
+
+void testAggregation() {
+
+    LOG(V2_INFO, "Aggregating idle PEs ...\n");
+
+    robin_hood::unordered_map<int, CollectiveAssignment::Status> children;
+    children[1] = CollectiveAssignment::Status{3, {1, 4, 5}};
+    children[2] = CollectiveAssignment::Status{10, {2, 6}};
+    auto status = CollectiveAssignment::aggregate(0, true, children, 4);
+    assert(status.numIdle == 14);
+    assert(status.idleRanks.size() == 4);
+    assert(status.idleRanks[0] == 0);
+
+    // Named idle PEs are chosen before descending into some subtree
+    [[maybe_unused]] int dest = CollectiveAssignment::getDestination(0, false, children);
+    assert(dest == 1 || dest == 4 || dest == 5 || dest == 2 || dest == 6);
+    assert(children[1].numIdle + children[2].numIdle == 12);
+    for (int i = 0; i < 4; i++) CollectiveAssignment::getDestination(0, false, children);
+    assert(children[1].idleRanks.empty() && children[2].idleRanks.empty());
+    // Then only the count remains
+    assert(CollectiveAssignment::getDestination(0, false, children) == 2);
+    assert(CollectiveAssignment::getDestination(0, true, children) == 0);
+
+    // A named idle PE handed out elsewhere is removed from the status naming it
+    children[1] = CollectiveAssignment::Status{3, {1, 4, 5}};
+    children[2] = CollectiveAssignment::Status{10, {2, 6}};
+    [[maybe_unused]] int namingChild = CollectiveAssignment::claim(4, children);
+    assert(namingChild == 1);
+    assert(children[1].numIdle == 2 && children[1].idleRanks.size() == 2);
+    assert(std::count(children[1].idleRanks.begin(), children[1].idleRanks.end(), 4) == 0);
+    assert(CollectiveAssignment::claim(7, children) == -1);
+    assert(children[2].numIdle == 10);
+}
+
+void benchmark(int n, bool burst) {
+
+    const float idleRatio = 0.05;
+    double avgHops[2];
+    int maxNamedIdleRanks[2] = {0, 8};
+    for (int k = 0; k < 2; k++) {
+        Random::init(n, n);
+        Simulation sim(n, 4, idleRatio, maxNamedIdleRanks[k]);
+        sim.burst = burst;
+        int numRequests = sim.getNumIdle() / 2;
+        long sumHops = 0;
+        int numAdopted = 0;
+        for (int r = 0; r < numRequests; r++) {
+            int origin;
+            do origin = (int) (Random::rand() * n); while (sim.idle[origin]);
+            int hops = sim.route(origin);
+            if (hops < 0) continue;
+            sumHops += hops;
+            numAdopted++;
+        }
+        assert(numAdopted == numRequests);
+        avgHops[k] = sumHops / (double) numAdopted;
+        LOG(V2_INFO, "n=%i depth=%i burst=%i named=%i : %i requests, %.3f msgs per adoption, %.3f claims per adoption\n",
+            n, sim.getMaxDepth(), burst?1:0, maxNamedIdleRanks[k], numRequests, avgHops[k], 
+            sim.numClaimMessages / (double) numAdopted);
+    }
+    assert(avgHops[1] < avgHops[0]);
+}
+
+int main() {
+    Timer::init();
+    Random::init(1, 1);
+    Logger::init(0, V5_DEBG);
+
+    testAggregation();
+    for (int n : {1000, 3000, 10000}) {
+        benchmark(n, /*burst=*/false);
+        benchmark(n, /*burst=*/true);
+    }
+}
@@ -19,6 +19,78 @@
 #include "app/sat/job/distributed_clause_filter.hpp"
 
 
+void testApproximateVsExactFilter(std::vector<Clause>& clauses) {
+
+    LOG(V2_INFO, "Comparing approximate and exact distributed filters ...\n");
+
+    // Sharing epochs where each epoch draws fresh clauses as well as clauses
+    // from recent epochs (which should be filtered). A clause is only drawn again
+    // while both filters remember its first occurrence (the approximate filter
+    // may remember clauses for a few more epochs than the exact filter).
+    const int numEpochs = 25;
+    const int numRememberedEpochs = 10;
+    const int numClausesPerEpoch = 5'000;
+    std::mt19937 rng(1);
+    std::vector<int> freshClauses(clauses.size());
+    for (size_t i = 0; i < clauses.size(); i++) freshClauses[i] = i;
+    std::shuffle(freshClauses.begin(), freshClauses.end(), rng);
+    size_t nextFresh = 0;
+    std::vector<int> firstEpoch(clauses.size(), -1);
+    std::vector<std::vector<int>> epochs(numEpochs);
+    for (int e = 0; e < numEpochs; e++) {
+        for (int i = 0; i < numClausesPerEpoch; i++) {
+            bool old = e > 0 && rng() % 4 == 0;
+            int idx = -1;
+            if (old) {
+                int oldEpoch = e - 1 - rng() % std::min(e, numRememberedEpochs-2);
+                idx = epochs[oldEpoch][rng() % epochs[oldEpoch].size()];
+                if (e - firstEpoch[idx] > numRememberedEpochs-2) idx = -1;
+            }
+            if (idx == -1) {
+                if (nextFresh == freshClauses.size()) continue;
+                idx = freshClauses[nextFresh++];
+                firstEpoch[idx] = e;
+            }
+            epochs[e].push_back(idx);
+        }
+    }
+
+    for (int volume : {1, 4}) {
+        for (size_t memoryKb : {16, 64, 256}) {
+            for (int rank = 0; rank < volume; rank++) {
+                DistributedClauseFilter exact(numRememberedEpochs);
+                DistributedClauseFilter approx(numRememberedEpochs, 1024 * memoryKb, 4, 4);
+                exact.update(rank, volume);
+                approx.update(rank, volume);
+                int numFilteredExact = 0, numFilteredApprox = 0;
+                int numFalsePositives = 0, numFalseNegatives = 0;
+                for (int e = 0; e < numEpochs; e++) {
+                    for (int idx : epochs[e]) {
+                        bool passedExact = exact.passClause(clauses[idx], e+1);
+                        bool passedApprox = approx.passClause(clauses[idx], e+1);
+                        if (!passedExact) numFilteredExact++;
+                        if (!passedApprox) numFilteredApprox++;
+                        if (passedExact && !passedApprox) numFalsePositives++;
+                        if (!passedExact && passedApprox) numFalseNegatives++;
+                    }
+                }
+                LOG(V2_INFO, "[v=%i,r=%i,%luKiB] exact: %i filtered, %lu bytes ; approx: %i filtered, %lu bytes, %i false pos., %i false neg. (est. fpr %.6f)\n",
+                    volume, rank, memoryKb, numFilteredExact, exact.getMemoryBytes(), numFilteredApprox, 
+                    approx.getMemoryBytes(), numFalsePositives, numFalseNegatives, 
+                    approx.getStatistics().numQueries == 0 ? 0.0 : (double) numFalsePositives / approx.getStatistics().numQueries);
+                assert(approx.getMemoryBytes() <= 1024 * memoryKb);
+                assert(exact.getStatistics().numFiltered == numFilteredExact);
+                assert(approx.getStatistics().numFiltered == numFilteredApprox);
+                // With a sufficient memory budget, nearly all decisions coincide
+                if (memoryKb >= 256) {
+                    assert(numFalsePositives < 0.001 * numEpochs * numClausesPerEpoch);
+                    assert(numFalseNegatives < 0.05 * numFilteredExact + 10);
+                }
+            }
+        }
+    }
+}
+
 int main() {
     
     int seed = 1;
@@ -71,6 +143,8 @@ int main() {
         LOG(V2_INFO, "[v=%i] Total filtered: %i\n\n", volume, allNumFiltered);
     }
 
+    testApproximateVsExactFilter(clauses);
+
 
     
     //for (auto& c : clauses) LOG(V2_INFO, "%s ~> %lu\n", c.toStr().c_str(), ClauseHasher::hash(c, /*which=*/3));
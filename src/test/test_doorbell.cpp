@@ -0,0 +1,90 @@
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <new>
+
+#include "util/sys/doorbell.hpp"
+#include "util/sys/timer.hpp"
+#include "util/logger.hpp"
+#include "util/assert.hpp"
+
+struct PingPong {
+    Doorbell toChild;
+    Doorbell toParent;
+    volatile int request;
+    volatile int response;
+};
+
+// Round trips between two processes which only communicate via a shared
+// memory segment: the parent issues a request and waits for the response
+// of the child. A (generous) timeout for each wait detects lost wake-ups.
+void testRoundTrips(int numRoundTrips) {
+
+    LOG(V2_INFO, "Doorbell round trips between processes ...\n");
+
+    void* mem = mmap(nullptr, sizeof(PingPong), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    assert(mem != MAP_FAILED);
+    PingPong* pp = new (mem) PingPong();
+    pp->request = 0;
+    pp->response = 0;
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        // [child] answer each request
+        uint32_t seq = pp->toChild.getSequenceNumber();
+        while (pp->response < numRoundTrips) {
+            if (pp->request > pp->response) {
+                pp->response = pp->request;
+                pp->toParent.ring();
+                continue;
+            }
+            pp->toChild.wait(seq, 1000*1000);
+            seq = pp->toChild.getSequenceNumber();
+        }
+        _exit(0);
+    }
+
+    // [parent]
+    int numLostWakeups = 0;
+    float time = Timer::elapsedSeconds();
+    for (int i = 1; i <= numRoundTrips; i++) {
+        uint32_t seq = pp->toParent.getSequenceNumber();
+        pp->request = i;
+        pp->toChild.ring();
+        while (pp->response < i) {
+            if (!pp->toParent.wait(seq, 1000*1000) && pp->response < i) numLostWakeups++;
+            seq = pp->toParent.getSequenceNumber();
+        }
+    }
+    time = Timer::elapsedSeconds() - time;
+
+    int status;
+    waitpid(pid, &status, 0);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    munmap(mem, sizeof(PingPong));
+
+    LOG(V2_INFO, "%i round trips: %.3f us per round trip, %i lost wake-ups\n",
+        numRoundTrips, 1000*1000*time/numRoundTrips, numLostWakeups);
+    assert(numLostWakeups == 0);
+}
+
+void testTimeout() {
+    Doorbell bell;
+    uint32_t seq = bell.getSequenceNumber();
+    float time = Timer::elapsedSeconds();
+    [[maybe_unused]] bool rung = bell.wait(seq, 10*1000);
+    time = Timer::elapsedSeconds() - time;
+    assert(!rung);
+    assert(time >= 0.009);
+    bell.ring();
+    assert(bell.wait(seq, 10*1000));
+}
+
+int main() {
+    Timer::init();
+    Logger::init(0, V5_DEBG);
+
+    testTimeout();
+    testRoundTrips(10'000);
+}
@@ -0,0 +1,73 @@
+
+#include <vector>
+
+#include "comm/hierarchical_reduction_plan.hpp"
+#include "util/sys/timer.hpp"
+#include "util/logger.hpp"
+#include "util/assert.hpp"
+
+// Job nodes 0..n-1 with (world) rank 100+index, placed on hosts round-robin
+HierarchicalReductionPlan createPlan(int numNodes, int numHosts) {
+    std::vector<int> members;
+    // insertion order must not matter
+    for (int index = numNodes-1; index >= 0; index--) {
+        HierarchicalReductionPlan::appendMember(members, index, 100+index, index % numHosts);
+    }
+    return HierarchicalReductionPlan(members);
+}
+
+void testStructure() {
+
+    LOG(V2_INFO, "Structure of hierarchical plans ...\n");
+
+    for (int numNodes : {1, 2, 7, 32, 100}) for (int numHosts : {1, 3, 8}) {
+        auto plan = createPlan(numNodes, numHosts);
+        assert(plan.size() == (size_t) numNodes);
+        assert(plan.getNumHosts() == std::min(numNodes, numHosts));
+        assert(plan.getParentRank(100) == -1);
+
+        int numEdges = 0;
+        for (int index = 0; index < numNodes; index++) {
+            int rank = 100+index;
+            int parent = plan.getParentRank(rank);
+            if (parent >= 0) {
+                // Parent has a lower index
+                assert(plan.getIndex(parent) < index);
+                numEdges++;
+                // Each non-representative is a direct child of its host's representative
+                bool isRep = index < numHosts;
+                if (!isRep) assert(plan.getIndex(parent) == index % numHosts);
+                else assert(plan.getIndex(parent) < numHosts);
+            }
+            for ([[maybe_unused]] int child : plan.getChildRanks(rank)) assert(plan.getParentRank(child) == rank);
+        }
+        assert(numEdges == numNodes-1);
+    }
+}
+
+void testDetachedMembers() {
+
+    LOG(V2_INFO, "Detached members below a departed subtree ...\n");
+
+    auto plan = createPlan(15, 2);
+    // Job subtree below index 2: 2, 5, 6, 11, 12, 13, 14
+    auto detached = plan.getMembersDetachedBelow(2);
+    std::vector<int> expected {2, 5, 6, 11, 12, 13, 14};
+    assert(detached.size() == expected.size());
+    for (size_t i = 0; i < detached.size(); i++) {
+        [[maybe_unused]] auto [rank, parent] = detached[i];
+        assert(rank == 100+expected[i]);
+        assert(plan.getParentRank(rank) == parent);
+        // hosts are represented by indices 0 and 1, which are outside the subtree
+        assert(parent == 100 + expected[i] % 2);
+    }
+    assert(plan.getMembersDetachedBelow(0).empty());
+}
+
+int main() {
+    Timer::init();
+    Logger::init(0, V5_DEBG);
+
+    testStructure();
+    testDetachedMembers();
+}
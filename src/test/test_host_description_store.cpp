@@ -0,0 +1,156 @@
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "comm/mpi_base.hpp"
+#include "data/job_description.hpp"
+#include "data/host_description_store.hpp"
+#include "util/sys/timer.hpp"
+#include "util/logger.hpp"
+#include "util/assert.hpp"
+
+bool equals(const JobDescription::SerializationView& view, const std::vector<uint8_t>& data) {
+    return view.size == data.size() && memcmp(view.data.get(), data.data(), data.size()) == 0;
+}
+
+std::shared_ptr<std::vector<uint8_t>> createRevision(int jobId, int numLits) {
+    JobDescription desc(jobId, /*priority=*/1, JobDescription::Application::ONESHOT_SAT, /*computeChecksums=*/true);
+    desc.beginInitialization(0);
+    for (int i = 1; i <= numLits; i++) desc.addLiteral(i % 7 == 0 ? 0 : i);
+    desc.addAssumption(-1);
+    desc.endInitialization();
+    return desc.getSerialization(0);
+}
+
+// A second process on the same host (forked before anything is published)
+// fetches and maps a revision published by this process. The revision must
+// remain in the store until both processes released it.
+void testSharingAcrossProcesses() {
+
+    LOG(V2_INFO, "Sharing a revision across processes ...\n");
+
+    const int jobId = 7;
+    auto data = createRevision(jobId, 100000);
+    JobDescription desc;
+    desc.deserialize(data);
+    size_t formulaOffset = (const uint8_t*) desc.getFormulaPayload(0) - data->data();
+    Checksum checksum = desc.getChecksum();
+
+    int toChild[2], toParent[2];
+    assert(pipe(toChild) == 0 && pipe(toParent) == 0);
+    char c;
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        // [child] wait until the parent published the revision
+        if (read(toChild[0], &c, 1) != 1) _exit(1);
+        Checksum wrongChecksum;
+        wrongChecksum.combine(1);
+        if (HostDescriptionStore::fetch(jobId, 0, &wrongChecksum)) _exit(2);
+        auto fetched = HostDescriptionStore::fetch(jobId, 0, &checksum);
+        if (!fetched || !equals(fetched, *data)) _exit(3);
+        // Map the payload read-only like a solver subprocess
+        auto ref = HostDescriptionStore::getReference(jobId, 0, formulaOffset, 0);
+        const uint8_t* mapped = HostDescriptionStore::mapReadOnly(ref);
+        if (mapped == nullptr) _exit(4);
+        const int* lits = (const int*) (mapped + ref.formulaOffset);
+        for (size_t i = 0; i < desc.getFormulaPayloadSize(0); i++)
+            if (lits[i] != desc.getFormulaPayload(0)[i]) _exit(5);
+        fetched = JobDescription::SerializationView();
+        HostDescriptionStore::release(jobId);
+        if (write(toParent[1], &c, 1) != 1) _exit(6);
+        _exit(0);
+    }
+
+    // [parent]
+    assert(!HostDescriptionStore::fetch(jobId, 0));
+    auto published = HostDescriptionStore::publish(jobId, 0, checksum, *data);
+    assert(published && equals(published, *data));
+    assert(HostDescriptionStore::holds(jobId, 0));
+    assert(write(toChild[1], &c, 1) == 1);
+    assert(read(toParent[0], &c, 1) == 1);
+    int status;
+    waitpid(pid, &status, 0);
+    assert((WIFEXITED(status) && WEXITSTATUS(status) == 0)
+        || LOG_RETURN_FALSE("child exited with status %i\n", WEXITSTATUS(status)));
+
+    // The child released its reference: the revision is still present
+    // and is shared rather than copied within this process
+    auto fetched = HostDescriptionStore::fetch(jobId, 0);
+    assert(fetched && fetched.data == published.data);
+    // Publishing again is a no-op
+    assert(HostDescriptionStore::publish(jobId, 0, checksum, *data).data == published.data);
+
+    // The last reference is released: the revision is gone
+    published = JobDescription::SerializationView();
+    fetched = JobDescription::SerializationView();
+    HostDescriptionStore::release(jobId);
+    assert(!HostDescriptionStore::holds(jobId, 0));
+    assert(!HostDescriptionStore::fetch(jobId, 0));
+}
+
+// A job description holds a revision as a view of the store, which keeps
+// the revision present until the description is gone.
+void testDescriptionHoldingView() {
+
+    LOG(V2_INFO, "Holding a revision as a view ...\n");
+
+    const int jobId = 11;
+    auto data = createRevision(jobId, 10000);
+    JobDescription original;
+    original.deserialize(data);
+
+    {
+        JobDescription desc;
+        desc.deserialize(HostDescriptionStore::publish(jobId, 0, original.getChecksum(), *data));
+        data.reset();
+        assert(desc.getId() == jobId);
+        assert(desc.getTransferSize(0) == original.getTransferSize(0));
+        assert(desc.getFormulaPayloadSize(0) == original.getFormulaPayloadSize(0));
+        assert(desc.getAssumptionsSize(0) == 1 && desc.getAssumptionsPayload(0)[0] == -1);
+        assert(memcmp(desc.getFormulaPayload(0), original.getFormulaPayload(0), 
+            sizeof(int) * desc.getFormulaPayloadSize(0)) == 0);
+        assert(*desc.getSerialization(0) == *original.getSerialization(0));
+
+        // Releasing the job keeps the revision present for the description
+        HostDescriptionStore::release(jobId);
+        assert(!HostDescriptionStore::holds(jobId, 0));
+        auto fetched = HostDescriptionStore::fetch(jobId, 0);
+        assert(fetched && fetched.data.get() != desc.getSerializationBegin(0));
+        HostDescriptionStore::release(jobId);
+    }
+
+    // The description is gone: so is the revision
+    assert(!HostDescriptionStore::fetch(jobId, 0));
+}
+
+void testReleaseAll() {
+
+    LOG(V2_INFO, "Releasing all revisions ...\n");
+
+    for (int jobId : {1, 2, 3}) {
+        auto data = createRevision(jobId, 1000);
+        HostDescriptionStore::publish(jobId, 0, Checksum(), *data);
+        assert(HostDescriptionStore::holds(jobId, 0));
+    }
+    HostDescriptionStore::releaseAll();
+    for ([[maybe_unused]] int jobId : {1, 2, 3}) {
+        assert(!HostDescriptionStore::holds(jobId, 0));
+        assert(!HostDescriptionStore::fetch(jobId, 0));
+    }
+}
+
+int main(int argc, char *argv[]) {
+    MPI_Init(&argc, &argv);
+    Timer::init();
+    Logger::init(0, V5_DEBG);
+
+    HostDescriptionStore::init();
+    assert(HostDescriptionStore::isEnabled());
+
+    testSharingAcrossProcesses();
+    testDescriptionHoldingView();
+    testReleaseAll();
+
+    MPI_Finalize();
+}
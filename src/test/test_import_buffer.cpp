@@ -1,5 +1,6 @@
 
 #include <algorithm>
+#include <set>
 
 #include "app/sat/sharing/import_buffer.hpp"
 
@@ -13,6 +14,7 @@
 #include "app/sat/sharing/buffer/buffer_reducer.hpp"
 #include "util/sys/terminator.hpp"
 #include "util/assert.hpp"
+#include "app/sat/sharing/import_epoch_buffer.hpp"
 
 Mallob::Clause generateClause(int minLength, int maxLength) {
     int length = minLength + (int) (Random::rand() * (maxLength-minLength));
@@ -32,6 +34,85 @@ Mallob::Clause generateClause(int minLength, int maxLength) {
     return c;
 }
 
+void testEpochImport() {
+
+    LOG(V2_INFO, "Epoch import test ...\n");
+
+    SolverSetup setup;
+    setup.strictClauseLengthLimit = 20;
+    setup.strictLbdLimit = 20;
+    setup.clauseBaseBufferSize = 1500;
+    setup.anticipatedLitsToImportPerCycle = 20000;
+    setup.solverRevision = 0;
+    setup.minNumChunksPerSolver = 100;
+    setup.numBufferedClsGenerations = 4;
+
+    // Export a sharing buffer
+    AdaptiveClauseDatabase::Setup cdbSetup;
+    cdbSetup.maxClauseLength = setup.strictClauseLengthLimit;
+    cdbSetup.maxLbdPartitionedSize = 2;
+    cdbSetup.numLiterals = 100'000;
+    cdbSetup.slotsForSumOfLengthAndLbd = false;
+    AdaptiveClauseDatabase cdb(cdbSetup);
+    for (int i = 0; i < 5'000; i++) {
+        auto c = generateClause(1, setup.strictClauseLengthLimit);
+        cdb.addClause(c);
+        free(c.begin);
+    }
+    int numExported;
+    auto buf = cdb.exportBuffer(50'000, numExported);
+    auto epoch = std::make_shared<const ImportEpochBuffer>(std::move(buf), cdb);
+    assert(epoch->getNumClauses() == numExported);
+    assert(epoch->getNumUnits() > 0);
+
+    // Several solvers share the epoch, each with a distinct filter
+    const int numSolvers = 4;
+    std::vector<SolverStatistics> stats(numSolvers);
+    std::vector<std::unique_ptr<ImportBuffer>> importBuffers;
+    for (int s = 0; s < numSolvers; s++) {
+        stats[s].histDigested = new ClauseHistogram(setup.strictClauseLengthLimit);
+        importBuffers.emplace_back(new ImportBuffer(setup, stats[s]));
+    }
+    [[maybe_unused]] const long budget = importBuffers[0]->getEpochLiteralBudget();
+    std::vector<std::multiset<std::vector<int>>> expected(numSolvers);
+    for (int s = 0; s < numSolvers; s++) {
+        std::vector<uint64_t> excluded((epoch->getNumClauses()+63)/64, 0);
+        size_t numAdmittedLits = 0;
+        for (size_t idx = 0; idx < epoch->getNumClauses(); idx++) {
+            auto c = epoch->getClause(idx);
+            if (idx % numSolvers == s) {
+                excluded[idx / 64] |= 1UL << (idx % 64);
+            } else {
+                expected[s].insert(std::vector<int>(c.begin, c.begin+c.size));
+                numAdmittedLits += c.size;
+            }
+        }
+        importBuffers[s]->addEpoch(epoch, std::move(excluded), numAdmittedLits);
+        assert(importBuffers[s]->getEpochLiteralBudget() == budget - (long) numAdmittedLits);
+    }
+    assert(epoch.use_count() == 1+numSolvers);
+
+    // Each solver ingests exactly its admitted clauses
+    for (int s = 0; s < numSolvers; s++) {
+        auto& importBuffer = *importBuffers[s];
+        std::multiset<std::vector<int>> received;
+        for (int lit : importBuffer.getUnitsBuffer()) received.insert(std::vector<int>(1, lit));
+        auto cls = importBuffer.get(AdaptiveClauseDatabase::NONUNITS);
+        while (cls.begin != nullptr) {
+            assert(cls.size >= 2);
+            received.insert(std::vector<int>(cls.begin, cls.begin+cls.size));
+            cls = importBuffer.get(AdaptiveClauseDatabase::NONUNITS);
+        }
+        assert(importBuffer.empty());
+        assert(received == expected[s]);
+        assert(stats[s].receivedClausesDigested == expected[s].size());
+        assert(importBuffer.getEpochLiteralBudget() == budget);
+        LOG(V2_INFO, "Solver %i: %lu/%lu clauses ingested\n", s, received.size(), epoch->getNumClauses());
+    }
+    // All solvers released the epoch
+    assert(epoch.use_count() == 1);
+}
+
 void testConcurrentImport() {
 
     SolverSetup setup;
@@ -51,68 +132,36 @@ void testConcurrentImport() {
     int nbTotalAdded = 0;
     int nbTotalDigested = 0;
 
-    // Producer
+    // Producer: collects clauses and hands them over as sharing epochs
     auto futureProd = ProcessWideThreadPool::get().addTask([&]() {
-        std::forward_list<int> units;
-        std::forward_list<std::pair<int, int>> binaries;
-        std::map<std::pair<int, int>, std::forward_list<std::vector<int>>> lenLbdToList;
+        AdaptiveClauseDatabase::Setup cdbSetup;
+        cdbSetup.maxClauseLength = setup.strictClauseLengthLimit;
+        cdbSetup.maxLbdPartitionedSize = 2;
+        cdbSetup.numLiterals = 1'000'000;
+        cdbSetup.slotsForSumOfLengthAndLbd = false;
+        AdaptiveClauseDatabase cdb(cdbSetup);
 
         float startTime = Timer::elapsedSeconds();
         float lastImport = startTime;
 
         auto pushClauses = [&]() {
             LOG(V2_INFO, "Adding clauses to import buffer\n");
-            int budget, remaining, nbAdded = 0;
-            
-            budget = importBuffer.getLiteralBudget(1, 1); remaining = budget;
-            units.remove_if([&](int i) {
-                if (remaining == 0) return true;
-                remaining--;
-                nbAdded++;
-                return false;
-            });
-            importBuffer.performImport(1, 1, units, budget-remaining);
-
-            budget = importBuffer.getLiteralBudget(2, 2); remaining = budget;
-            binaries.remove_if([&](const auto& pair) {
-                if (remaining < 2) return true;
-                remaining -= 2;
-                nbAdded++;
-                return false;
-            });
-            importBuffer.performImport(2, 2, binaries, budget-remaining);
-
-            for (auto& entry : lenLbdToList) {
-                auto [len, lbd] = entry.first;
-                auto& list = entry.second;
-                budget = importBuffer.getLiteralBudget(len, lbd); remaining = budget;
-                list.remove_if([&](const auto& pair) {
-                    if (remaining < len) return true;
-                    remaining -= len;
-                    nbAdded++;
-                    return false;
-                });
-                importBuffer.performImport(len, lbd, list, budget-remaining);
-            }
-
+            int numExported;
+            auto buf = cdb.exportBuffer(importBuffer.getEpochLiteralBudget(), numExported);
+            auto epoch = std::make_shared<const ImportEpochBuffer>(std::move(buf), cdb);
+            size_t numLits = 0;
+            for (size_t idx = 0; idx < epoch->getNumClauses(); idx++) numLits += epoch->getEntry(idx).size;
+            std::vector<uint64_t> excluded((epoch->getNumClauses()+63)/64, 0);
+            importBuffer.addEpoch(epoch, std::move(excluded), numLits);
             lastImport = Timer::elapsedSeconds();
-            LOG(V2_INFO, "Added %i clauses to import buffer\n", nbAdded);
+            LOG(V2_INFO, "Added %i clauses to import buffer\n", numExported);
         };
 
         while (Timer::elapsedSeconds() - startTime <= 60 && !Terminator::isTerminating()) {
 
             auto cls = generateClause(1, setup.strictClauseLengthLimit);
-            if (cls.size == 1) {
-                units.push_front(cls.begin[0]);
-            } else if (cls.size == 2) {
-                binaries.emplace_front(cls.begin[0], cls.begin[1]);
-            } else {
-                std::vector<int> clauseVec(1+cls.size);
-                clauseVec[0] = cls.lbd;
-                for (size_t k = 0; k < cls.size; k++) clauseVec[k+1] = cls.begin[k];
-                lenLbdToList[std::pair<int, int>(cls.size, cls.lbd)].emplace_front(std::move(clauseVec));
-            }
-            nbTotalAdded++;
+            if (cdb.addClause(cls)) nbTotalAdded++;
+            free(cls.begin);
             usleep(1000 * 1); // 1 millis
 
             if (Timer::elapsedSeconds() - lastImport >= 1) {
@@ -151,5 +200,6 @@ int main() {
     Process::init(0);
     ProcessWideThreadPool::init(4);
     
+    testEpochImport();
     testConcurrentImport();
 }
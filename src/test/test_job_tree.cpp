@@ -0,0 +1,124 @@
+
+#include <vector>
+#include <set>
+
+#include "app/job_tree.hpp"
+#include "util/random.hpp"
+#include "util/sys/timer.hpp"
+#include "util/logger.hpp"
+#include "util/assert.hpp"
+
+// Regular process distribution: host h holds ranks c*h through c*h + c-1
+std::vector<int> getHostRanks(int rank, int processesPerHost) {
+    std::vector<int> ranks;
+    int host = rank / processesPerHost;
+    for (int r = 0; r < processesPerHost; r++) ranks.push_back(host*processesPerHost + r);
+    return ranks;
+}
+
+JobTree createTree(int commSize, int rank, int jobId, int index, int parentRank, int processesPerHost) {
+    JobTree tree(commSize, rank, jobId, /*useDormantChildren=*/false);
+    if (processesPerHost > 0) tree.setHostRanks(getHostRanks(rank, processesPerHost));
+    tree.update(index, index == 0 ? rank : -1, parentRank);
+    return tree;
+}
+
+void testDefaultPlacement() {
+
+    LOG(V2_INFO, "Placing subtrees onto hosts ...\n");
+
+    // 8 processes per host: subtrees of three levels (seven nodes) share a host
+    const int n = 64, c = 8, jobId = 5;
+    std::vector<int> rankOfIndex(15, -1);
+    rankOfIndex[0] = 19;
+    for (int index = 0; index < 7; index++) {
+        int parentRank = index == 0 ? -1 : rankOfIndex[(index-1)/2];
+        auto tree = createTree(n, rankOfIndex[index], jobId, index, parentRank, c);
+        assert(tree.hasLocalityPreservingPlacement());
+        rankOfIndex[tree.getLeftChildIndex()] = tree.getLeftChildNodeRank();
+        rankOfIndex[tree.getRightChildIndex()] = tree.getRightChildNodeRank();
+    }
+    std::set<int> ranks;
+    for (int index = 0; index < 7; index++) {
+        assert(rankOfIndex[index] / c == rankOfIndex[0] / c);
+        ranks.insert(rankOfIndex[index]);
+    }
+    assert(ranks.size() == 7);
+    // Top nodes of the next subtrees are placed pseudorandomly
+    JobTree reference(n, 0, jobId, false);
+    for (int index = 7; index < 15; index++) {
+        reference.update((index-1)/2, 0, 0);
+        int expected = index % 2 == 1 ? reference.getLeftChildNodeRank() : reference.getRightChildNodeRank();
+        assert(rankOfIndex[index] == expected);
+    }
+
+    // A child which has been placed explicitly stays where it is
+    auto tree = createTree(n, 19, jobId, 0, -1, c);
+    tree.setLeftChild(42);
+    assert(tree.getLeftChildNodeRank() == 42);
+    tree.unsetLeftChild();
+    assert(tree.getLeftChildNodeRank() == rankOfIndex[1]);
+
+    // A single process on the host falls back to pseudorandom placement
+    JobTree single(n, 3, jobId, false);
+    single.setHostRanks({3});
+    assert(!single.hasLocalityPreservingPlacement());
+}
+
+// Grows one job tree of the given size on n processes, a fraction of which is busy.
+// A child goes to its default rank if it is free and to a random free rank otherwise.
+// Returns the fraction of tree edges (i.e., clause sharing messages) crossing hosts.
+float simulateGrowth(int n, int processesPerHost, int numNodes, float busyRatio, int jobId, bool locality) {
+    std::vector<bool> busy(n);
+    for (int r = 0; r < n; r++) busy[r] = Random::rand() < busyRatio;
+    auto pickFree = [&]() {
+        int rank;
+        do rank = (int) (Random::rand() * n); while (busy[rank]);
+        busy[rank] = true;
+        return rank;
+    };
+
+    std::vector<int> rankOfIndex(numNodes, -1);
+    rankOfIndex[0] = pickFree();
+    int numInterHostEdges = 0;
+    for (int index = 1; index < numNodes; index++) {
+        int parentIndex = (index-1)/2;
+        int parentRank = rankOfIndex[parentIndex];
+        auto tree = createTree(n, parentRank, jobId, parentIndex,
+            parentIndex == 0 ? -1 : rankOfIndex[(parentIndex-1)/2], locality ? processesPerHost : 0);
+        int rank = index == tree.getLeftChildIndex() ? tree.getLeftChildNodeRank() : tree.getRightChildNodeRank();
+        if (busy[rank]) rank = pickFree();
+        else busy[rank] = true;
+        rankOfIndex[index] = rank;
+        if (rank / processesPerHost != parentRank / processesPerHost) numInterHostEdges++;
+    }
+    return numInterHostEdges / (float) (numNodes-1);
+}
+
+void benchmark() {
+
+    const int n = 1024, c = 16;
+    for (int numNodes : {32, 256}) for (float busyRatio : {0.0f, 0.5f}) {
+        float ratios[2];
+        for (int locality = 0; locality < 2; locality++) {
+            float sum = 0;
+            for (int jobId = 1; jobId <= 20; jobId++) {
+                Random::init(jobId, jobId);
+                sum += simulateGrowth(n, c, numNodes, busyRatio, jobId, locality == 1);
+            }
+            ratios[locality] = sum / 20;
+        }
+        LOG(V2_INFO, "n=%i c=%i nodes=%i busy=%.1f : inter-host edges %.3f (random) %.3f (locality)\n",
+            n, c, numNodes, busyRatio, ratios[0], ratios[1]);
+        assert(ratios[1] < ratios[0]);
+    }
+}
+
+int main() {
+    Timer::init();
+    Random::init(1, 1);
+    Logger::init(0, V5_DEBG);
+
+    testDefaultPlacement();
+    benchmark();
+}
@@ -175,10 +175,305 @@ void testBigP2P() {
     LOG(V2_INFO, "Max delay: %.4f s\n", maxDelay);
 }
 
+void testBurstOrdering() {
+
+    Terminator::reset();
+    int rank = MyMpi::rank(MPI_COMM_WORLD);
+    auto& q = MyMpi::getMessageQueue();
+    q.clearCallbacks();
+
+    // Burst of single (non-fragmented) messages of mixed sizes which must arrive
+    // in the order they were sent
+    const int numMessages = 2000;
+    auto getSize = [&](int i) {return i % 50 == 0 ? 200000 : (i % 7 == 0 ? 40000 : 1 + i % 100);};
+    q.getMetrics().reset();
+
+    int numReceived = 0;
+    q.registerCallback(TAG_INT_VEC, [&](MessageHandle& h) {
+        auto vec = Serializable::get<IntVec>(h.getRecvData()).data;
+        [[maybe_unused]] int i = vec[0];
+        assert(vec.size() == (size_t) getSize(i) 
+            || LOG_RETURN_FALSE("Msg %i: wrong size %i\n", i, vec.size()));
+        assert(vec.back() == i);
+        assert(i == numReceived || LOG_RETURN_FALSE("Msg %i received as msg #%i\n", i, numReceived));
+        numReceived++;
+        if (numReceived == numMessages) {
+            LOG(V2_INFO, "%s\n", q.getReceiveStatsReport().c_str());
+            assert(q.getMetrics().getNumMessages() == numMessages);
+            LOG(V2_INFO, "%s\n", q.getMetrics().toJsonLine().c_str());
+            MyMpi::isend(h.source, TAG_EXIT, IntVec());
+            Terminator::setTerminating();
+        }
+    });
+    q.registerCallback(TAG_EXIT, [&](MessageHandle& h) {
+        Terminator::setTerminating();
+    });
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (rank == 0) {
+        for (int i = 0; i < numMessages; i++) {
+            IntVec vec;
+            vec.data.resize(getSize(i), i);
+            MyMpi::isend(1, TAG_INT_VEC, vec);
+        }
+    }
+    while (!Terminator::isTerminating()) q.advance();
+    MPI_Barrier(MPI_COMM_WORLD);
+}
+
+void testCancelledBigSend() {
+
+    Terminator::reset();
+    int rank = MyMpi::rank(MPI_COMM_WORLD);
+    auto& q = MyMpi::getMessageQueue();
+    q.clearCallbacks();
+
+    // A large message cancelled right after its initiation must never arrive,
+    // and subsequent large messages must still arrive intact
+    int numReceived = 0;
+    q.registerCallback(TAG_INT_VEC, [&](MessageHandle& h) {
+        auto vec = Serializable::get<IntVec>(h.getRecvData()).data;
+        assert((vec.size() == 1000000 && vec.front() == 2 && vec.back() == 2)
+            || LOG_RETURN_FALSE("Received cancelled message!\n"));
+        numReceived++;
+        MyMpi::isend(h.source, TAG_EXIT, IntVec());
+        Terminator::setTerminating();
+    });
+    q.registerCallback(TAG_EXIT, [&](MessageHandle& h) {
+        Terminator::setTerminating();
+    });
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (rank == 0) {
+        IntVec vec;
+        vec.data.resize(10000000, 1);
+        int id = MyMpi::isend(1, TAG_INT_VEC, vec);
+        for (int i = 0; i < 10; i++) q.advance();
+        q.cancelSend(id);
+        vec.data.assign(1000000, 2);
+        MyMpi::isend(1, TAG_INT_VEC, vec);
+    }
+    while (!Terminator::isTerminating()) q.advance();
+    assert(rank == 0 || numReceived == 1);
+    MPI_Barrier(MPI_COMM_WORLD);
+}
+
+void testControlPriority() {
+
+    Terminator::reset();
+    int rank = MyMpi::rank(MPI_COMM_WORLD);
+    auto& q = MyMpi::getMessageQueue();
+    q.clearCallbacks();
+    q.setTagPriority(TAG_PINGPONG, MessageQueue::PRIORITY_CONTROL);
+
+    // A control message sent after a burst of large (fragmented) messages
+    // must overtake the large messages which are still queued
+    const int numLargeMessages = 20;
+    int numLargeReceived = 0;
+    int numLargeReceivedBeforeControl = -1;
+    q.registerCallback(TAG_INT_VEC, [&](MessageHandle& h) {
+        numLargeReceived++;
+        if (numLargeReceived == numLargeMessages) {
+            MyMpi::isend(h.source, TAG_EXIT, IntVec());
+            Terminator::setTerminating();
+        }
+    });
+    q.registerCallback(TAG_PINGPONG, [&](MessageHandle& h) {
+        numLargeReceivedBeforeControl = numLargeReceived;
+    });
+    q.registerCallback(TAG_EXIT, [&](MessageHandle& h) {
+        Terminator::setTerminating();
+    });
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (rank == 0) {
+        for (int i = 0; i < numLargeMessages; i++) {
+            IntVec vec;
+            vec.data.resize(500000, i);
+            MyMpi::isend(1, TAG_INT_VEC, vec);
+        }
+        MyMpi::isend(1, TAG_PINGPONG, IntVec());
+    }
+    while (!Terminator::isTerminating()) q.advance();
+    if (rank == 1) {
+        LOG(V2_INFO, "Control message received after %i/%i large messages\n", 
+            numLargeReceivedBeforeControl, numLargeMessages);
+        assert(numLargeReceivedBeforeControl >= 0 && numLargeReceivedBeforeControl < numLargeMessages);
+    } else {
+        for (auto& report : q.getSendDelayReports()) LOG(V2_INFO, "%s\n", report.c_str());
+    }
+    q.setTagPriority(TAG_PINGPONG, MessageQueue::PRIORITY_DEFAULT);
+    MPI_Barrier(MPI_COMM_WORLD);
+}
+
+float testBusySender() {
+
+    Terminator::reset();
+    int rank = MyMpi::rank(MPI_COMM_WORLD);
+    auto& q = MyMpi::getMessageQueue();
+    q.clearCallbacks();
+
+    // Rank 0 sends a large message while its main thread is mostly busy
+    const int numInts = 5000000;
+    q.registerCallback(TAG_INT_VEC, [&](MessageHandle& h) {
+        auto vec = Serializable::get<IntVec>(h.getRecvData()).data;
+        assert(vec.size() == numInts);
+        for (int i = 0; i < numInts; i += 1000) assert(vec[i] == i);
+        MyMpi::isend(h.source, TAG_ACK, IntVec());
+        Terminator::setTerminating();
+    });
+    q.registerCallback(TAG_ACK, [&](MessageHandle& h) {
+        Terminator::setTerminating();
+    });
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    float time = Timer::elapsedSeconds();
+    if (rank == 0) {
+        IntVec vec;
+        vec.data.resize(numInts);
+        for (int i = 0; i < numInts; i++) vec.data[i] = i;
+        MyMpi::isend(1, TAG_INT_VEC, vec);
+    }
+    while (!Terminator::isTerminating()) {
+        q.advance();
+        if (rank == 0) usleep(5000); // "work"
+    }
+    time = Timer::elapsedSeconds() - time;
+    if (rank == 0) LOG(V2_INFO, "Transfer with busy sender took %.4fs\n", time);
+    MPI_Barrier(MPI_COMM_WORLD);
+    return time;
+}
+
+void testInboxOverflow() {
+
+    Terminator::reset();
+    int rank = MyMpi::rank(MPI_COMM_WORLD);
+    auto& q = MyMpi::getMessageQueue();
+    q.clearCallbacks();
+
+    // More messages (and send completions) than the progress thread's inbox holds
+    // while the main threads do not advance the queue but query its statistics
+    const int numMessages = 40000;
+    int numReceived = 0;
+    q.registerCallback(TAG_INT_VEC, [&](MessageHandle& h) {
+        auto vec = Serializable::get<IntVec>(h.getRecvData()).data;
+        assert((vec.size() == 1 && vec[0] == numReceived) 
+            || LOG_RETURN_FALSE("Msg %i received as msg #%i\n", vec[0], numReceived));
+        numReceived++;
+        if (numReceived == numMessages) {
+            MyMpi::isend(h.source, TAG_EXIT, IntVec());
+            Terminator::setTerminating();
+        }
+    });
+    q.registerCallback(TAG_EXIT, [&](MessageHandle& h) {
+        Terminator::setTerminating();
+    });
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (rank == 0) {
+        for (int i = 0; i < numMessages; i++) {
+            IntVec vec;
+            vec.data.push_back(i);
+            MyMpi::isend(1, TAG_INT_VEC, vec);
+        }
+    }
+    float time = Timer::elapsedSeconds();
+    while (Timer::elapsedSeconds() - time < 1) {
+        q.getReceiveStatsReport();
+        q.getSendDelayReports();
+        usleep(1000);
+    }
+    while (!Terminator::isTerminating()) q.advance();
+    if (rank == 1) LOG(V2_INFO, "%i messages received in order\n", numReceived);
+    MPI_Barrier(MPI_COMM_WORLD);
+}
+
+void testBufferReuse(int maxMsgSize) {
+
+    Terminator::reset();
+    int rank = MyMpi::rank(MPI_COMM_WORLD);
+    auto& q = MyMpi::getMessageQueue();
+    q.clearCallbacks();
+
+    // Messages which fill the receive buffers, one after the other: each of them
+    // is handed over without copying since its callback leaves the buffer for reuse
+    const int numMessages = 50;
+    int numReceived = 0;
+    q.getReceiveStatsReport();
+    q.registerCallback(TAG_INT_VEC, [&](MessageHandle& h) {
+        assert(h.getRecvData().size() == (size_t) maxMsgSize);
+        numReceived++;
+        if (rank == 0) return;
+        if (numReceived < numMessages) {
+            MyMpi::isend(0, TAG_ACK, IntVec());
+            return;
+        }
+        auto report = q.getReceiveStatsReport();
+        LOG(V2_INFO, "%s\n", report.c_str());
+        unsigned long numZeroCopy = 0;
+        sscanf(strstr(report.c_str(), "zerocopy="), "zerocopy=%lu", &numZeroCopy);
+        assert(numZeroCopy == (unsigned long) numMessages || LOG_RETURN_FALSE("Only %lu/%i messages handed over\n", 
+            numZeroCopy, numMessages));
+        MyMpi::isend(0, TAG_EXIT, IntVec());
+        Terminator::setTerminating();
+    });
+    q.registerCallback(TAG_ACK, [&](MessageHandle& h) {
+        MyMpi::isend(1, TAG_INT_VEC, std::vector<uint8_t>(maxMsgSize, 1));
+    });
+    q.registerCallback(TAG_EXIT, [&](MessageHandle& h) {
+        Terminator::setTerminating();
+    });
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (rank == 0) MyMpi::isend(1, TAG_INT_VEC, std::vector<uint8_t>(maxMsgSize, 1));
+    while (!Terminator::isTerminating()) q.advance();
+    MPI_Barrier(MPI_COMM_WORLD);
+}
+
+// Returns the average round trip time of a small message between ranks 0 and 1.
+float testPingPong(int numRoundTrips) {
+
+    Terminator::reset();
+    int rank = MyMpi::rank(MPI_COMM_WORLD);
+    auto& q = MyMpi::getMessageQueue();
+    q.clearCallbacks();
+
+    int numReceived = 0;
+    q.registerCallback(TAG_PINGPONG, [&](MessageHandle& h) {
+        auto vec = Serializable::get<IntVec>(h.getRecvData());
+        assert(vec.data.size() == 16);
+        assert(vec[0] == numReceived);
+        numReceived++;
+        if (rank == 1) MyMpi::isend(0, TAG_PINGPONG, vec);
+        else if (numReceived < numRoundTrips) {
+            vec[0] = numReceived;
+            MyMpi::isend(1, TAG_PINGPONG, vec);
+        }
+    });
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    float time = Timer::elapsedSeconds();
+    if (rank == 0) {
+        IntVec vec;
+        vec.data.resize(16, 0);
+        MyMpi::isend(1, TAG_PINGPONG, vec);
+    }
+    while (numReceived < numRoundTrips) q.advance();
+    time = (Timer::elapsedSeconds() - time) / numRoundTrips;
+    MPI_Barrier(MPI_COMM_WORLD);
+    return time;
+}
+
 int main(int argc, char *argv[]) {
 
-    MyMpi::init();
     Timer::init();
+    Parameters params;
+    params.init(argc, argv);
+    // The progress thread (which requires MPI_THREAD_MULTIPLE) is only tested with -mpt
+    bool testProgressThread = params.mpiProgressThread();
+    params.mpiProgressThread.set(false);
+
+    MyMpi::init(/*threadMultiple=*/testProgressThread);
     int rank = MyMpi::rank(MPI_COMM_WORLD);
 
     Process::init(rank);
@@ -186,13 +481,41 @@ int main(int argc, char *argv[]) {
     Random::init(rand(), rand());
     Logger::init(rank, V5_DEBG);
 
-    Parameters params;
-    params.init(argc, argv);
     MyMpi::setOptions(params);
 
     //testSelfMessages();
     //testSimpleP2P();
+    testBurstOrdering();
+    testCancelledBigSend();
+    testControlPriority();
+    testBigP2P();
+    testBufferReuse(params.messageBatchingThreshold());
+    float timeWithoutThread = testBusySender();
+    float rttMpi = testPingPong(10000);
+
+    auto& q = MyMpi::getMessageQueue();
+    if (testProgressThread) {
+        // Repeat with a dedicated progress thread
+        q.startProgressThread(10);
+        testBurstOrdering();
+        testCancelledBigSend();
+        testBigP2P();
+        testBufferReuse(params.messageBatchingThreshold());
+        float timeWithThread = testBusySender();
+        testInboxOverflow();
+        q.stopProgressThread();
+        if (rank == 0) LOG(V2_INFO, "Busy sender: %.4fs without, %.4fs with progress thread\n", 
+            timeWithoutThread, timeWithThread);
+    }
+
+    // Repeat with shared memory transport between the (co-located) ranks
+    q.enableSharedMemoryTransport(1<<20);
+    testBurstOrdering();
+    testControlPriority();
     testBigP2P();
+    float rttShmem = testPingPong(10000);
+    if (rank == 0) LOG(V2_INFO, "Ping pong round trip: %.2fus via MPI, %.2fus via shared memory\n", 
+        1000000*rttMpi, 1000000*rttShmem);
 
     MPI_Finalize();
 }
\ No newline at end of file
@@ -0,0 +1,161 @@
+
+#include <vector>
+#include <atomic>
+
+#include "balancing/region_router.hpp"
+#include "util/random.hpp"
+#include "util/sys/timer.hpp"
+#include "util/logger.hpp"
+#include "util/assert.hpp"
+
+// Three hosts with four processes each
+std::vector<int> getRegions() {
+    return std::vector<int>({0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2});
+}
+
+std::vector<int> createSummary(const std::vector<std::pair<int, int>>& versionsAndCounts) {
+    std::vector<int> summary;
+    for (auto [version, count] : versionsAndCounts) {
+        summary.push_back(version);
+        summary.push_back(count);
+    }
+    return summary;
+}
+
+void testLocalRouting() {
+
+    LOG(V2_INFO, "Routing to idle processes on this host ...\n");
+
+    std::atomic<uint8_t> board[4];
+    for (auto& flag : board) flag.store(0);
+    std::atomic_int version {0};
+    RegionRouter router(0, getRegions(), board, &version);
+
+    // Nobody is known to be idle
+    assert(router.route(1, 5) == -1);
+
+    // Rank 2 is idle; requester (1) and this process (0) are never chosen
+    board[0].store(1); board[1].store(1); board[2].store(1);
+    assert(router.route(1, 5) == 2);
+    // Rank 2 is not chosen again until it reports to be idle again
+    assert(router.route(1, 5) == -1);
+    router.setIdle(false);
+    assert(board[0].load() == 0);
+
+    router.updateLocalRegion();
+    assert(router.getEstimatedIdleCount(0) == 1);
+    assert(router.getSummary()[0] == 1);
+}
+
+void testRemoteRouting() {
+
+    LOG(V2_INFO, "Routing to other hosts ...\n");
+
+    std::atomic<uint8_t> board[4];
+    for (auto& flag : board) flag.store(0);
+    std::atomic_int version {0};
+    RegionRouter router(0, getRegions(), board, &version);
+    router.mergeSummary(createSummary({{5, 3}, {1, 1}, {1, 2}}));
+    // This region's own information is never overwritten
+    assert(router.getEstimatedIdleCount(0) == 0);
+    assert(router.getEstimatedIdleCount(1) == 1);
+    assert(router.getEstimatedIdleCount(2) == 2);
+
+    // The requesting process' host is preferred
+    for (int i = 0; i < 2; i++) {
+        int rank = router.route(9, 3);
+        assert(router.getRegion(rank) == 2);
+        assert(rank != 9);
+    }
+    // ... until it is not expected to have idle workers any more
+    int rank = router.route(9, 3);
+    assert(router.getRegion(rank) == 1);
+    assert(router.route(9, 3) == -1);
+
+    // Outdated information is ignored, newer information is adopted
+    router.mergeSummary(createSummary({{9, 0}, {1, 4}, {2, 4}}));
+    assert(router.getEstimatedIdleCount(1) == 0);
+    assert(router.getEstimatedIdleCount(2) == 4);
+}
+
+void testSharedVersion() {
+
+    LOG(V2_INFO, "Gossiping information of processes on the same host ...\n");
+
+    // Ranks 0 and 1 share a host, rank 4 resides on another host
+    std::atomic<uint8_t> board[4];
+    for (auto& flag : board) flag.store(0);
+    std::atomic_int version {0};
+    RegionRouter router0(0, getRegions(), board, &version);
+    RegionRouter router1(1, getRegions(), board, &version);
+    std::atomic<uint8_t> otherBoard[4];
+    for (auto& flag : otherBoard) flag.store(0);
+    std::atomic_int otherVersion {0};
+    RegionRouter remote(4, getRegions(), otherBoard, &otherVersion);
+
+    // Rank 0 reads the board more often than rank 1, which reads it last
+    board[2].store(1);
+    router0.updateLocalRegion();
+    router0.updateLocalRegion();
+    board[3].store(1);
+    router1.updateLocalRegion();
+    remote.mergeSummary(router1.getSummary());
+    assert(remote.getEstimatedIdleCount(0) == 2);
+    // The more frequent, but older information does not replace the newer information
+    remote.mergeSummary(router0.getSummary());
+    assert(remote.getEstimatedIdleCount(0) == 2);
+}
+
+void testWeightedRouting() {
+
+    LOG(V2_INFO, "Routing weighted by the number of idle workers ...\n");
+
+    std::atomic<uint8_t> board[4];
+    for (auto& flag : board) flag.store(0);
+    std::atomic_int version {0};
+    RegionRouter router(0, getRegions(), board, &version);
+    router.mergeSummary(createSummary({{0, 0}, {1, 1000}, {1, 3000}}));
+
+    int numRoutedToRegion[3] = {0, 0, 0};
+    for (int i = 0; i < 1000; i++) {
+        int rank = router.route(1, 2);
+        assert(rank >= 0);
+        numRoutedToRegion[router.getRegion(rank)]++;
+    }
+    LOG(V2_INFO, "Routed %i, %i, %i\n", numRoutedToRegion[0], numRoutedToRegion[1], numRoutedToRegion[2]);
+    assert(numRoutedToRegion[0] == 0);
+    assert(numRoutedToRegion[2] > 2*numRoutedToRegion[1]);
+    assert(router.getEstimatedIdleCount(1) + router.getEstimatedIdleCount(2) == 3000);
+}
+
+void testInit() {
+
+    LOG(V2_INFO, "Setting up regions ...\n");
+
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    RegionRouter router;
+    assert(!router.isInitialized());
+    router.init(MPI_COMM_WORLD);
+    assert(router.isInitialized());
+    assert(router.getNumRegions() >= 1 && router.getNumRegions() <= size);
+    router.setIdle(true);
+    router.updateLocalRegion();
+    assert(router.getEstimatedIdleCount(router.getRegion(rank)) >= 1);
+}
+
+int main(int argc, char *argv[]) {
+    MPI_Init(&argc, &argv);
+    Timer::init();
+    Random::init(1, 1);
+    Logger::init(0, V5_DEBG);
+
+    testLocalRouting();
+    testRemoteRouting();
+    testSharedVersion();
+    testWeightedRouting();
+    testInit();
+
+    MPI_Finalize();
+}
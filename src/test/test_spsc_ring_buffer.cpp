@@ -0,0 +1,110 @@
+
+#include <thread>
+#include <vector>
+
+#include "util/sys/spsc_ring_buffer.hpp"
+#include "util/random.hpp"
+#include "util/sys/timer.hpp"
+#include "util/logger.hpp"
+#include "util/assert.hpp"
+
+void testWraparound() {
+
+    LOG(V2_INFO, "Wrapping around the ring ...\n");
+
+    SPSCRingBuffer ring(10);
+    assert(ring.capacity() == 16);
+    assert(ring.empty());
+
+    // Records of 1+1+4 = 6 integers: the ring wraps around after the second record
+    for (int i = 0; i < 20; i++) {
+        int h = i;
+        const int payload[4] = {i, i+1, i+2, i+3};
+        bool pushed = ring.tryPush(&h, 1, payload, 4);
+        pushed = pushed && ring.tryPush(&h, 1, payload, 4);
+        assert(pushed);
+        int nbSeen = 0;
+        bool recordsOk = true;
+        size_t nbConsumed = ring.consume(SIZE_MAX, [&](const int* record, size_t size) {
+            recordsOk = recordsOk && size == 5 && record[0] == i;
+            for (int j = 0; j < 4; j++) recordsOk = recordsOk && record[1+j] == i+j;
+            nbSeen++;
+        });
+        recordsOk = recordsOk && nbConsumed == 2 && nbSeen == 2;
+        assert(recordsOk);
+        assert(ring.empty());
+    }
+}
+
+void testRejection() {
+
+    LOG(V2_INFO, "Rejecting records which do not fit ...\n");
+
+    SPSCRingBuffer ring(16);
+    const int payload[15] = {0};
+    bool ok = true;
+    // A record larger than the capacity never fits
+    ok = ok && !ring.tryPush(payload, 0, payload, 16);
+    // Exactly full
+    ok = ok && ring.tryPush(payload, 0, payload, 7);
+    ok = ok && ring.tryPush(payload, 0, payload, 7);
+    ok = ok && !ring.tryPush(payload, 0, payload, 0);
+    assert(ok);
+    // Consuming one record frees its space again
+    size_t consumedSize = 0;
+    ok = ok && ring.consume(1, [&](const int*, size_t size) {consumedSize = size;}) == 1;
+    ok = ok && consumedSize == 7;
+    ok = ok && !ring.tryPush(payload, 0, payload, 8);
+    ok = ok && ring.tryPush(payload, 0, payload, 7);
+    ok = ok && ring.consume(SIZE_MAX, [](const int*, size_t) {}) == 2;
+    ok = ok && ring.empty();
+    assert(ok);
+}
+
+void testConcurrentFifo() {
+
+    LOG(V2_INFO, "Passing records from a producer thread to a consumer thread ...\n");
+
+    SPSCRingBuffer ring(256);
+    const int nbRecords = 50000;
+    int nbRejected = 0;
+    std::thread producer([&]() {
+        std::vector<int> payload;
+        for (int i = 0; i < nbRecords; i++) {
+            // Sizes vary so that records straddle the end of the ring
+            payload.assign(i % 13, i);
+            while (!ring.tryPush(&i, 1, payload.data(), payload.size())) {
+                nbRejected++;
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int expected = 0;
+    bool inOrder = true;
+    while (expected < nbRecords) {
+        if (ring.empty()) std::this_thread::yield();
+        ring.consume(SIZE_MAX, [&](const int* record, size_t size) {
+            if (record[0] != expected || size != 1 + (size_t) (expected % 13)) {
+                LOG(V0_CRIT, "[ERROR] Expected %i, got %i (size %lu)\n", expected, record[0], size);
+                inOrder = false;
+            }
+            for (size_t j = 1; j < size; j++) inOrder = inOrder && record[j] == expected;
+            expected++;
+        });
+    }
+    producer.join();
+    assert(inOrder);
+    assert(ring.empty());
+    LOG(V2_INFO, "%i records in order, %i rejected pushes\n", nbRecords, nbRejected);
+}
+
+int main() {
+    Timer::init();
+    Random::init(1, 1);
+    Logger::init(0, V5_DEBG);
+
+    testWraparound();
+    testRejection();
+    testConcurrentFifo();
+}
@@ -1,4 +1,6 @@
 
+#include <climits>
+
 #include "util/sys/timer.hpp"
 #include "util/random.hpp"
 
@@ -214,6 +216,104 @@ void testTinyModifier(Parameters& params) {
     auto result = testEventMap(params, map, /*numWorkers=*/100, /*expectedUtilization=*/100);
 }
 
+void testEventMapSerialization(Parameters& params) {
+    LOG(V2_INFO, "#### Test event map serialization ####\n");
+    EventMap map;
+    map.insertIfNovel(Event({/*ID=*/1, /*epoch=*/1, /*demand=*/1, /*priority=*/0.01}));
+    map.insertIfNovel(Event({/*ID=*/2, /*epoch=*/3, /*demand=*/100000, /*priority=*/0.01}));
+    map.insertIfNovel(Event({/*ID=*/300, /*epoch=*/INT_MAX, /*demand=*/0, /*priority=*/0}));
+    map.insertIfNovel(Event({/*ID=*/1000000, /*epoch=*/2, /*demand=*/64, /*priority=*/0.5}));
+    map.setGlobalEpoch(17);
+
+    auto packed = map.serialize();
+    EventMap unpacked = Serializable::get<EventMap>(packed);
+    assert(unpacked == map);
+    assert(unpacked.getGlobalEpoch() == 17);
+    assert(packed.size() < sizeof(size_t) + 4 * 16);
+
+    EventMap empty;
+    empty.setGlobalEpoch(5);
+    EventMap unpackedEmpty = Serializable::get<EventMap>(empty.serialize());
+    assert(unpackedEmpty.isEmpty());
+    assert(unpackedEmpty.getGlobalEpoch() == 5);
+}
+
+// Compares a persistent calculator which is updated with a few changed events
+// per epoch to calculations from scratch over the full state.
+void testIncrementalScaling(Parameters& params) {
+    LOG(V2_INFO, "#### Test incremental scaling ####\n");
+
+    const int numWorkers = 1 << 20;
+    const int numEpochs = 10;
+    const int numChangesPerEpoch = 10;
+
+    for (int numJobs : {10000, 30000, 100000}) {
+
+        EventMap states;
+        VolumeCalculator incremental(params, numWorkers, false);
+        for (int i = 0; i < numJobs; i++) {
+            Event ev {/*ID=*/i+1, /*epoch=*/1, /*demand=*/1 + (int) (Random::rand() * 1000), 
+                /*priority=*/0.01f + 0.99f * Random::rand()};
+            states.insertIfNovel(ev);
+            incremental.update(ev);
+        }
+
+        float timeIncremental = 0;
+        float timeFromScratch = 0;
+        size_t bytesFull = 0;
+        size_t bytesDiffs = 0;
+        for (int epoch = 2; epoch <= numEpochs+1; epoch++) {
+
+            // A few jobs change their demand, one job terminates and a new one arrives
+            EventMap diffs;
+            for (int c = 0; c < numChangesPerEpoch; c++) {
+                int jobId = 1 + (int) (Random::rand() * numJobs);
+                if (!states.getEntries().count(jobId)) continue;
+                const auto& ev = states.getEntries().at(jobId);
+                diffs.insertIfNovel(Event{jobId, epoch, 1 + (int) (Random::rand() * 1000), ev.priority});
+            }
+            diffs.insertIfNovel(Event{states.getEntries().begin()->first, INT_MAX, 0, 0});
+            diffs.insertIfNovel(Event{numJobs + epoch, 1, 1, 0.01});
+            diffs.setGlobalEpoch(epoch);
+            bytesDiffs += diffs.serialize().size();
+            bytesFull += sizeof(size_t) + states.getEntries().size() * (3*sizeof(int)+sizeof(float));
+
+            // Incremental update and calculation
+            float time = Timer::elapsedSeconds();
+            for (const auto& [jobId, ev] : diffs.getEntries()) {
+                if (states.insertIfNovel(ev)) incremental.update(ev);
+            }
+            incremental.calculateResult();
+            timeIncremental += Timer::elapsedSeconds() - time;
+
+            // Calculation from scratch
+            time = Timer::elapsedSeconds();
+            VolumeCalculator fromScratch(states, params, numWorkers, false);
+            fromScratch.calculateResult();
+            timeFromScratch += Timer::elapsedSeconds() - time;
+
+            // Results must be identical
+            assert(incremental.getEntries().size() == fromScratch.getEntries().size());
+            robin_hood::unordered_map<int, int> volumes;
+            for (const auto& entry : fromScratch.getEntries()) volumes[entry.jobId] = entry.volume;
+            int sum = 0;
+            for (const auto& entry : incremental.getEntries()) {
+                assert(volumes.at(entry.jobId) == entry.volume);
+                sum += entry.volume;
+            }
+            assert(sum == numWorkers);
+            assert(incremental.getZeroEntries().size() == fromScratch.getZeroEntries().size());
+
+            for (int jobId : states.removeOldZeros()) incremental.remove(jobId);
+            assert(incremental.getNumJobs() == states.getEntries().size());
+        }
+
+        LOG(V2_INFO, "nJobs=%i avgTimeIncremental=%.6fs avgTimeFromScratch=%.6fs avgBytesDiffs=%.1f avgBytesFull=%.1f\n", 
+            numJobs, timeIncremental/numEpochs, timeFromScratch/numEpochs, 
+            bytesDiffs/(float)numEpochs, bytesFull/(float)numEpochs);
+    }
+}
+
 int main(int argc, char *argv[]) {
     Timer::init();
     Parameters params;
@@ -231,6 +331,8 @@ int main(int argc, char *argv[]) {
     testDivergentDemandPriorityRatio(params);
     testTinyModifier(params);
     testHugeModifier(params);
+    testEventMapSerialization(params);
+    testIncrementalScaling(params);
     testPerformance(params);
 }
 
@@ -0,0 +1,58 @@
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+// Histogram of latencies with logarithmic buckets: bucket i counts latencies
+// within [2^(i-1), 2^i) microseconds (bucket 0: less than one microsecond).
+class LatencyHistogram {
+
+private:
+    std::vector<unsigned long> _buckets;
+    unsigned long _num {0};
+    double _sum {0};
+    double _max {0};
+
+public:
+    LatencyHistogram(int numBuckets = 28) : _buckets(numBuckets, 0) {}
+
+    void add(double seconds) {
+        double micros = std::max(0.0, 1000000 * seconds);
+        int bucket = micros < 1 ? 0 : 1 + (int) std::log2(micros);
+        _buckets[std::min(bucket, (int)_buckets.size()-1)]++;
+        _num++;
+        _sum += seconds;
+        _max = std::max(_max, seconds);
+    }
+
+    unsigned long getNumEntries() const {return _num;}
+    double getSum() const {return _sum;}
+    const std::vector<unsigned long>& getBuckets() const {return _buckets;}
+    double getMean() const {return _num == 0 ? 0 : _sum / _num;}
+    double getMax() const {return _max;}
+
+    void reset() {
+        std::fill(_buckets.begin(), _buckets.end(), 0);
+        _num = 0;
+        _sum = 0;
+        _max = 0;
+    }
+
+    // Report the number of entries, the mean and max. latency in microseconds,
+    // and the counts of all buckets up to the last non-empty bucket.
+    std::string getReport() const {
+        int endIdx = _buckets.size()-1;
+        while (endIdx > 0 && _buckets[endIdx] == 0) endIdx--;
+        std::string out = "n:" + std::to_string(_num)
+            + " avg_us:" + std::to_string((long) (1000000 * getMean()))
+            + " max_us:" + std::to_string((long) (1000000 * _max)) + " hist:";
+        for (int i = 0; i <= endIdx; i++) {
+            if (i > 0) out += ",";
+            out += std::to_string(_buckets[i]);
+        }
+        return out;
+    }
+};
@@ -34,6 +34,7 @@ public:
     int get(int x) const;
     void adjust(int x, int new_x);
     void clear(int x);
+    bool isAdjusted(int x) const {return _adjusted_values.count(x);}
     int operator[](int x) const { return get(x); };
     void clear();
 
@@ -0,0 +1,75 @@
+
+#ifndef DOMPASCH_MALLOB_DOORBELL_HPP
+#define DOMPASCH_MALLOB_DOORBELL_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Wake-up primitive for two processes sharing a memory segment.
+// The object must reside in shared memory; it is based on a futex
+// (without the "private" flag) over a sequence number, so it works
+// across process boundaries without any signals or polling.
+// The waiting side remembers the last sequence number it has seen
+// and waits until the number changes (or a timeout is hit):
+//   uint32_t seq = bell.getSequenceNumber();
+//   ... check for work ...
+//   bell.wait(seq, timeoutMicros);
+// Since the sequence number is read before checking for work, a ring
+// in between is never lost.
+class Doorbell {
+
+private:
+    std::atomic<uint32_t> _seq {0};
+    std::atomic<uint32_t> _num_waiters {0};
+
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+    static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+public:
+    uint32_t getSequenceNumber() const {
+        return _seq.load(std::memory_order_seq_cst);
+    }
+
+    // ring() increments _seq, then reads _num_waiters; wait() increments
+    // _num_waiters, then (in the kernel) reads _seq. Both sides must be
+    // sequentially consistent so that at least one of them observes the
+    // other's write - otherwise a wake-up may be lost.
+    void ring() {
+        _seq.fetch_add(1, std::memory_order_seq_cst);
+        // Skip the system call if nobody is sleeping
+        if (_num_waiters.load(std::memory_order_seq_cst) > 0)
+            futex(FUTEX_WAKE, INT_MAX, nullptr);
+    }
+
+    // Returns true iff the doorbell was rung since the provided sequence number was read.
+    bool wait(uint32_t seenSequenceNumber, long timeoutMicros) {
+        if (getSequenceNumber() != seenSequenceNumber) return true;
+        timespec timeout;
+        timeout.tv_sec = timeoutMicros / 1000000;
+        timeout.tv_nsec = (timeoutMicros % 1000000) * 1000;
+        _num_waiters.fetch_add(1, std::memory_order_seq_cst);
+        // Returns immediately if the sequence number differs from the seen one
+        futex(FUTEX_WAIT, seenSequenceNumber, &timeout);
+        _num_waiters.fetch_sub(1, std::memory_order_seq_cst);
+        return getSequenceNumber() != seenSequenceNumber;
+    }
+
+    // Monotonic system-wide time stamp (comparable across processes) in nanoseconds.
+    static uint64_t getTimestampNanos() {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return 1000000000UL * ts.tv_sec + ts.tv_nsec;
+    }
+
+private:
+    long futex(int op, uint32_t val, const timespec* timeout) {
+        return syscall(SYS_futex, (uint32_t*) &_seq, op, val, timeout, nullptr, 0);
+    }
+};
+
+#endif
@@ -0,0 +1,54 @@
+
+#ifndef DOMPASCH_MALLOB_SPSC_QUEUE_HPP
+#define DOMPASCH_MALLOB_SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Bounded, lock-free FIFO queue of (movable) objects for exactly
+// one producer thread and one consumer thread.
+template <typename T>
+class SPSCQueue {
+
+private:
+    std::vector<T> _slots;
+    size_t _mask;
+
+    // Read position (only written by the consumer)
+    alignas(64) std::atomic<size_t> _head {0};
+    // Write position (only written by the producer)
+    alignas(64) std::atomic<size_t> _tail {0};
+
+public:
+    SPSCQueue(size_t minCapacity) {
+        size_t capacity = 1;
+        while (capacity < minCapacity) capacity *= 2;
+        _slots.resize(capacity);
+        _mask = capacity-1;
+    }
+
+    // Producer side: returns false iff the queue is full.
+    bool tryPush(T&& elem) {
+        const size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head.load(std::memory_order_acquire) == _slots.size()) return false;
+        _slots[tail & _mask] = std::move(elem);
+        _tail.store(tail+1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: returns false iff the queue is empty.
+    bool tryPop(T& out) {
+        const size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire)) return false;
+        out = std::move(_slots[head & _mask]);
+        _head.store(head+1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+    }
+};
+
+#endif
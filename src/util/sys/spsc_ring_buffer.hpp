@@ -0,0 +1,81 @@
+
+#ifndef DOMPASCH_MALLOB_SPSC_RING_BUFFER_HPP
+#define DOMPASCH_MALLOB_SPSC_RING_BUFFER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "util/assert.hpp"
+
+// Bounded, lock-free ring buffer of variable-length integer records
+// for exactly one producer thread and one consumer at a time.
+// Each record is stored as its length followed by its payload.
+// If there is not enough space left for a record, it is rejected
+// and the caller is responsible for (explicitly) dropping it.
+class SPSCRingBuffer {
+
+private:
+    std::vector<int> _data;
+    size_t _mask;
+
+    // Read position (only written by the consumer)
+    alignas(64) std::atomic<size_t> _head {0};
+    // Write position (only written by the producer)
+    alignas(64) std::atomic<size_t> _tail {0};
+
+    std::vector<int> _record_out;
+
+public:
+    SPSCRingBuffer(size_t minCapacity) {
+        size_t capacity = 1;
+        while (capacity < minCapacity) capacity *= 2;
+        _data.resize(capacity);
+        _mask = capacity-1;
+    }
+
+    // Producer side: Appends a record consisting of the concatenation
+    // of the provided header and payload. Returns false iff the ring
+    // does not have enough space left.
+    bool tryPush(const int* header, size_t headerSize, const int* payload, size_t payloadSize) {
+        const size_t recordSize = 1 + headerSize + payloadSize;
+        const size_t tail = _tail.load(std::memory_order_relaxed);
+        const size_t head = _head.load(std::memory_order_acquire);
+        if (_data.size() - (tail - head) < recordSize) return false;
+        size_t pos = tail;
+        _data[pos++ & _mask] = headerSize + payloadSize;
+        for (size_t i = 0; i < headerSize; i++) _data[pos++ & _mask] = header[i];
+        for (size_t i = 0; i < payloadSize; i++) _data[pos++ & _mask] = payload[i];
+        _tail.store(pos, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: Calls f(const int* record, size_t size) for up to
+    // maxRecords records in FIFO order and removes them from the ring.
+    // Returns the number of consumed records.
+    template <typename F>
+    size_t consume(size_t maxRecords, F f) {
+        size_t head = _head.load(std::memory_order_relaxed);
+        const size_t tail = _tail.load(std::memory_order_acquire);
+        size_t nbConsumed = 0;
+        while (head != tail && nbConsumed < maxRecords) {
+            const size_t size = _data[head++ & _mask];
+            _record_out.resize(size);
+            for (size_t i = 0; i < size; i++) _record_out[i] = _data[head++ & _mask];
+            // Free the space before processing the record
+            _head.store(head, std::memory_order_release);
+            f(_record_out.data(), size);
+            nbConsumed++;
+        }
+        return nbConsumed;
+    }
+
+    bool empty() const {
+        return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+    }
+    size_t capacity() const {
+        return _data.size();
+    }
+};
+
+#endif
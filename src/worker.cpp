@@ -21,10 +21,12 @@
 #include "data/job_reader.hpp"
 #include "util/sys/terminator.hpp"
 #include "util/sys/thread_pool.hpp"
+#include "data/host_description_store.hpp"
+#include "data/chunked_description.hpp"
 
 Worker::Worker(MPI_Comm comm, Parameters& params) :
     _comm(comm), _world_rank(MyMpi::rank(MPI_COMM_WORLD)), 
-    _params(params), _job_db(_params, _comm, _sys_state), _sys_state(_comm, params.sysstatePeriod(), SysState<9>::ALLREDUCE), 
+    _params(params), _job_db(_params, _comm, _sys_state), _sys_state(_comm, params.sysstatePeriod(), WorkerSysState::ALLREDUCE), 
     _watchdog(/*enabled=*/_params.watchdog(), /*checkIntervMillis=*/100, Timer::elapsedSeconds())
 {
     _watchdog.setWarningPeriod(50); // warn after 50ms without a reset
@@ -54,12 +56,17 @@ void Worker::init() {
         createExpanderGraph();
     }
 
+    // Determine hosts and their boards of idle workers (collective operation)
+    if (_params.regionRouting()) {
+        _region_router.init(_comm);
+    }
+
     auto& q = MyMpi::getMessageQueue();
     
     // Write tag of currently handled message into watchdog
     q.setCurrentTagPointers(_watchdog.activityRecvTag(), _watchdog.activitySendTag());
 
-    q.registerSentCallback(MSG_SEND_JOB_DESCRIPTION, [&](int sendId) {
+    auto descriptionSentCb = [&](int sendId) {
         auto it = _send_id_to_job_id.find(sendId);
         if (it != _send_id_to_job_id.end()) {
             int jobId = it->second;
@@ -68,13 +75,17 @@ void Worker::init() {
             }
             _send_id_to_job_id.erase(sendId);
         }
-    });
+    };
+    q.registerSentCallback(MSG_SEND_JOB_DESCRIPTION, descriptionSentCb);
+    q.registerSentCallback(MSG_SEND_JOB_DESCRIPTION_CHUNK, descriptionSentCb);
 
     // Begin listening to incoming messages
     q.registerCallback(MSG_ANSWER_ADOPTION_OFFER,
         [&](auto& h) {handleAnswerAdoptionOffer(h);});
     q.registerCallback(MSG_NOTIFY_JOB_ABORTING, 
         [&](auto& h) {handleNotifyJobAborting(h);});
+    q.registerCallback(MSG_NOTIFY_JOB_DESCRIPTION_IN_HOST_STORE, 
+        [&](auto& h) {handleNotifyJobDescriptionInHostStore(h);});
     q.registerCallback(MSG_NOTIFY_JOB_TERMINATING, 
         [&](auto& h) {handleNotifyJobTerminating(h);});
     q.registerCallback(MSG_NOTIFY_RESULT_FOUND, 
@@ -111,12 +122,16 @@ void Worker::init() {
         [&](auto& h) {handleSendApplicationMessage(h);});
     q.registerCallback(MSG_SEND_JOB_DESCRIPTION, 
         [&](auto& h) {handleSendJobDescription(h);});
+    q.registerCallback(MSG_SEND_JOB_DESCRIPTION_CHUNK, 
+        [&](auto& h) {handleSendJobDescriptionChunk(h);});
     q.registerCallback(MSG_NOTIFY_ASSIGNMENT_UPDATE, 
         [&](auto& h) {_coll_assign.handle(h);});
     q.registerCallback(MSG_SCHED_RELEASE_FROM_WAITING, 
         [&](auto& h) {handleSchedReleaseFromWaiting(h);});
     q.registerCallback(MSG_SCHED_NODE_FREED, 
         [&](auto& h) {handleSchedNodeFreed(h);});
+    q.registerCallback(MSG_NOTIFY_IDLE_REGION_SUMMARY, 
+        [&](auto& h) {handleNotifyIdleRegionSummary(h);});
     q.registerCallback(MSG_WARMUP, [&](auto& h) {
         LOG_ADD_SRC(V4_VVER, "Received warmup msg", h.source);
     });
@@ -181,6 +196,7 @@ void Worker::createExpanderGraph() {
             _coll_assign = CollectiveAssignment(
                 _job_db, MyMpi::size(_comm), 
                 AdjustablePermutation::getBestOutgoingEdgeForEachNode(permutations, _world_rank),
+                _params.namedIdleRanks(),
                 // Callback for receiving a job request
                 [&](const JobRequest& req, int rank) {
                     MessageHandle handle;
@@ -243,6 +259,11 @@ void Worker::advance(float time) {
         }
     }
 
+    // Spread the number of idle workers on this host
+    if (_region_router.isInitialized() && _periodic_region_gossip.ready(time)) {
+        gossipIdleRegionSummary();
+    }
+
     // Check jobs
     if (_periodic_job_check.ready(time)) {
         _watchdog.setActivity(Watchdog::CHECK_JOBS);
@@ -250,6 +271,10 @@ void Worker::advance(float time) {
     }
 
     // Advance an all-reduction of the current system state
+    const auto& msgMetrics = MyMpi::getMessageQueue().getMetrics();
+    _sys_state.setLocal(SYSSTATE_NUMMESSAGES, msgMetrics.getNumMessages());
+    _sys_state.setLocal(SYSSTATE_MESSAGEBYTES, msgMetrics.getNumBytes());
+    _sys_state.setLocal(SYSSTATE_CALLBACKTIME, msgMetrics.getCallbackTime());
     if (_sys_state.aggregate(time)) {
         _watchdog.setActivity(Watchdog::SYSSTATE);
         publishAndResetSysState();
@@ -266,6 +291,9 @@ void Worker::checkStats(float time) {
         // Update local sysstate, log update
         _sys_state.setLocal(SYSSTATE_GLOBALMEM, _node_memory_gbs);
         LOG(V4_VVER, "mem=%.2fGB mt_cpu=%.3f mt_sys=%.3f\n", _node_memory_gbs, _mainthread_cpu_share, _mainthread_sys_share);
+        LOG(V4_VVER, "mq_recv %s\n", MyMpi::getMessageQueue().getReceiveStatsReport().c_str());
+        for (const auto& report : MyMpi::getMessageQueue().getSendDelayReports())
+            LOG(V4_VVER, "mq_send_delay %s\n", report.c_str());
 
         // Update host-internal communicator
         if (_host_comm) {
@@ -333,6 +361,15 @@ void Worker::checkJobs() {
         handleRequestNode(handle, JobDatabase::NORMAL);
     }
 
+    // Publish whether this process is idle to the other processes on this host
+    if (_region_router.isInitialized()) _region_router.setIdle(!_job_db.isBusyOrCommitted());
+
+    // Drop partially received job descriptions of jobs which are gone
+    for (auto it = _incoming_descriptions.begin(); it != _incoming_descriptions.end(); ) {
+        if (!_job_db.has(it->first.first)) it = _incoming_descriptions.erase(it);
+        else ++it;
+    }
+
     if (!_job_db.hasActiveJob()) {
         if (_job_db.isBusyOrCommitted()) {
             // PE is committed but not active
@@ -432,7 +469,20 @@ void Worker::publishAndResetSysState() {
                     result[SYSSTATE_BUSYRATIO]/MyMpi::size(_comm), result[SYSSTATE_COMMITTEDRATIO]/MyMpi::size(_comm), 
                     (int)result[SYSSTATE_NUMJOBS], result[SYSSTATE_GLOBALMEM], (int)result[SYSSTATE_SPAWNEDREQUESTS], 
                     (int)result[SYSSTATE_NUMHOPS]);
+        LOG(V3_VERB, "sysstate msgs=%i msgMBs=%.3f cbtime=%.3fs\n", (int)result[SYSSTATE_NUMMESSAGES], 
+                    result[SYSSTATE_MESSAGEBYTES]/1024/1024, result[SYSSTATE_CALLBACKTIME]);
     }
+
+    // Dump and reset the metrics of this process' message traffic
+    auto& msgMetrics = MyMpi::getMessageQueue().getMetrics();
+    if (_params.dumpMessageMetrics()) {
+        std::string rankStr = std::to_string(MyMpi::rank(MPI_COMM_WORLD));
+        std::string filename = _params.logDirectory().empty() ? "msgmetrics." + rankStr + ".jsonl" 
+            : _params.logDirectory() + "/" + rankStr + "/msgmetrics.jsonl";
+        std::ofstream ofs(filename, std::ios::app);
+        ofs << msgMetrics.toJsonLine() << "\n";
+    }
+    msgMetrics.reset();
     
     if (!_job_db.isBusyOrCommitted()) {
         LOG(V4_VVER, "I am idle\n");
@@ -502,11 +552,8 @@ void Worker::handleAnswerAdoptionOffer(MessageHandle& handle) {
         }
 
         job.setDesiredRevision(req.revision);
-        if (!job.hasDescription() || job.getRevision() < req.revision) {
-            // Transfer of at least one revision is required
-            int requestedRevision = job.hasDescription() ? job.getRevision()+1 : 0;
-            MyMpi::isend(handle.source, MSG_QUERY_JOB_DESCRIPTION, IntPair(jobId, requestedRevision));
-        }
+        bool transferRequired = !job.hasDescription() || job.getRevision() < req.revision;
+        int requestedRevision = job.hasDescription() ? job.getRevision()+1 : 0;
         if (job.hasDescription()) {
             // At least the initial description is present: Begin to execute job
             _job_db.uncommit(req.jobId);
@@ -516,6 +563,10 @@ void Worker::handleAnswerAdoptionOffer(MessageHandle& handle) {
                 _job_db.execute(req.jobId, handle.source);
             }
         }
+        if (transferRequired) {
+            // Transfer of at least one revision is required
+            queryJobDescription(jobId, requestedRevision, handle.source);
+        }
         
     } else {
         // Rejected
@@ -526,16 +577,39 @@ void Worker::handleAnswerAdoptionOffer(MessageHandle& handle) {
     }
 }
 
+void Worker::queryJobDescription(int jobId, int revision, int source) {
+    // Another process on this host may already hold this revision
+    auto view = HostDescriptionStore::fetch(jobId, revision);
+    if (view) {
+        LOG(V4_VVER, "Fetched desc. of #%i rev. %i from host store\n", jobId, revision);
+        digestJobDescription(jobId, view, source);
+        return;
+    }
+    MyMpi::isend(source, MSG_QUERY_JOB_DESCRIPTION, IntPair(jobId, revision));
+}
+
 void Worker::handleQueryJobDescription(MessageHandle& handle) {
-    IntPair pair = Serializable::get<IntPair>(handle.getRecvData());
-    int jobId = pair.first;
-    int revision = pair.second;
+    // [jobId, revision(, 1 if the host store must not be used)]
+    IntVec query = Serializable::get<IntVec>(handle.getRecvData());
+    int jobId = query[0];
+    int revision = query[1];
+    bool bypassHostStore = query.data.size() > 2 && query[2] == 1;
 
     if (!_job_db.has(jobId)) return;
     Job& job = _job_db.get(jobId);
 
-    if (job.getRevision() >= revision) {
-        sendRevisionDescription(jobId, revision, handle.source);
+    if (_incoming_descriptions.count({jobId, revision})) {
+        // This revision is being received in chunks right now (even if the job
+        // already started with its meta data): Send the chunks received so far
+        // and forward each further chunk upon its arrival
+        auto& transfer = _incoming_descriptions.at({jobId, revision});
+        for (const auto& chunk : transfer.getReceivedChunks()) 
+            sendDescriptionChunk(job, handle.source, chunk);
+        transfer.addForwardDestination(handle.source);
+        LOG_ADD_DEST(V4_VVER, "Forwarding desc. of %s rev. %i, %i/%i chunks present", handle.source, 
+            job.toStr(), revision, transfer.getNumReceivedChunks(), transfer.getNumChunks());
+    } else if (job.getRevision() >= revision) {
+        sendRevisionDescription(jobId, revision, handle.source, bypassHostStore);
     } else {
         // This revision is not present yet: Defer this query
         // and send the job description upon receiving it
@@ -544,12 +618,30 @@ void Worker::handleQueryJobDescription(MessageHandle& handle) {
     }
 }
 
-void Worker::sendRevisionDescription(int jobId, int revision, int dest) {
+void Worker::sendRevisionDescription(int jobId, int revision, int dest, bool bypassHostStore) {
     // Retrieve and send concerned job description
     auto& job = _job_db.get(jobId);
+    if (!bypassHostStore && HostDescriptionStore::holds(jobId, revision) && HostComm::isOnThisHost(dest)) {
+        // The receiver can fetch the description from the host store directly
+        MyMpi::isend(dest, MSG_NOTIFY_JOB_DESCRIPTION_IN_HOST_STORE, IntVec({jobId, revision}));
+        LOG_ADD_DEST(V4_VVER, "Referred to host store for desc. of %s rev. %i", dest, job.toStr(), revision);
+        return;
+    }
     const auto& descPtr = job.getSerializedDescription(revision);
     assert(descPtr->size() == job.getDescription().getTransferSize(revision) 
         || LOG_RETURN_FALSE("%i != %i\n", descPtr->size(), job.getDescription().getTransferSize(revision)));
+    size_t chunkSize = _params.descriptionChunkSize();
+    if (chunkSize > 0 && descPtr->size() > chunkSize) {
+        // Send the revision in chunks which the receiver can forward right away
+        int numChunks = ChunkedDescription::getNumChunks(descPtr->size(), chunkSize);
+        for (int i = 0; i < numChunks; i++) {
+            sendDescriptionChunk(job, dest, 
+                ChunkedDescription::createChunk(jobId, revision, *descPtr, chunkSize, i));
+        }
+        LOG_ADD_DEST(V4_VVER, "Sent job desc. of %s rev. %i, size %lu, in %i chunks", dest, 
+            job.toStr(), revision, descPtr->size(), numChunks);
+        return;
+    }
     int sendId = MyMpi::isend(dest, MSG_SEND_JOB_DESCRIPTION, descPtr);
     LOG_ADD_DEST(V4_VVER, "Sent job desc. of %s rev. %i, size %lu, id=%i", dest, 
             job.toStr(), revision, descPtr->size(), sendId);
@@ -557,6 +649,12 @@ void Worker::sendRevisionDescription(int jobId, int revision, int dest) {
     _send_id_to_job_id[sendId] = jobId;
 }
 
+void Worker::sendDescriptionChunk(Job& job, int dest, const std::shared_ptr<std::vector<uint8_t>>& chunk) {
+    int sendId = MyMpi::isend(dest, MSG_SEND_JOB_DESCRIPTION_CHUNK, chunk);
+    job.getJobTree().addSendHandle(dest, sendId);
+    _send_id_to_job_id[sendId] = job.getId();
+}
+
 void Worker::handleRejectOneshot(MessageHandle& handle) {
     OneshotJobRequestRejection rej = Serializable::get<OneshotJobRequestRejection>(handle.getRecvData());
     JobRequest& req = rej.request;
@@ -680,6 +778,7 @@ void Worker::tryAdoptRequest(JobRequest& req, int source, JobDatabase::JobReques
             Job& job = _job_db.createJob(MyMpi::size(_comm), _world_rank, req.jobId, req.application);
         }
         _job_db.commit(req);
+        if (_region_router.isInitialized()) _region_router.setIdle(false);
         if (_params.reactivationScheduling()) {
             _job_db.initScheduler(req, [this](const JobRequest& req, int tag, bool left, int dest) {
                 sendJobRequest(req, tag, left, dest);
@@ -840,9 +939,8 @@ void Worker::handleQueryVolume(MessageHandle& handle) {
     }
 
     // Send response
-    IntVec response({jobId, volume, _job_db.getGlobalBalancingEpoch()});
     LOG_ADD_DEST(V4_VVER, "Answer #%i volume query with v=%i", handle.source, jobId, volume);
-    MyMpi::isend(handle.source, MSG_NOTIFY_VOLUME_UPDATE, response);
+    enqueueVolumeUpdate(handle.source, jobId, volume, _job_db.getGlobalBalancingEpoch());
 }
 
 void Worker::handleNotifyResultObsolete(MessageHandle& handle) {
@@ -857,40 +955,138 @@ void Worker::handleSendJobDescription(MessageHandle& handle) {
     const auto& data = handle.getRecvData();
     int jobId = data.size() >= sizeof(int) ? Serializable::get<int>(data) : -1;
     LOG_ADD_SRC(V4_VVER, "Got desc. of size %i for job #%i", handle.source, data.size(), jobId);
+    auto dataPtr = std::shared_ptr<std::vector<uint8_t>>(
+        new std::vector<uint8_t>(handle.moveRecvData())
+    );
+    digestJobDescription(jobId, std::move(dataPtr), handle.source);
+}
+
+void Worker::handleSendJobDescriptionChunk(MessageHandle& handle) {
+    const auto& msg = handle.getRecvData();
+    if (!ChunkedDescription::isChunk(msg)) {
+        LOG_ADD_SRC(V1_WARN, "[WARN] Invalid desc. chunk of size %lu", handle.source, msg.size());
+        return;
+    }
+    auto header = ChunkedDescription::readHeader(msg);
+    int jobId = header.jobId;
+    auto key = std::pair<int, int>(jobId, header.revision);
+    if (!_job_db.has(jobId)) {
+        _incoming_descriptions.erase(key);
+        return;
+    }
+    auto& job = _job_db.get(jobId);
+
+    auto it = _incoming_descriptions.find(key);
+    if (it == _incoming_descriptions.end()) {
+        // Revision is present already (chunk of an obsolete transfer)?
+        if (job.getMaxConsecutiveRevision() >= header.revision) return;
+        it = _incoming_descriptions.try_emplace(key, header).first;
+    }
+    auto& transfer = it->second;
+    if (!transfer.insert(msg)) return; // duplicate chunk
+
+    // Forward the chunk to all processes waiting for this revision
+    if (!transfer.getForwardDestinations().empty()) {
+        auto chunk = std::make_shared<std::vector<uint8_t>>(handle.moveRecvData());
+        for (int dest : transfer.getForwardDestinations()) sendDescriptionChunk(job, dest, chunk);
+    }
+    if (!transfer.isComplete()) {
+        // Start a committed job as soon as the meta data of its first revision arrived
+        // if it supports this: it sets up its solvers while the payload is being received
+        if (header.revision == 0 && transfer.hasChunk(0) && !job.hasDescription() 
+                && _job_db.hasCommitment(jobId) && job.appl_canStartWithIncompleteDescription()
+                && JobDescription::isMetadataContained(*transfer.getData(), transfer.getChunkSize())
+                && _job_db.appendIncompleteRevision(jobId, transfer.getData(), handle.source)) {
+            LOG_ADD_SRC(V4_VVER, "Starting %s with %i/%i chunks of its desc.", handle.source, 
+                job.toStr(), transfer.getNumReceivedChunks(), transfer.getNumChunks());
+            executeCommittedJob(jobId, handle.source);
+        }
+        return;
+    }
+
+    LOG_ADD_SRC(V4_VVER, "Got desc. of size %lu for job #%i in %i chunks", handle.source, 
+        transfer.getTotalSize(), jobId, transfer.getNumChunks());
+    auto dataPtr = transfer.extract();
+    _incoming_descriptions.erase(it);
+    if (!job.hasIncompleteDescription()) {
+        digestJobDescription(jobId, std::move(dataPtr), handle.source);
+        return;
+    }
+
+    // The job has been started with this revision's meta data already
+    _job_db.completeRevision(jobId, dataPtr);
+    releaseDescription(std::move(dataPtr));
+    proceedWithRevision(jobId, handle.source);
+}
+
+void Worker::handleNotifyJobDescriptionInHostStore(MessageHandle& handle) {
+    IntVec ref = Serializable::get<IntVec>(handle.getRecvData());
+    int jobId = ref[0];
+    int revision = ref[1];
+    auto view = HostDescriptionStore::fetch(jobId, revision);
+    if (!view) {
+        // Not available (any more): query the description itself
+        LOG_ADD_SRC(V1_WARN, "[WARN] #%i rev. %i not found in host store", handle.source, jobId, revision);
+        MyMpi::isend(handle.source, MSG_QUERY_JOB_DESCRIPTION, IntVec({jobId, revision, 1}));
+        return;
+    }
+    LOG_ADD_SRC(V4_VVER, "Got desc. of size %i for job #%i from host store", handle.source, view.size, jobId);
+    digestJobDescription(jobId, view, handle.source);
+}
+
+void Worker::digestJobDescription(int jobId, std::shared_ptr<std::vector<uint8_t>>&& dataPtr, int source) {
+    if (!checkDescribedJob(jobId)) return;
+
+    // Append revision description to job
+    bool valid = _job_db.appendRevision(jobId, dataPtr, source);
+    // Discarded, or the job only keeps the revision's copy in the host store?
+    releaseDescription(std::move(dataPtr));
+    if (valid) proceedWithRevision(jobId, source);
+}
+
+void Worker::digestJobDescription(int jobId, const JobDescription::SerializationView& view, int source) {
+    if (!checkDescribedJob(jobId)) return;
+
+    // Append revision description to job
+    if (_job_db.appendRevision(jobId, view, source)) proceedWithRevision(jobId, source);
+}
+
+void Worker::executeCommittedJob(int jobId, int source) {
+    {
+        const auto& req = _job_db.getCommitment(jobId);
+        _job_db.get(jobId).setDesiredRevision(req.revision);
+        _job_db.uncommit(jobId);
+    }
+    _job_db.execute(jobId, source);
+    initiateVolumeUpdate(jobId);
+}
+
+bool Worker::checkDescribedJob(int jobId) {
     if (jobId == -1 || !_job_db.has(jobId)) {
         if (_job_db.hasCommitment(jobId)) {
             _job_db.uncommit(jobId);
             _job_db.unregisterJobFromBalancer(jobId);
             if (_job_db.has(jobId)) _job_db.suspendScheduler(_job_db.get(jobId));
         }
-        return;
+        return false;
     }
+    return true;
+}
 
-    // Append revision description to job
+void Worker::releaseDescription(std::shared_ptr<std::vector<uint8_t>>&& dataPtr) {
+    if (dataPtr.use_count() != 1) return;
+    // Need to clean up shared pointer concurrently 
+    // because it might take too much time in the main thread
+    ProcessWideThreadPool::get().addTask([sharedPtr = std::move(dataPtr)]() mutable {
+        sharedPtr.reset();
+    });
+}
+
+void Worker::proceedWithRevision(int jobId, int source) {
     auto& job = _job_db.get(jobId);
-    auto dataPtr = std::shared_ptr<std::vector<uint8_t>>(
-        new std::vector<uint8_t>(handle.moveRecvData())
-    );
-    bool valid = _job_db.appendRevision(jobId, dataPtr, handle.source);
-    if (!valid) {
-        // Need to clean up shared pointer concurrently 
-        // because it might take too much time in the main thread
-        ProcessWideThreadPool::get().addTask([sharedPtr = std::move(dataPtr)]() mutable {
-            sharedPtr.reset();
-        });
-        return;
-    }
 
     // If job has not started yet, execute it now
-    if (_job_db.hasCommitment(jobId)) {
-        {
-            const auto& req = _job_db.getCommitment(jobId);
-            job.setDesiredRevision(req.revision);
-            _job_db.uncommit(jobId);
-        }
-        _job_db.execute(jobId, handle.source);
-        initiateVolumeUpdate(jobId);
-    }
+    if (_job_db.hasCommitment(jobId)) executeCommittedJob(jobId, source);
     
     // Job inactive?
     if (job.getState() != ACTIVE) return;
@@ -898,7 +1094,7 @@ void Worker::handleSendJobDescription(MessageHandle& handle) {
     // Arrived at final revision?
     if (_job_db.get(jobId).getRevision() < _job_db.get(jobId).getDesiredRevision()) {
         // No: Query next revision
-        MyMpi::isend(handle.source, MSG_QUERY_JOB_DESCRIPTION, IntPair(jobId, _job_db.get(jobId).getRevision()+1));
+        queryJobDescription(jobId, _job_db.get(jobId).getRevision()+1, source);
     }
 }
 
@@ -907,17 +1103,19 @@ void Worker::handleNotifyJobTerminating(MessageHandle& handle) {
 }
 
 void Worker::handleNotifyVolumeUpdate(MessageHandle& handle) {
+    // Sequence of (job ID, volume, balancing epoch) triples
     IntVec recv = Serializable::get<IntVec>(handle.getRecvData());
-    int jobId = recv[0];
-    int volume = recv[1];
-    int balancingEpoch = recv[2];
-    if (!_job_db.has(jobId)) {
-        LOG(V1_WARN, "[WARN] Volume update for unknown #%i\n", jobId);
-        return;
+    for (size_t i = 0; i+2 < recv.data.size(); i += 3) {
+        int jobId = recv[i];
+        int volume = recv[i+1];
+        int balancingEpoch = recv[i+2];
+        if (!_job_db.has(jobId)) {
+            LOG(V1_WARN, "[WARN] Volume update for unknown #%i\n", jobId);
+            continue;
+        }
+        // Update volume assignment in job instance (and its children)
+        updateVolume(jobId, volume, balancingEpoch, 0);
     }
-
-    // Update volume assignment in job instance (and its children)
-    updateVolume(jobId, volume, balancingEpoch, 0);
 }
 
 void Worker::handleNotifyNodeLeavingJob(MessageHandle& handle) {
@@ -1033,8 +1231,13 @@ void Worker::bounceJobRequest(JobRequest& request, int senderRank) {
         return;
     }
 
-    int nextRank;
-    if (_params.derandomize()) {
+    // Steer the request towards a host which likely has idle workers, if possible
+    int nextRank = _region_router.isInitialized() ? 
+        _region_router.route(request.requestingNodeRank, senderRank) : -1;
+    if (nextRank >= 0) {
+        LOG_ADD_DEST(V5_DEBG, "Route %s to region %i", nextRank, 
+            _job_db.toStr(request.jobId, request.requestedNodeIndex).c_str(), _region_router.getRegion(nextRank));
+    } else if (_params.derandomize()) {
         // Get random choice from bounce alternatives
         nextRank = getWeightedRandomNeighbor();
         if (_hop_destinations.size() > 2) {
@@ -1064,6 +1267,22 @@ void Worker::bounceJobRequest(JobRequest& request, int senderRank) {
     MyMpi::isend(nextRank, MSG_REQUEST_NODE, request);
 }
 
+void Worker::gossipIdleRegionSummary() {
+    _region_router.updateLocalRegion();
+    int numWorkers = MyMpi::size(_comm);
+    if (numWorkers == 1) return;
+    int dest = _hop_destinations.empty() ? 
+        (_world_rank + 1 + (int) (Random::rand() * (numWorkers-1))) % numWorkers
+        : getWeightedRandomNeighbor();
+    IntVec summary(_region_router.getSummary());
+    MyMpi::isend(dest, MSG_NOTIFY_IDLE_REGION_SUMMARY, summary);
+}
+
+void Worker::handleNotifyIdleRegionSummary(MessageHandle& handle) {
+    if (!_region_router.isInitialized()) return;
+    _region_router.mergeSummary(Serializable::get<IntVec>(handle.getRecvData()).data);
+}
+
 void Worker::initiateVolumeUpdate(int jobId) {
 
     auto& job = _job_db.get(jobId);
@@ -1189,7 +1408,6 @@ void Worker::propagateVolumeUpdate(Job& job, int volume, int balancingEpoch) {
     int jobId = job.getId();
     int thisIndex = job.getIndex();
     auto& tree = job.getJobTree();
-    IntVec payload{jobId, volume, balancingEpoch};
 
     // For each potential child (left, right):
     bool has[2] = {tree.hasLeftChild(), tree.hasRightChild()};
@@ -1200,8 +1418,8 @@ void Worker::propagateVolumeUpdate(Job& job, int volume, int balancingEpoch) {
         if (has[i]) {
             ranks[i] = i == 0 ? tree.getLeftChildNodeRank() : tree.getRightChildNodeRank();
             if (_params.explicitVolumeUpdates()) {
-                // Propagate volume update
-                MyMpi::isend(ranks[i], MSG_NOTIFY_VOLUME_UPDATE, payload);
+                // Propagate volume update (at the end of this cycle)
+                enqueueVolumeUpdate(ranks[i], jobId, volume, balancingEpoch);
             }
             if (_params.reactivationScheduling() && nextIndex >= volume) {
                 // Child leaves
@@ -1236,6 +1454,31 @@ void Worker::propagateVolumeUpdate(Job& job, int volume, int balancingEpoch) {
     }
 }
 
+void Worker::enqueueVolumeUpdate(int dest, int jobId, int volume, int balancingEpoch) {
+    auto& updates = _pending_volume_updates[dest];
+    auto it = updates.find(jobId);
+    // An update from an older balancing epoch is superseded
+    if (it != updates.end() && it->second.second > balancingEpoch) return;
+    updates[jobId] = {volume, balancingEpoch};
+}
+
+void Worker::flushVolumeUpdates() {
+    if (_pending_volume_updates.empty()) return;
+    // One message per destination with all updates for this destination
+    for (auto& [dest, updates] : _pending_volume_updates) {
+        IntVec payload;
+        payload.data.reserve(3*updates.size());
+        for (auto& [jobId, update] : updates) {
+            payload.data.push_back(jobId);
+            payload.data.push_back(update.first);
+            payload.data.push_back(update.second);
+        }
+        LOG_ADD_DEST(V5_DEBG, "Send %i volume updates", dest, updates.size());
+        MyMpi::isend(dest, MSG_NOTIFY_VOLUME_UPDATE, payload);
+    }
+    _pending_volume_updates.clear();
+}
+
 void Worker::spawnJobRequest(int jobId, bool left, int balancingEpoch) {
 
     Job& job = _job_db.get(jobId);
@@ -1369,11 +1612,13 @@ Worker::~Worker() {
 
     _watchdog.stop();
     Terminator::setTerminating();
+    HostDescriptionStore::releaseAll();
 
     LOG(V4_VVER, "Destruct worker\n");
 
     if (_params.monoFilename.isSet() && _params.applicationSpawnMode() != "fork") {
         // Terminate directly without destructing resident job
+        MyMpi::getMessageQueue().stopProgressThread();
         MPI_Finalize();
         Process::doExit(0);
     }
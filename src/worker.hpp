@@ -18,9 +18,11 @@
 #include "comm/distributed_bfs.hpp"
 #include "util/sys/background_worker.hpp"
 #include "balancing/collective_assignment.hpp"
+#include "balancing/region_router.hpp"
 #include "util/periodic_event.hpp"
 #include "util/sys/watchdog.hpp"
 #include "comm/host_comm.hpp"
+#include "data/chunked_description.hpp"
 
 /*
 Primary actor in the system who is responsible for participating in the scheduling and execution of jobs.
@@ -38,6 +40,7 @@ private:
 
     std::vector<int> _hop_destinations;
     CollectiveAssignment _coll_assign;
+    RegionRouter _region_router;
 
     long long _iteration = 0;
     PeriodicEvent<1000> _periodic_stats_check;
@@ -45,6 +48,7 @@ private:
     PeriodicEvent<10> _periodic_job_check;
     PeriodicEvent<1> _periodic_balance_check;
     PeriodicEvent<1000> _periodic_maintenance;
+    PeriodicEvent<50> _periodic_region_gossip;
     Watchdog _watchdog;
 
     std::atomic_bool _node_stats_calculated = true;
@@ -58,6 +62,13 @@ private:
 
     robin_hood::unordered_map<int, int> _send_id_to_job_id;
 
+    // Job description revisions currently being received in chunks
+    robin_hood::unordered_node_map<std::pair<int, int>, ChunkedDescription, IntPairHasher> _incoming_descriptions;
+
+    // Explicit volume updates to send at the end of this main loop cycle, coalesced
+    // per destination rank: dest -> job ID -> (volume, balancing epoch)
+    robin_hood::unordered_map<int, robin_hood::unordered_map<int, std::pair<int, int>>> _pending_volume_updates;
+
     HostComm* _host_comm;
 
 public:
@@ -65,6 +76,9 @@ public:
     ~Worker();
     void init();
     void advance(float time = -1);
+    // Sends all volume updates which accumulated in this main loop cycle.
+    // To be called after the message queue has executed this cycle's callbacks.
+    void flushVolumeUpdates();
     void setHostComm(HostComm& hostComm) {_host_comm = &hostComm;}
 
 private:
@@ -73,6 +87,8 @@ private:
     void handleAnswerAdoptionOffer(MessageHandle& handle);
     void handleQueryJobDescription(MessageHandle& handle);
     void handleSendJobDescription(MessageHandle& handle);
+    void handleSendJobDescriptionChunk(MessageHandle& handle);
+    void handleNotifyJobDescriptionInHostStore(MessageHandle& handle);
 
     void handleNotifyJobAborting(MessageHandle& handle);
     void handleDoExit(MessageHandle& handle);
@@ -93,9 +109,19 @@ private:
     void handleRequestWork(MessageHandle& handle);
     void handleSchedReleaseFromWaiting(MessageHandle& handle);
     void handleSchedNodeFreed(MessageHandle& handle);
-
-    void sendRevisionDescription(int jobId, int revision, int dest);
+    void handleNotifyIdleRegionSummary(MessageHandle& handle);
+
+    void queryJobDescription(int jobId, int revision, int source);
+    void digestJobDescription(int jobId, std::shared_ptr<std::vector<uint8_t>>&& dataPtr, int source);
+    void digestJobDescription(int jobId, const JobDescription::SerializationView& view, int source);
+    bool checkDescribedJob(int jobId);
+    void proceedWithRevision(int jobId, int source);
+    void executeCommittedJob(int jobId, int source);
+    void releaseDescription(std::shared_ptr<std::vector<uint8_t>>&& dataPtr);
+    void sendRevisionDescription(int jobId, int revision, int dest, bool bypassHostStore = false);
+    void sendDescriptionChunk(Job& job, int dest, const std::shared_ptr<std::vector<uint8_t>>& chunk);
     void bounceJobRequest(JobRequest& request, int senderRank);
+    void gossipIdleRegionSummary();
 
     void checkStats(float time);
     void checkJobs();
@@ -110,6 +136,7 @@ private:
     void sendJobRequest(const JobRequest& req, int tag, bool left, int dest);
     void activateRootRequest(int jobId);
     void propagateVolumeUpdate(Job& job, int volume, int balancingEpoch);
+    void enqueueVolumeUpdate(int dest, int jobId, int volume, int balancingEpoch);
 
     void interruptJob(int jobId, bool terminate, bool reckless);
     void sendJobDoneWithStatsToClient(int jobId, int revision, int successfulRank);